@@ -1,186 +1,1272 @@
 #include "cube.h"
 #include "table_manager.h"
 #include "solver.h"
+#include "racing_solver.h"
+#include "lockstep_solver.h"
+#include "interleaved_solver.h"
+#include "pipelined_solver.h"
+#include "bench_common.h"
+#include "json_util.h"
+#include "random_state.h"
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <string>
 #include <chrono>
 #include <algorithm>
 #include <iomanip>
+#include <optional>
+#include <thread>
 
+using RubiksSolver::Bench::Clock;
+using RubiksSolver::Bench::LatencyStats;
+using RubiksSolver::Bench::elapsed_ns;
+using RubiksSolver::Bench::ns_to_ms;
+
+struct BenchmarkOptions {
+    std::string scramble_file = "sc.txt";
+    int warmup = 20;          // 预热求解次数 (不计时)
+    int repeat = 1;           // 计时轮数
+    std::string json_path;    // 完整结果 (JSON)
+    std::string csv_path;     // 每次求解一行 (CSV)
+    std::string csv_aggregate_path; // 汇总指标 (CSV)
+    std::string baseline_path;      // 对比的基线 JSON
+    double threshold_percent = 5.0; // 超过基线多少百分比视为退化
+    int regression_exit_code = 2;
+    bool verbose = false;
+    size_t random_states = 0;       // >0 时使用随机状态代替打乱文件
+    uint64_t seed = 1;
+    bool throughput = false;        // 多线程吞吐量模式
+    std::vector<int> thread_counts; // 为空时使用 1, 2, 4 ... 硬件线程数
+    bool node_counts = false;       // 确定性的搜索工作量模式
+    std::string golden_path;        // 对比的节点数基准文件
+    std::string write_golden_path;  // 写出新的节点数基准文件
+    bool race = false;              // 使用多方向竞速求解
+    uint64_t race_budget_us = 0;
+    bool pipeline = false;          // 使用流水线两阶段求解 (寻找更短的解)
+    RubiksSolver::PipelinedSolver::Options pipeline_options;
+    RubiksSolver::SolveOptions solve_options; // 搜索策略
+    bool lockstep = false;          // 比较同步批量求解与逐个求解
+    std::vector<unsigned> interleave_widths; // 非空时比较协程交替求解 (各个宽度) 与逐个求解
+    bool tune = false;              // 扫描深度上限和阈值，写出调优配置
+    std::vector<std::pair<std::string, std::vector<int>>> tune_grid; // 覆盖默认的扫描取值
+    std::string tune_output = "tuning.conf";
+    double tune_length_slack = 0.0; // 允许平均解长度比当前配置增加的步数
+};
+
+// 单个打乱的结果，每轮计时一个样本
 struct BenchmarkResult {
-    double solve_time_ms;
-    int solution_length;
     std::string scramble;
-    bool success;
+    bool success = false;
+    int solution_length = 0;
+    std::string error;
+    std::vector<uint64_t> solve_ns;
+};
+
+// 启动阶段的耗时
+struct StartupTimes {
+    uint64_t table_init_ns = 0;    // get_instance() 返回 (第一阶段表可用)
+    uint64_t tables_ready_ns = 0;  // 所有表 (含终局数据库) 就绪
+    uint64_t cold_solve_ns = 0;    // 表就绪后的第一次求解
+};
+
+struct Aggregate {
+    size_t scrambles = 0;
+    size_t successes = 0;
+    double success_rate = 0.0;
+    LatencyStats latency;
+    double length_mean = 0.0;
+    double length_p50 = 0.0;
+    double length_p99 = 0.0;
+    double length_max = 0.0;
 };
 
-double get_percentile(std::vector<double>& data, double percentile) {
-    if (data.empty()) return 0.0;
-    
-    std::sort(data.begin(), data.end());
-    size_t index = static_cast<size_t>((percentile / 100.0) * (data.size() - 1));
-    
-    if (index >= data.size()) {
-        return data.back();
+static void print_usage() {
+    std::cout << "Usage: benchmark [options]\n"
+              << "  --scrambles <file>          scramble or facelet file, one per line (default: sc.txt)\n"
+              << "  --warmup <n>                untimed warmup solves (default: 20)\n"
+              << "  --repeat <n>                timed passes over all scrambles (default: 1)\n"
+              << "  --json <file>               write per-scramble and aggregate results as JSON\n"
+              << "  --csv <file>                write one CSV row per timed solve\n"
+              << "  --csv-aggregate <file>      write aggregate metrics as CSV\n"
+              << "  --baseline <file>           compare against a JSON file written by --json\n"
+              << "  --threshold <percent>       allowed regression against the baseline (default: 5)\n"
+              << "  --regression-exit-code <n>  exit code when a regression is detected (default: 2)\n"
+              << "  --verbose                   print every scramble and the solver output\n"
+              << "  --random <n>                solve n seeded uniformly random states instead of the scramble file\n"
+              << "  --seed <s>                  seed for --random (default: 1)\n"
+              << "  --throughput                measure throughput and scaling at several thread counts\n"
+              << "  --threads <list>            comma-separated thread counts (default: 1,2,4,...,hardware threads)\n"
+              << "  --race                      race 3 axes x inverse (6 searches) per solve, first solution wins\n"
+              << "  --race-budget-us <n>        with --race: wait up to n us for more variants, keep the shortest\n"
+              << "  --pipeline                  solve with the pipelined two-phase solver (phase-1 producers, phase-2 consumers)\n"
+              << "  --pipeline-threads <p1,p2>  with --pipeline: phase-1 and phase-2 threads (default 1,0 = remaining hardware threads)\n"
+              << "  --pipeline-serial           with --pipeline: run both phases in the calling thread instead\n"
+              << "  --pipeline-budget-us <n>    with --pipeline: time budget per solve (default 50000)\n"
+              << "  --pipeline-target <n>       with --pipeline: stop at the first solution of at most n moves (default 20)\n"
+              << "  --policy <p>                search policy: fast (default), short, or flags pathmax,clamp,natural,frontier\n"
+              << "  --lockstep                  solve all states with the lockstep (SIMD lane) solver and compare with Solver\n"
+              << "  --interleave <list>         solve all states with the coroutine-interleaved solver at each width (e.g. 1,4,8,16)\n"
+              << "                              and compare nodes/s with Solver\n"
+              << "  --tune                      sweep search limits, print the Pareto front of time vs length, write the pick\n"
+              << "  --tune-grid <key=v1,v2,..>  values to sweep for one limit (repeatable; keys as in tuning.conf)\n"
+              << "  --tune-output <file>        where --tune writes the chosen limits (default: tuning.conf)\n"
+              << "  --tune-length-slack <moves> accept this much longer mean solutions than the current limits (default: 0)\n"
+              << "  --node-counts               record nodes, IDA* iterations and endgame probes per scramble (no timing)\n"
+              << "  --golden <file>             with --node-counts: fail if any count increased against this file\n"
+              << "  --write-golden <file>       with --node-counts: write the counts as a new golden file\n";
+}
+
+static BenchmarkOptions parse_options(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--scrambles") options.scramble_file = next();
+        else if (arg == "--warmup") options.warmup = std::stoi(next());
+        else if (arg == "--repeat") options.repeat = std::max(1, std::stoi(next()));
+        else if (arg == "--json") options.json_path = next();
+        else if (arg == "--csv") options.csv_path = next();
+        else if (arg == "--csv-aggregate") options.csv_aggregate_path = next();
+        else if (arg == "--baseline") options.baseline_path = next();
+        else if (arg == "--threshold") options.threshold_percent = std::stod(next());
+        else if (arg == "--regression-exit-code") options.regression_exit_code = std::stoi(next());
+        else if (arg == "--verbose") options.verbose = true;
+        else if (arg == "--random") options.random_states = std::stoull(next());
+        else if (arg == "--seed") options.seed = std::stoull(next());
+        else if (arg == "--throughput") options.throughput = true;
+        else if (arg == "--node-counts") options.node_counts = true;
+        else if (arg == "--race") options.race = true;
+        else if (arg == "--race-budget-us") options.race_budget_us = std::stoull(next());
+        else if (arg == "--pipeline") options.pipeline = true;
+        else if (arg == "--pipeline-threads") {
+            std::string value = next();
+            size_t comma = value.find(',');
+            options.pipeline_options.phase1_threads = std::stoul(value.substr(0, comma));
+            if (comma != std::string::npos) options.pipeline_options.phase2_threads = std::stoul(value.substr(comma + 1));
+        }
+        else if (arg == "--pipeline-serial") options.pipeline_options.serial = true;
+        else if (arg == "--pipeline-budget-us") options.pipeline_options.budget_us = std::stoull(next());
+        else if (arg == "--pipeline-target") options.pipeline_options.target_length = std::stoi(next());
+        else if (arg == "--policy") options.solve_options = RubiksSolver::SolveOptions::parse(next());
+        else if (arg == "--lockstep") options.lockstep = true;
+        else if (arg == "--interleave") {
+            std::stringstream list(next());
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                if (!item.empty()) options.interleave_widths.push_back(std::max(1, std::stoi(item)));
+            }
+            if (options.interleave_widths.empty()) throw std::invalid_argument("No widths for --interleave");
+        }
+        else if (arg == "--tune") options.tune = true;
+        else if (arg == "--tune-output") options.tune_output = next();
+        else if (arg == "--tune-length-slack") options.tune_length_slack = std::stod(next());
+        else if (arg == "--tune-grid") {
+            std::string spec = next();
+            size_t eq = spec.find('=');
+            if (eq == std::string::npos) throw std::invalid_argument("Expected key=v1,v2,... for --tune-grid: " + spec);
+            std::pair<std::string, std::vector<int>> axis{spec.substr(0, eq), {}};
+            std::stringstream list(spec.substr(eq + 1));
+            std::string item;
+            RubiksSolver::SearchLimits check;
+            while (std::getline(list, item, ',')) {
+                if (item.empty()) continue;
+                axis.second.push_back(std::stoi(item));
+                check.set(axis.first, axis.second.back()); // 校验键名和取值范围
+            }
+            if (axis.second.empty()) throw std::invalid_argument("No values for --tune-grid " + axis.first);
+            options.tune_grid.push_back(std::move(axis));
+        }
+        else if (arg == "--golden") options.golden_path = next();
+        else if (arg == "--write-golden") options.write_golden_path = next();
+        else if (arg == "--threads") {
+            std::stringstream list(next());
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                if (!item.empty()) options.thread_counts.push_back(std::max(1, std::stoi(item)));
+            }
+        }
+        else if (arg == "--help" || arg == "-h") { print_usage(); std::exit(0); }
+        else throw std::invalid_argument("Unknown option: " + arg);
     }
-    
-    return data[index];
+    return options;
 }
 
-void print_statistics(const std::vector<BenchmarkResult>& results) {
-    if (results.empty()) {
-        std::cout << "No results to analyze." << std::endl;
-        return;
+// 每行一个打乱序列或54个字符的色块字符串；'#' 之后的内容为注释
+static std::vector<std::string> load_scrambles(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open " + path);
     }
-    
-    std::vector<BenchmarkResult> successful_results;
-    for (const auto& result : results) {
-        if (result.success) {
-            successful_results.push_back(result);
+    std::vector<std::string> scrambles;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        line = line.substr(0, line.find('#'));
+        while (!line.empty() && (line.back() == ' ' || line.back() == '\t')) line.pop_back();
+        if (!line.empty()) {
+            scrambles.push_back(line);
+        }
+    }
+    return scrambles;
+}
+
+// 计时只包含 solver.solve() 本身；解的正确性在计时区间外校验
+template<typename S>
+static bool timed_solve(S& solver, const RubiksSolver::Cube& cube,
+                        uint64_t& ns, int& length, std::string& error) {
+    try {
+        auto start = Clock::now();
+        std::vector<RubiksSolver::Move> solution = solver.solve(cube);
+        auto end = Clock::now();
+        ns = elapsed_ns(start, end);
+
+        RubiksSolver::Cube check = cube;
+        check.apply_sequence(solution);
+        if (!check.is_solved()) {
+            error = "solution does not solve the cube";
+            return false;
         }
+        length = static_cast<int>(solution.size());
+        return true;
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
     }
-    
-    if (successful_results.empty()) {
-        std::cout << "No successful solves." << std::endl;
-        return;
+}
+
+static Aggregate aggregate_results(const std::vector<BenchmarkResult>& results) {
+    Aggregate agg;
+    agg.scrambles = results.size();
+    std::vector<uint64_t> samples;
+    std::vector<double> lengths;
+    for (const auto& result : results) {
+        if (!result.success) continue;
+        ++agg.successes;
+        samples.insert(samples.end(), result.solve_ns.begin(), result.solve_ns.end());
+        lengths.push_back(result.solution_length);
     }
-    
-    std::vector<double> solve_times;
-    std::vector<double> solution_lengths;
-    
-    for (const auto& result : successful_results) {
-        solve_times.push_back(result.solve_time_ms);
-        solution_lengths.push_back(static_cast<double>(result.solution_length));
+    agg.success_rate = results.empty() ? 0.0 : 100.0 * agg.successes / results.size();
+    agg.latency = RubiksSolver::Bench::compute_latency_stats(std::move(samples));
+    if (!lengths.empty()) {
+        std::sort(lengths.begin(), lengths.end());
+        agg.length_mean = std::accumulate(lengths.begin(), lengths.end(), 0.0) / lengths.size();
+        agg.length_p50 = RubiksSolver::Bench::percentile_sorted(lengths, 50.0);
+        agg.length_p99 = RubiksSolver::Bench::percentile_sorted(lengths, 99.0);
+        agg.length_max = lengths.back();
     }
-    
+    return agg;
+}
+
+static void print_statistics(const Aggregate& agg, const StartupTimes& startup) {
     std::cout << "\n========== BENCHMARK RESULTS ==========" << std::endl;
-    std::cout << "Total scrambles: " << results.size() << std::endl;
-    std::cout << "Successful solves: " << successful_results.size() << std::endl;
-    std::cout << "Success rate: " << std::fixed << std::setprecision(2) 
-              << (100.0 * successful_results.size() / results.size()) << "%" << std::endl;
-    
-    std::cout << "\n--- SOLVE TIME STATISTICS (ms) ---" << std::endl;
-    std::cout << "90th percentile: " << std::fixed << std::setprecision(2) 
-              << get_percentile(solve_times, 90.0) << " ms" << std::endl;
-    std::cout << "95th percentile: " << std::fixed << std::setprecision(2) 
-              << get_percentile(solve_times, 95.0) << " ms" << std::endl;
-    std::cout << "99th percentile: " << std::fixed << std::setprecision(2) 
-              << get_percentile(solve_times, 99.0) << " ms" << std::endl;
-    
-    double sum_time = 0.0;
-    for (double time : solve_times) {
-        sum_time += time;
-    }
-    double avg_time = sum_time / solve_times.size();
-    
-    std::sort(solve_times.begin(), solve_times.end());
-    double min_time = solve_times.front();
-    double max_time = solve_times.back();
-    double median_time = solve_times[solve_times.size() / 2];
-    
-    std::cout << "Average: " << std::fixed << std::setprecision(2) << avg_time << " ms" << std::endl;
-    std::cout << "Median: " << std::fixed << std::setprecision(2) << median_time << " ms" << std::endl;
-    std::cout << "Min: " << std::fixed << std::setprecision(2) << min_time << " ms" << std::endl;
-    std::cout << "Max: " << std::fixed << std::setprecision(2) << max_time << " ms" << std::endl;
-    
+    std::cout << "Total scrambles: " << agg.scrambles << std::endl;
+    std::cout << "Successful solves: " << agg.successes << std::endl;
+    std::cout << "Success rate: " << std::fixed << std::setprecision(2) << agg.success_rate << "%" << std::endl;
+
+    std::cout << "\n--- STARTUP (ms) ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Table init: " << ns_to_ms(startup.table_init_ns) << " ms" << std::endl;
+    std::cout << "All tables ready: " << ns_to_ms(startup.tables_ready_ns) << " ms" << std::endl;
+    std::cout << "Cold first solve: " << ns_to_ms(startup.cold_solve_ns) << " ms" << std::endl;
+
+    std::cout << "\n--- WARM SOLVE TIME STATISTICS (ms, " << agg.latency.count << " samples) ---" << std::endl;
+    RubiksSolver::Bench::print_latency(std::cout, agg.latency);
+
     std::cout << "\n--- SOLUTION LENGTH STATISTICS (moves) ---" << std::endl;
-    std::cout << "90th percentile: " << std::fixed << std::setprecision(1) 
-              << get_percentile(solution_lengths, 90.0) << " moves" << std::endl;
-    std::cout << "95th percentile: " << std::fixed << std::setprecision(1) 
-              << get_percentile(solution_lengths, 95.0) << " moves" << std::endl;
-    std::cout << "99th percentile: " << std::fixed << std::setprecision(1) 
-              << get_percentile(solution_lengths, 99.0) << " moves" << std::endl;
-    
-    double sum_length = 0.0;
-    for (double length : solution_lengths) {
-        sum_length += length;
-    }
-    double avg_length = sum_length / solution_lengths.size();
-    
-    std::sort(solution_lengths.begin(), solution_lengths.end());
-    double min_length = solution_lengths.front();
-    double max_length = solution_lengths.back();
-    double median_length = solution_lengths[solution_lengths.size() / 2];
-    
-    std::cout << "Average: " << std::fixed << std::setprecision(1) << avg_length << " moves" << std::endl;
-    std::cout << "Median: " << std::fixed << std::setprecision(1) << median_length << " moves" << std::endl;
-    std::cout << "Min: " << std::fixed << std::setprecision(1) << min_length << " moves" << std::endl;
-    std::cout << "Max: " << std::fixed << std::setprecision(1) << max_length << " moves" << std::endl;
-    
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Average: " << agg.length_mean << " moves" << std::endl;
+    std::cout << "Median: " << agg.length_p50 << " moves" << std::endl;
+    std::cout << "99th percentile: " << agg.length_p99 << " moves" << std::endl;
+    std::cout << "Max: " << agg.length_max << " moves" << std::endl;
+
     std::cout << "\n=======================================" << std::endl;
 }
 
-int main() {
+static void write_json(const std::string& path, const BenchmarkOptions& options, const StartupTimes& startup,
+                       const Aggregate& agg, const std::vector<BenchmarkResult>& results) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    RubiksSolver::Json::Writer w(out);
+    w.begin_object();
+    w.field("benchmark", "scrambles");
+    w.key("config").begin_object();
+    w.field("scramble_file", options.scramble_file);
+    w.field("random_states", static_cast<uint64_t>(options.random_states));
+    w.field("seed", options.seed);
+    w.field("warmup", options.warmup);
+    w.field("repeat", options.repeat);
+    w.end_object();
+    w.key("startup").begin_object();
+    w.field("table_init_ns", startup.table_init_ns);
+    w.field("tables_ready_ns", startup.tables_ready_ns);
+    w.field("cold_solve_ns", startup.cold_solve_ns);
+    w.end_object();
+    w.key("aggregate").begin_object();
+    w.field("scrambles", static_cast<uint64_t>(agg.scrambles));
+    w.field("successes", static_cast<uint64_t>(agg.successes));
+    w.field("success_rate", agg.success_rate);
+    w.key("latency");
+    RubiksSolver::Bench::write_latency_json(w, agg.latency);
+    w.key("length").begin_object();
+    w.field("length_mean", agg.length_mean);
+    w.field("length_p50", agg.length_p50);
+    w.field("length_p99", agg.length_p99);
+    w.field("length_max", agg.length_max);
+    w.end_object();
+    w.end_object();
+    w.key("scrambles").begin_array();
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        w.begin_object();
+        w.field("index", static_cast<uint64_t>(i));
+        w.field("scramble", result.scramble);
+        w.field("success", result.success);
+        w.field("length", result.solution_length);
+        if (!result.success) w.field("error", result.error);
+        w.key("solve_ns").begin_array();
+        for (uint64_t ns : result.solve_ns) w.value(ns);
+        w.end_array();
+        w.end_object();
+    }
+    w.end_array();
+    w.end_object();
+    out << '\n';
+}
+
+static void write_csv(const std::string& path, const std::vector<BenchmarkResult>& results) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    out << "index,repeat,success,length,solve_ns,scramble\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        if (result.solve_ns.empty()) {
+            out << i << ",0," << 0 << ",0,,\"" << result.scramble << "\"\n";
+            continue;
+        }
+        for (size_t r = 0; r < result.solve_ns.size(); ++r) {
+            out << i << ',' << r << ',' << result.success << ',' << result.solution_length << ','
+                << result.solve_ns[r] << ",\"" << result.scramble << "\"\n";
+        }
+    }
+}
+
+static void write_csv_aggregate(const std::string& path, const StartupTimes& startup, const Aggregate& agg) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    out << std::setprecision(12);
+    out << "metric,value\n";
+    out << "scrambles," << agg.scrambles << "\n";
+    out << "successes," << agg.successes << "\n";
+    out << "success_rate," << agg.success_rate << "\n";
+    out << "table_init_ns," << startup.table_init_ns << "\n";
+    out << "tables_ready_ns," << startup.tables_ready_ns << "\n";
+    out << "cold_solve_ns," << startup.cold_solve_ns << "\n";
+    out << "mean_ns," << agg.latency.mean_ns << "\n";
+    out << "min_ns," << agg.latency.min_ns << "\n";
+    out << "p50_ns," << agg.latency.p50_ns << "\n";
+    out << "p90_ns," << agg.latency.p90_ns << "\n";
+    out << "p95_ns," << agg.latency.p95_ns << "\n";
+    out << "p99_ns," << agg.latency.p99_ns << "\n";
+    out << "p999_ns," << agg.latency.p999_ns << "\n";
+    out << "max_ns," << agg.latency.max_ns << "\n";
+    out << "length_mean," << agg.length_mean << "\n";
+    out << "length_p99," << agg.length_p99 << "\n";
+}
+
+// 与基线比较：时间和解长度增加超过阈值、或成功率下降，都视为退化
+static bool compare_with_baseline(const std::string& path, double threshold_percent, const Aggregate& agg) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open baseline " + path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    size_t aggregate_pos = RubiksSolver::Json::find_key(text, "aggregate");
+    if (aggregate_pos == std::string::npos) {
+        throw std::runtime_error("Baseline " + path + " has no aggregate section");
+    }
+
+    struct Metric {
+        const char* key;
+        double current;
+        bool higher_is_worse;
+    };
+    const Metric metrics[] = {
+        {"success_rate", agg.success_rate, false},
+        {"mean_ns", agg.latency.mean_ns, true},
+        {"p50_ns", static_cast<double>(agg.latency.p50_ns), true},
+        {"p90_ns", static_cast<double>(agg.latency.p90_ns), true},
+        {"p99_ns", static_cast<double>(agg.latency.p99_ns), true},
+        {"length_mean", agg.length_mean, true},
+    };
+
+    std::cout << "\n--- BASELINE COMPARISON (" << path << ", threshold " << threshold_percent << "%) ---" << std::endl;
+    bool regressed = false;
+    for (const auto& metric : metrics) {
+        auto baseline = RubiksSolver::Json::find_number(text, metric.key, aggregate_pos);
+        if (!baseline) {
+            std::cout << metric.key << ": missing in baseline" << std::endl;
+            continue;
+        }
+        double change = *baseline == 0.0 ? 0.0 : 100.0 * (metric.current - *baseline) / *baseline;
+        bool bad;
+        if (metric.higher_is_worse) {
+            bad = change > threshold_percent;
+        } else {
+            // 成功率按绝对值比较，任何下降都算退化
+            bad = metric.current < *baseline;
+        }
+        regressed |= bad;
+        std::cout << std::fixed << std::setprecision(3)
+                  << metric.key << ": " << *baseline << " -> " << metric.current
+                  << " (" << std::showpos << change << std::noshowpos << "%)"
+                  << (bad ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressed;
+}
+
+// 吞吐量模式下单个线程数的结果
+struct ThroughputResult {
+    int threads = 0;
+    uint64_t wall_ns = 0;
+    size_t solves = 0;
+    size_t failures = 0;
+    double solves_per_second = 0.0;
+    double efficiency = 0.0; // 相对单线程吞吐量 x 线程数
+    LatencyStats latency;
+};
+
+// 每个线程使用独立的 Solver，从共享的原子下标中领取状态；所有线程共享同一份只读表
+static ThroughputResult run_throughput(const RubiksSolver::TableManager& tables, const RubiksSolver::SolveOptions& policy,
+                                       const std::vector<RubiksSolver::Cube>& cubes, int thread_count) {
+    std::atomic<size_t> next_index{0};
+    std::atomic<size_t> failures{0};
+    std::vector<std::vector<uint64_t>> samples(thread_count);
+
+    auto worker = [&](int id) {
+        RubiksSolver::Solver solver(tables, false);
+        solver.set_options(policy);
+        auto& local = samples[id];
+        local.reserve(cubes.size() / thread_count + 1);
+        for (size_t i = next_index.fetch_add(1, std::memory_order_relaxed); i < cubes.size();
+             i = next_index.fetch_add(1, std::memory_order_relaxed)) {
+            try {
+                auto start = Clock::now();
+                solver.solve(cubes[i]);
+                local.push_back(elapsed_ns(start, Clock::now()));
+            } catch (const std::exception&) {
+                failures.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ThroughputResult result;
+    result.threads = thread_count;
+    result.wall_ns = elapsed_ns(start, Clock::now());
+    std::vector<uint64_t> all;
+    for (auto& local : samples) {
+        all.insert(all.end(), local.begin(), local.end());
+    }
+    result.solves = all.size();
+    result.failures = failures.load();
+    result.solves_per_second = (result.solves + result.failures) / (result.wall_ns / 1e9);
+    result.latency = RubiksSolver::Bench::compute_latency_stats(std::move(all));
+    return result;
+}
+
+static std::vector<int> default_thread_counts() {
+    int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> counts;
+    for (int t = 1; t < hardware; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(hardware);
+    return counts;
+}
+
+static void run_throughput_mode(const BenchmarkOptions& options, const RubiksSolver::TableManager& tables,
+                                const std::vector<RubiksSolver::Cube>& cubes) {
+    std::vector<int> thread_counts = options.thread_counts.empty() ? default_thread_counts() : options.thread_counts;
+    std::cout << "Throughput mode: " << cubes.size() << " states, threads:";
+    for (int t : thread_counts) std::cout << ' ' << t;
+    std::cout << std::endl;
+
+    // 预热 (单线程，不计时)
+    {
+        RubiksSolver::Solver solver(tables, false);
+        solver.set_options(options.solve_options);
+        for (int i = 0; i < options.warmup; ++i) {
+            try { solver.solve(cubes[i % cubes.size()]); } catch (const std::exception&) {}
+        }
+    }
+
+    std::vector<ThroughputResult> results;
+    double single_thread_rate = 0.0;
+    for (int threads : thread_counts) {
+        ThroughputResult result = run_throughput(tables, options.solve_options, cubes, threads);
+        if (threads == 1 || single_thread_rate == 0.0) {
+            // 没有测单线程时，以第一个线程数的每线程吞吐量为基准
+            single_thread_rate = result.solves_per_second / threads;
+        }
+        result.efficiency = result.solves_per_second / (single_thread_rate * threads);
+        results.push_back(result);
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "threads=" << threads
+                  << "  throughput=" << result.solves_per_second << " solves/s"
+                  << "  efficiency=" << std::setprecision(1) << (100.0 * result.efficiency) << "%"
+                  << std::setprecision(3)
+                  << "  p50=" << ns_to_ms(result.latency.p50_ns) << " ms"
+                  << "  p99=" << ns_to_ms(result.latency.p99_ns) << " ms"
+                  << "  p99.9=" << ns_to_ms(result.latency.p999_ns) << " ms"
+                  << "  max=" << ns_to_ms(result.latency.max_ns) << " ms"
+                  << "  failures=" << result.failures << std::endl;
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        if (!out) throw std::runtime_error("Cannot write " + options.json_path);
+        RubiksSolver::Json::Writer w(out);
+        w.begin_object();
+        w.field("benchmark", "throughput");
+        w.key("config").begin_object();
+        w.field("states", static_cast<uint64_t>(cubes.size()));
+        w.field("random_states", static_cast<uint64_t>(options.random_states));
+        w.field("seed", options.seed);
+        w.field("warmup", options.warmup);
+        w.end_object();
+        w.key("results").begin_array();
+        for (const auto& result : results) {
+            w.begin_object();
+            w.field("threads", result.threads);
+            w.field("wall_ns", result.wall_ns);
+            w.field("solves", static_cast<uint64_t>(result.solves));
+            w.field("failures", static_cast<uint64_t>(result.failures));
+            w.field("solves_per_second", result.solves_per_second);
+            w.field("efficiency", result.efficiency);
+            w.key("latency");
+            RubiksSolver::Bench::write_latency_json(w, result.latency);
+            w.end_object();
+        }
+        w.end_array();
+        w.end_object();
+        out << '\n';
+        std::cout << "JSON results written to " << options.json_path << std::endl;
+    }
+    if (!options.csv_aggregate_path.empty()) {
+        std::ofstream out(options.csv_aggregate_path);
+        if (!out) throw std::runtime_error("Cannot write " + options.csv_aggregate_path);
+        out << std::setprecision(12);
+        out << "threads,wall_ns,solves,failures,solves_per_second,efficiency,mean_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n";
+        for (const auto& r : results) {
+            out << r.threads << ',' << r.wall_ns << ',' << r.solves << ',' << r.failures << ','
+                << r.solves_per_second << ',' << r.efficiency << ',' << r.latency.mean_ns << ','
+                << r.latency.p50_ns << ',' << r.latency.p90_ns << ',' << r.latency.p99_ns << ','
+                << r.latency.p999_ns << ',' << r.latency.max_ns << '\n';
+        }
+        std::cout << "CSV aggregate written to " << options.csv_aggregate_path << std::endl;
+    }
+}
+
+// ---------------- 节点数回归模式 ----------------
+// 记录每个打乱的搜索工作量 (与计时无关)，与提交到仓库的基准文件逐项比较
+
+struct NodeCountRecord {
+    bool success = false;
+    int length = 0;
+    RubiksSolver::SearchStats stats;
+};
+
+// 搜索工作量取决于搜索策略、深度上限和影响启发函数的表档位 (存储方式和预算本身不影响)
+static std::string golden_header(const RubiksSolver::SolveOptions& policy, const RubiksSolver::TableTiers& tiers) {
+    std::string limits;
+    for (const char* key : RubiksSolver::SearchLimits::KEYS) {
+        limits += (limits.empty() ? "" : ",") + std::to_string(policy.limits.get(key));
+    }
+    return "# node-count golden v4 policy=" + policy.describe() + " limits=" + limits
+         + " endgame=" + std::to_string(tiers.p1_endgame_depth) + "," + std::to_string(tiers.p2_endgame_depth)
+         + " combined=" + std::to_string(tiers.phase1_combined) + "," + std::to_string(tiers.phase2_combined);
+}
+
+static std::string join_counts(const std::vector<uint64_t>& counts) {
+    if (counts.empty()) return "-";
+    std::string text;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (i > 0) text += ',';
+        text += std::to_string(counts[i]);
+    }
+    return text;
+}
+
+static std::vector<uint64_t> split_counts(const std::string& text) {
+    std::vector<uint64_t> counts;
+    if (text == "-") return counts;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        counts.push_back(std::stoull(item));
+    }
+    return counts;
+}
+
+static void write_golden(const std::string& path, const std::string& header, const std::vector<NodeCountRecord>& records) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Cannot write " + path);
+    out << header << "\n";
+    out << "# index\tsuccess\tlength\tp1_nodes\tp2_nodes\tp1_probes\tp1_hits\tp2_probes\tp2_hits\tp1_iterations\tp2_iterations\n";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const auto& r = records[i];
+        const auto& p1 = r.stats.phases[0];
+        const auto& p2 = r.stats.phases[1];
+        out << i << '\t' << r.success << '\t' << r.length << '\t'
+            << p1.nodes() << '\t' << p2.nodes() << '\t'
+            << p1.endgame_probes << '\t' << p1.endgame_hits << '\t'
+            << p2.endgame_probes << '\t' << p2.endgame_hits << '\t'
+            << join_counts(p1.nodes_per_iteration) << '\t' << join_counts(p2.nodes_per_iteration) << '\n';
+    }
+}
+
+static std::vector<NodeCountRecord> read_golden(const std::string& path, const std::string& header) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open golden file " + path);
+    std::string line;
+    if (!std::getline(in, line) || line != header) {
+        throw std::runtime_error("Golden file " + path + " was recorded with a different format or build configuration");
+    }
+    std::vector<NodeCountRecord> records;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream stream(line);
+        size_t index;
+        uint64_t p1_nodes, p2_nodes;
+        std::string p1_iterations, p2_iterations;
+        NodeCountRecord r;
+        auto& p1 = r.stats.phases[0];
+        auto& p2 = r.stats.phases[1];
+        stream >> index >> r.success >> r.length >> p1_nodes >> p2_nodes
+               >> p1.endgame_probes >> p1.endgame_hits >> p2.endgame_probes >> p2.endgame_hits
+               >> p1_iterations >> p2_iterations;
+        if (!stream || index != records.size()) {
+            throw std::runtime_error("Malformed golden file line: " + line);
+        }
+        p1.nodes_per_iteration = split_counts(p1_iterations);
+        p2.nodes_per_iteration = split_counts(p2_iterations);
+        records.push_back(std::move(r));
+    }
+    return records;
+}
+
+// 任何计数增加都视为退化；减少视为改进 (需要重新生成基准文件)
+static bool compare_node_counts(const std::vector<NodeCountRecord>& golden, const std::vector<NodeCountRecord>& current,
+                                const std::vector<std::string>& labels) {
+    if (golden.size() != current.size()) {
+        std::cout << "Golden file has " << golden.size() << " entries, corpus has " << current.size() << std::endl;
+        return true;
+    }
+    size_t regressed = 0, improved = 0;
+    uint64_t golden_total = 0, current_total = 0;
+    for (size_t i = 0; i < current.size(); ++i) {
+        const auto& g = golden[i];
+        const auto& c = current[i];
+        std::vector<std::string> worse, better;
+        auto check = [&](const std::string& name, uint64_t before, uint64_t after) {
+            if (after > before) worse.push_back(name + " " + std::to_string(before) + "->" + std::to_string(after));
+            else if (after < before) better.push_back(name);
+        };
+        if (g.success && !c.success) worse.push_back("solve failed");
+        if (!g.success && c.success) {
+            // 之前失败的求解没有可比的计数
+            ++improved;
+            continue;
+        }
+        check("length", g.length, c.length);
+        for (int phase = 0; phase < 2; ++phase) {
+            const auto& gp = g.stats.phases[phase];
+            const auto& cp = c.stats.phases[phase];
+            std::string prefix = "p" + std::to_string(phase + 1) + "_";
+            check(prefix + "nodes", gp.nodes(), cp.nodes());
+            check(prefix + "iterations", gp.nodes_per_iteration.size(), cp.nodes_per_iteration.size());
+            size_t common = std::min(gp.nodes_per_iteration.size(), cp.nodes_per_iteration.size());
+            for (size_t it = 0; it < common; ++it) {
+                check(prefix + "iteration" + std::to_string(it) + "_nodes", gp.nodes_per_iteration[it], cp.nodes_per_iteration[it]);
+            }
+            check(prefix + "endgame_probes", gp.endgame_probes, cp.endgame_probes);
+            golden_total += gp.nodes();
+            current_total += cp.nodes();
+        }
+        if (!worse.empty()) {
+            ++regressed;
+            std::cout << "REGRESSION #" << i << " (" << labels[i] << "):";
+            for (const auto& w : worse) std::cout << ' ' << w << ';';
+            std::cout << std::endl;
+        } else if (!better.empty()) {
+            ++improved;
+        }
+    }
+    std::cout << "\n--- NODE COUNT COMPARISON ---" << std::endl;
+    std::cout << "Total nodes: " << golden_total << " -> " << current_total << std::endl;
+    std::cout << "Regressed: " << regressed << ", improved: " << improved
+              << ", unchanged: " << (current.size() - regressed - improved) << std::endl;
+    if (improved > 0 && regressed == 0) {
+        std::cout << "Counts improved; regenerate the golden file with --write-golden to lock in the gain." << std::endl;
+    }
+    return regressed > 0;
+}
+
+static int run_node_count_mode(const BenchmarkOptions& options, const RubiksSolver::TableManager& tables,
+                               const std::vector<RubiksSolver::Cube>& cubes, const std::vector<std::string>& labels) {
+    RubiksSolver::Solver solver(tables, false);
+    solver.set_options(options.solve_options);
+    std::vector<NodeCountRecord> records(cubes.size());
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        auto& record = records[i];
+        try {
+            record.length = static_cast<int>(solver.solve(cubes[i]).size());
+            record.success = true;
+        } catch (const std::exception&) {
+            record.success = false;
+        }
+        record.stats = solver.last_stats();
+    }
+
+    uint64_t p1_total = 0, p2_total = 0, probes = 0, hits = 0, frontier = 0, overflows = 0;
+    for (const auto& r : records) {
+        for (const auto& phase : r.stats.phases) {
+            frontier += phase.frontier_nodes;
+            overflows += phase.frontier_overflowed;
+        }
+        p1_total += r.stats.phases[0].nodes();
+        p2_total += r.stats.phases[1].nodes();
+        probes += r.stats.phases[0].endgame_probes + r.stats.phases[1].endgame_probes;
+        hits += r.stats.phases[0].endgame_hits + r.stats.phases[1].endgame_hits;
+    }
+    std::cout << "Node counts over " << records.size() << " states:" << std::endl;
+    std::cout << "  Phase 1 nodes: " << p1_total << std::endl;
+    std::cout << "  Phase 2 nodes: " << p2_total << std::endl;
+    std::cout << "  Endgame probes: " << probes << ", hits: " << hits << std::endl;
+    if (options.solve_options.reuse_frontier) {
+        std::cout << "  Frontier nodes recorded: " << frontier << ", overflows: " << overflows << std::endl;
+    }
+    const auto& fallbacks = solver.fallback_counters();
+    std::cout << "  Phase-1 resumes: " << fallbacks.phase1_resumes << " (in " << fallbacks.resumed_solves
+              << " solves), phase-2 widenings: " << fallbacks.phase2_widenings << std::endl;
+
+    if (!options.write_golden_path.empty()) {
+        write_golden(options.write_golden_path, golden_header(options.solve_options, tables.tiers()), records);
+        std::cout << "Golden node counts written to " << options.write_golden_path << std::endl;
+    }
+    if (!options.golden_path.empty()) {
+        if (compare_node_counts(read_golden(options.golden_path, golden_header(options.solve_options, tables.tiers())), records, labels)) {
+            std::cout << "Node count regression detected." << std::endl;
+            return options.regression_exit_code;
+        }
+        std::cout << "No node count regression." << std::endl;
+    }
+    return 0;
+}
+
+// ---------------- 同步批量求解模式 ----------------
+// 单线程下比较逐个求解 (Solver) 与多通道同步求解 (LockstepSolver) 的吞吐量，并检查两者的解是否相同
+
+static int run_lockstep_mode(const BenchmarkOptions& options, const RubiksSolver::TableManager& tables,
+                             const std::vector<RubiksSolver::Cube>& cubes) {
+    if (!RubiksSolver::LockstepSolver::supports(options.solve_options)) {
+        throw std::invalid_argument("--lockstep supports only the default search policy");
+    }
+    std::cout << "Lockstep mode: " << cubes.size() << " states, " << RubiksSolver::LockstepSolver::LANES << " lanes, "
+              << (RubiksSolver::LockstepSolver::uses_avx2() ? "AVX2 gathers" : "scalar lookups") << std::endl;
+
+    RubiksSolver::Solver solver(tables, false);
+    solver.set_options(options.solve_options);
+    std::vector<std::vector<RubiksSolver::Move>> expected(cubes.size());
+    size_t solver_failures = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        try {
+            expected[i] = solver.solve(cubes[i]);
+        } catch (const std::exception&) {
+            ++solver_failures;
+        }
+    }
+    uint64_t solver_ns = elapsed_ns(start, Clock::now());
+
+    RubiksSolver::LockstepSolver lockstep(tables, options.solve_options.limits);
+    start = Clock::now();
+    auto results = lockstep.solve(cubes);
+    uint64_t lockstep_ns = elapsed_ns(start, Clock::now());
+
+    size_t failures = 0, mismatches = 0;
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        RubiksSolver::Cube check = cubes[i];
+        check.apply_sequence(results[i].solution);
+        if (!results[i].error.empty() || !check.is_solved()) {
+            ++failures;
+        } else if (results[i].solution != expected[i]) {
+            ++mismatches;
+        }
+    }
+
+    auto rate = [&](uint64_t ns) { return cubes.size() / (ns / 1e9); };
+    std::cout << std::fixed << std::setprecision(1)
+              << "Solver:   " << rate(solver_ns) << " solves/s, " << solver.nodes_expanded() << " nodes, "
+              << solver_failures << " failures" << std::endl
+              << "Lockstep: " << rate(lockstep_ns) << " solves/s, " << lockstep.nodes_expanded() << " nodes, "
+              << failures << " failures, lane utilization " << (100.0 * lockstep.lane_utilization()) << "%" << std::endl
+              << "Speedup: " << std::setprecision(2) << static_cast<double>(solver_ns) / lockstep_ns << "x" << std::endl;
+    std::cout << "Solutions differing from Solver: " << mismatches << std::endl;
+    return failures > 0 || mismatches > 0 ? 1 : 0;
+}
+
+// ---------------- 协程交替求解模式 ----------------
+// 单线程下比较逐个求解 (Solver) 与多个求解协程交替执行 (InterleavedSolver) 的每核每秒展开节点数
+// 分别测量只在终局数据库查询前让出，以及在所有查表前让出
+
+static int run_interleave_mode(const BenchmarkOptions& options, const RubiksSolver::TableManager& tables,
+                               const std::vector<RubiksSolver::Cube>& cubes) {
+    if (!RubiksSolver::InterleavedSolver::supports(options.solve_options)) {
+        throw std::invalid_argument("--interleave supports only the default search policy");
+    }
+    std::cout << "Interleave mode: " << cubes.size() << " states" << std::endl;
+
+    RubiksSolver::Solver solver(tables, false);
+    solver.set_options(options.solve_options);
+    std::vector<std::vector<RubiksSolver::Move>> expected(cubes.size());
+    size_t solver_failures = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < cubes.size(); ++i) {
+        try {
+            expected[i] = solver.solve(cubes[i]);
+        } catch (const std::exception&) {
+            ++solver_failures;
+        }
+    }
+    uint64_t solver_ns = elapsed_ns(start, Clock::now());
+    auto node_rate = [](uint64_t nodes, uint64_t ns) { return nodes / (ns / 1e9) / 1e6; };
+    std::cout << std::fixed << std::setprecision(2)
+              << "Solver:         " << node_rate(solver.nodes_expanded(), solver_ns) << " Mnodes/s, "
+              << cubes.size() / (solver_ns / 1e9) << " solves/s, " << solver_failures << " failures" << std::endl;
+
+    int exit_code = 0;
+    for (bool table_yields : {false, true})
+    for (unsigned width : options.interleave_widths) {
+        RubiksSolver::InterleavedSolver interleaved(tables, width, table_yields, options.solve_options.limits);
+        start = Clock::now();
+        auto results = interleaved.solve(cubes);
+        uint64_t wall_ns = elapsed_ns(start, Clock::now());
+
+        size_t failures = 0, mismatches = 0;
+        for (size_t i = 0; i < cubes.size(); ++i) {
+            RubiksSolver::Cube check = cubes[i];
+            check.apply_sequence(results[i].solution);
+            if (!results[i].error.empty() || !check.is_solved()) {
+                ++failures;
+            } else if (results[i].solution != expected[i]) {
+                ++mismatches;
+            }
+        }
+        if (failures > 0 || mismatches > 0) exit_code = 1;
+        std::cout << "Interleaved x" << std::setw(2) << width << (table_yields ? " (all tables): " : " (endgame):    ")
+                  << node_rate(interleaved.nodes_expanded(), wall_ns) << " Mnodes/s, "
+                  << cubes.size() / (wall_ns / 1e9) << " solves/s, "
+                  << "speedup " << static_cast<double>(solver_ns) / wall_ns << "x, "
+                  << static_cast<double>(interleaved.suspensions()) / std::max<uint64_t>(1, interleaved.nodes_expanded()) << " suspensions/node, "
+                  << failures << " failures, " << mismatches << " differing solutions" << std::endl;
+    }
+    return exit_code;
+}
+
+// ---------------- 调优模式 ----------------
+// 在语料上扫描深度上限和阈值的组合，按 (平均耗时, 平均解长度) 求 Pareto 前沿；
+// 选出平均解长度不超过当前配置 (加上允许的差值) 的最快组合，写入配置文件供求解器启动时加载
+
+struct TuneResult {
+    RubiksSolver::SearchLimits limits;
+    size_t failures = 0;
+    LatencyStats latency;
+    double length_mean = 0.0;
+    double length_p99 = 0.0;
+    bool pareto = false;
+};
+
+// 未指定的键按默认取值扫描；取值总是包含当前配置的值
+static std::vector<std::pair<std::string, std::vector<int>>> tune_axes(const BenchmarkOptions& options,
+                                                                      const RubiksSolver::SearchLimits& current) {
+    // 第一阶段的直径为 12，更小的深度上限在语料之外可能无解，默认不扫描
+    std::vector<std::pair<std::string, std::vector<int>>> axes = {
+        {"phase1_max_depth", {12, 13}},
+        {"phase2_total", {23, 24, 25, 26}},
+        {"p1_probe_depth", {4, 5, 6}},
+        {"p2_probe_depth", {5, 6, 7}},
+    };
+    for (const auto& [key, values] : options.tune_grid) {
+        auto it = std::find_if(axes.begin(), axes.end(), [&](const auto& axis) { return axis.first == key; });
+        if (it != axes.end()) {
+            it->second = values;
+        } else {
+            axes.emplace_back(key, values);
+        }
+    }
+    for (auto& [key, values] : axes) {
+        if (std::find(values.begin(), values.end(), current.get(key)) == values.end()) {
+            values.push_back(current.get(key));
+        }
+        std::sort(values.begin(), values.end());
+    }
+    return axes;
+}
+
+static TuneResult run_tune_config(const RubiksSolver::TableManager& tables, const BenchmarkOptions& options,
+                                  const RubiksSolver::SearchLimits& limits, const std::vector<RubiksSolver::Cube>& cubes) {
+    RubiksSolver::SolveOptions solve_options = options.solve_options;
+    solve_options.limits = limits;
+    RubiksSolver::Solver solver(tables, false);
+    solver.set_options(solve_options);
+
+    TuneResult result;
+    result.limits = limits;
+    std::vector<uint64_t> samples;
+    std::vector<double> lengths;
+    for (int pass = 0; pass < options.repeat; ++pass) {
+        for (const auto& cube : cubes) {
+            uint64_t ns = 0;
+            int length = 0;
+            std::string error;
+            if (!timed_solve(solver, cube, ns, length, error)) {
+                ++result.failures;
+                continue;
+            }
+            samples.push_back(ns);
+            lengths.push_back(length);
+        }
+    }
+    result.latency = RubiksSolver::Bench::compute_latency_stats(std::move(samples));
+    if (!lengths.empty()) {
+        std::sort(lengths.begin(), lengths.end());
+        result.length_mean = std::accumulate(lengths.begin(), lengths.end(), 0.0) / lengths.size();
+        result.length_p99 = RubiksSolver::Bench::percentile_sorted(lengths, 99.0);
+    }
+    return result;
+}
+
+static void print_tune_result(const std::string& label, const TuneResult& r) {
+    std::cout << std::fixed << std::setprecision(3)
+              << label << " mean=" << ns_to_ms(r.latency.mean_ns) << " ms"
+              << "  p50=" << ns_to_ms(r.latency.p50_ns) << " ms"
+              << "  p99=" << ns_to_ms(r.latency.p99_ns) << " ms"
+              << std::setprecision(2)
+              << "  length mean=" << r.length_mean << " p99=" << std::setprecision(0) << r.length_p99
+              << "  failures=" << r.failures
+              << "  [" << r.limits.describe() << "]" << std::endl;
+}
+
+static int run_tune_mode(const BenchmarkOptions& options, const RubiksSolver::TableManager& tables,
+                         const std::vector<RubiksSolver::Cube>& cubes) {
+    const RubiksSolver::SearchLimits current = options.solve_options.limits;
+    const auto axes = tune_axes(options, current);
+
+    std::vector<RubiksSolver::SearchLimits> configs(1, current);
+    for (const auto& [key, values] : axes) {
+        std::vector<RubiksSolver::SearchLimits> expanded;
+        for (const auto& config : configs) {
+            for (int value : values) {
+                RubiksSolver::SearchLimits next = config;
+                next.set(key, value);
+                expanded.push_back(next);
+            }
+        }
+        configs = std::move(expanded);
+    }
+    std::cout << "Tuning " << configs.size() << " configurations on " << cubes.size() << " states ("
+              << options.repeat << " pass(es), policy " << options.solve_options.describe() << ")" << std::endl;
+
+    // 预热 (当前配置，不计时)
+    {
+        RubiksSolver::Solver solver(tables, false);
+        solver.set_options(options.solve_options);
+        for (int i = 0; i < options.warmup; ++i) {
+            try { solver.solve(cubes[i % cubes.size()]); } catch (const std::exception&) {}
+        }
+    }
+
+    std::vector<TuneResult> results;
+    const TuneResult* reference = nullptr;
+    for (size_t i = 0; i < configs.size(); ++i) {
+        results.push_back(run_tune_config(tables, options, configs[i], cubes));
+        if (options.verbose) {
+            print_tune_result("[" + std::to_string(i + 1) + "/" + std::to_string(configs.size()) + "]", results.back());
+        }
+    }
+    for (const auto& r : results) {
+        if (r.limits == current) reference = &r;
+    }
+
+    // 有失败的组合不参与比较
+    for (auto& r : results) {
+        if (r.failures > 0) continue;
+        r.pareto = std::none_of(results.begin(), results.end(), [&](const TuneResult& other) {
+            return other.failures == 0
+                && other.latency.mean_ns <= r.latency.mean_ns && other.length_mean <= r.length_mean
+                && (other.latency.mean_ns < r.latency.mean_ns || other.length_mean < r.length_mean);
+        });
+    }
+    std::vector<const TuneResult*> front;
+    for (const auto& r : results) {
+        if (r.pareto) front.push_back(&r);
+    }
+    std::sort(front.begin(), front.end(), [](const TuneResult* a, const TuneResult* b) {
+        return a->latency.mean_ns < b->latency.mean_ns;
+    });
+    if (front.empty()) {
+        throw std::runtime_error("Every tuning configuration failed on some states");
+    }
+
+    // 前沿按耗时升序，长度随之递减：第一个满足长度约束的就是最快的
+    const double max_length = reference->failures == 0 ? reference->length_mean + options.tune_length_slack : 0.0;
+    const TuneResult* chosen = front.back();
+    for (const TuneResult* r : front) {
+        if (r->length_mean <= max_length + 1e-9) {
+            chosen = r;
+            break;
+        }
+    }
+
+    std::cout << "\n--- PARETO FRONT (mean time vs mean length) ---" << std::endl;
+    for (const TuneResult* r : front) {
+        print_tune_result(r == chosen ? "* " : "  ", *r);
+    }
+    std::cout << "\n--- CURRENT ---" << std::endl;
+    print_tune_result("  ", *reference);
+    std::cout << "\n--- CHOSEN ---" << std::endl;
+    print_tune_result("  ", *chosen);
+
+    if (!options.csv_aggregate_path.empty()) {
+        std::ofstream out(options.csv_aggregate_path);
+        if (!out) throw std::runtime_error("Cannot write " + options.csv_aggregate_path);
+        out << std::setprecision(12);
+        for (const char* key : RubiksSolver::SearchLimits::KEYS) out << key << ',';
+        out << "failures,mean_ns,p50_ns,p99_ns,length_mean,length_p99,pareto\n";
+        for (const auto& r : results) {
+            for (const char* key : RubiksSolver::SearchLimits::KEYS) out << r.limits.get(key) << ',';
+            out << r.failures << ',' << r.latency.mean_ns << ',' << r.latency.p50_ns << ',' << r.latency.p99_ns << ','
+                << r.length_mean << ',' << r.length_p99 << ',' << r.pareto << '\n';
+        }
+        std::cout << "CSV aggregate written to " << options.csv_aggregate_path << std::endl;
+    }
+
+    std::ostringstream comment;
+    comment << std::fixed << std::setprecision(3)
+            << "Search limits written by benchmark --tune (" << results.size() << " configurations, "
+            << cubes.size() << " states"
+            << (options.random_states > 0 ? ", random seed " + std::to_string(options.seed) : ", " + options.scramble_file)
+            << ")\n"
+            << "policy " << options.solve_options.describe() << "; tables: " << tables.tiers().describe() << "\n"
+            << "mean " << ns_to_ms(chosen->latency.mean_ns) << " ms, p99 " << ns_to_ms(chosen->latency.p99_ns)
+            << " ms, mean length " << std::setprecision(2) << chosen->length_mean
+            << " (was " << std::setprecision(3) << ns_to_ms(reference->latency.mean_ns) << " ms, "
+            << std::setprecision(2) << reference->length_mean << ")";
+    chosen->limits.save(options.tune_output, comment.str());
+    std::cout << "Chosen limits written to " << options.tune_output << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     try {
+        BenchmarkOptions options = parse_options(argc, argv);
+        StartupTimes startup;
+
         std::cout << "Initializing tables..." << std::endl;
+        auto init_start = Clock::now();
         const auto& tables = RubiksSolver::TableManager::get_instance();
+        startup.table_init_ns = elapsed_ns(init_start, Clock::now());
+        // 等待后台加载完成，避免前几次求解因终局数据库未就绪而变慢
+        tables.wait_until_all_ready();
+        startup.tables_ready_ns = elapsed_ns(init_start, Clock::now());
         std::cout << "Tables initialized successfully." << std::endl;
-        
-        RubiksSolver::Solver solver(tables);
-        
-        std::ifstream file("sc.txt");
-        if (!file.is_open()) {
-            std::cerr << "Error: Cannot open sc.txt file" << std::endl;
-            return 1;
-        }
-        
+
+        RubiksSolver::Solver solver(tables, options.verbose);
+        solver.set_options(options.solve_options);
+        std::unique_ptr<RubiksSolver::RacingSolver> racer;
+        if (options.race) {
+            racer = std::make_unique<RubiksSolver::RacingSolver>(
+                tables, RubiksSolver::RacingSolver::Options{RubiksSolver::RacingSolver::VARIANT_COUNT, options.race_budget_us,
+                                                            options.solve_options});
+        }
+        std::unique_ptr<RubiksSolver::PipelinedSolver> pipeline;
+        RubiksSolver::PipelinedSolver::Stats pipeline_totals;
+        uint64_t pipeline_solves = 0;
+        if (options.pipeline) {
+            options.pipeline_options.limits = options.solve_options.limits;
+            pipeline = std::make_unique<RubiksSolver::PipelinedSolver>(tables, options.pipeline_options);
+        }
+        auto solve_timed = [&](const RubiksSolver::Cube& cube, uint64_t& ns, int& length, std::string& error) {
+            if (pipeline) {
+                bool ok = timed_solve(*pipeline, cube, ns, length, error);
+                if (ok) {
+                    const auto& stats = pipeline->last_stats();
+                    ++pipeline_solves;
+                    pipeline_totals.endpoints += stats.endpoints;
+                    pipeline_totals.endpoints_searched += stats.endpoints_searched;
+                    pipeline_totals.improvements += stats.improvements;
+                    pipeline_totals.phase1_nodes += stats.phase1_nodes;
+                    pipeline_totals.phase2_nodes += stats.phase2_nodes;
+                    pipeline_totals.first_solution_ns += stats.first_solution_ns;
+                    pipeline_totals.best_solution_ns += stats.best_solution_ns;
+                }
+                return ok;
+            }
+            return racer ? timed_solve(*racer, cube, ns, length, error) : timed_solve(solver, cube, ns, length, error);
+        };
+
+        // 在计时区间外准备所有状态：随机状态以色块字符串标识
         std::vector<std::string> scrambles;
-        std::string line;
-        
-        while (std::getline(file, line)) {
-            if (!line.empty()) {
-                scrambles.push_back(line);
+        std::vector<RubiksSolver::Cube> cubes;
+        if (options.random_states > 0) {
+            RubiksSolver::RandomStateGenerator generator(options.seed);
+            cubes = generator.generate(options.random_states);
+            std::cout << "Generated " << cubes.size() << " random states (seed " << options.seed << ")" << std::endl;
+        } else {
+            scrambles = load_scrambles(options.scramble_file);
+            for (const auto& scramble : scrambles) {
+                cubes.push_back(RubiksSolver::Cube::parse(scramble));
             }
+            std::cout << "Loaded " << scrambles.size() << " scrambles from " << options.scramble_file << std::endl;
         }
-        file.close();
-        
-        std::cout << "Loaded " << scrambles.size() << " scrambles from sc.txt" << std::endl;
-        std::cout << "Starting benchmark...\n" << std::endl;
-        
-        std::vector<BenchmarkResult> results;
-        results.reserve(scrambles.size());
-        
-        for (size_t i = 0; i < scrambles.size(); ++i) {
-            const std::string& scramble = scrambles[i];
-            std::cout << "Processing scramble " << (i + 1) << "/" << scrambles.size() << ": " << scramble << std::endl;
-            
-            BenchmarkResult result;
-            result.scramble = scramble;
-            result.success = false;
-            
-            try {
-                auto cube = RubiksSolver::Cube::from_scramble(scramble);
-                
-                auto start_time = std::chrono::high_resolution_clock::now();
-                std::vector<RubiksSolver::Move> solution = solver.solve(cube);
-                auto end_time = std::chrono::high_resolution_clock::now();
-                
-                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-                result.solve_time_ms = duration.count();
-                result.solution_length = static_cast<int>(solution.size());
-                result.success = true;
-                
-                std::cout << "  ✓ Solved in " << std::fixed << std::setprecision(2) 
-                          << result.solve_time_ms << " ms, " 
-                          << result.solution_length << " moves" << std::endl;
-                
-            } catch (const std::exception& e) {
-                std::cout << "  ✗ Failed: " << e.what() << std::endl;
-                result.solve_time_ms = 0.0;
-                result.solution_length = 0;
+        if (cubes.empty()) {
+            throw std::runtime_error("No states to solve");
+        }
+
+        std::vector<std::string> labels(cubes.size());
+        for (size_t i = 0; i < cubes.size(); ++i) {
+            labels[i] = scrambles.empty() ? cubes[i].to_facelets() : scrambles[i];
+        }
+
+        if (options.throughput) {
+            run_throughput_mode(options, tables, cubes);
+            return 0;
+        }
+        if (options.node_counts) {
+            return run_node_count_mode(options, tables, cubes, labels);
+        }
+        if (options.tune) {
+            return run_tune_mode(options, tables, cubes);
+        }
+        if (options.lockstep) {
+            return run_lockstep_mode(options, tables, cubes);
+        }
+        if (!options.interleave_widths.empty()) {
+            return run_interleave_mode(options, tables, cubes);
+        }
+
+        std::vector<BenchmarkResult> results(cubes.size());
+        for (size_t i = 0; i < cubes.size(); ++i) {
+            results[i].scramble = labels[i];
+        }
+
+        // 冷启动：表就绪后的第一次求解
+        {
+            int length = 0;
+            std::string error;
+            solve_timed(cubes[0], startup.cold_solve_ns, length, error);
+        }
+
+        std::cout << "Warming up (" << options.warmup << " solves)..." << std::endl;
+        for (int i = 0; i < options.warmup; ++i) {
+            uint64_t ns = 0;
+            int length = 0;
+            std::string error;
+            solve_timed(cubes[i % cubes.size()], ns, length, error);
+        }
+
+        std::cout << "Starting benchmark (" << options.repeat << " pass(es))...\n" << std::endl;
+        for (int pass = 0; pass < options.repeat; ++pass) {
+            for (size_t i = 0; i < cubes.size(); ++i) {
+                auto& result = results[i];
+                if (pass > 0 && !result.success) continue;
+
+                uint64_t ns = 0;
+                int length = 0;
+                std::string error;
+                bool ok = solve_timed(cubes[i], ns, length, error);
+                if (pass == 0) {
+                    result.success = ok;
+                    result.solution_length = length;
+                    result.error = error;
+                }
+                if (ok) {
+                    result.solve_ns.push_back(ns);
+                }
+
+                if (options.verbose || !ok) {
+                    std::cout << "Scramble " << (i + 1) << "/" << cubes.size() << ": " << result.scramble;
+                    if (ok) {
+                        std::cout << "  ✓ " << std::fixed << std::setprecision(3) << ns_to_ms(ns) << " ms, "
+                                  << length << " moves" << std::endl;
+                    } else {
+                        std::cout << "  ✗ Failed: " << error << std::endl;
+                    }
+                }
+            }
+        }
+
+        Aggregate agg = aggregate_results(results);
+        print_statistics(agg, startup);
+        if (pipeline && pipeline_solves > 0) {
+            const double n = static_cast<double>(pipeline_solves);
+            std::cout << std::fixed << std::setprecision(3)
+                      << "Pipeline: first solution after " << ns_to_ms(pipeline_totals.first_solution_ns / n)
+                      << " ms, final solution after " << ns_to_ms(pipeline_totals.best_solution_ns / n) << " ms (mean); "
+                      << std::setprecision(1) << pipeline_totals.improvements / n << " improvements, "
+                      << pipeline_totals.endpoints_searched / n << " of " << pipeline_totals.endpoints / n
+                      << " phase-1 endpoints searched, " << std::setprecision(0) << pipeline_totals.phase1_nodes / n
+                      << " + " << pipeline_totals.phase2_nodes / n << " nodes per solve" << std::endl;
+        } else if (!racer) {
+            const auto& fallbacks = solver.fallback_counters();
+            std::cout << "Fallbacks: " << fallbacks.resumed_solves << " of " << fallbacks.solves
+                      << " solves resumed phase 1 (" << fallbacks.phase1_resumes << " resumes), "
+                      << fallbacks.phase2_widenings << " phase-2 widenings" << std::endl;
+        }
+
+        if (!options.json_path.empty()) {
+            write_json(options.json_path, options, startup, agg, results);
+            std::cout << "JSON results written to " << options.json_path << std::endl;
+        }
+        if (!options.csv_path.empty()) {
+            write_csv(options.csv_path, results);
+            std::cout << "CSV results written to " << options.csv_path << std::endl;
+        }
+        if (!options.csv_aggregate_path.empty()) {
+            write_csv_aggregate(options.csv_aggregate_path, startup, agg);
+            std::cout << "CSV aggregate written to " << options.csv_aggregate_path << std::endl;
+        }
+        if (!options.baseline_path.empty()) {
+            if (compare_with_baseline(options.baseline_path, options.threshold_percent, agg)) {
+                std::cout << "Performance regression detected." << std::endl;
+                return options.regression_exit_code;
             }
-            
-            results.push_back(result);
+            std::cout << "No regression against baseline." << std::endl;
         }
-        
-        print_statistics(results);
-        
+
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-    
+
     return 0;
 }
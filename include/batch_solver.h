@@ -0,0 +1,46 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include "table_manager.h"
+#include "solution_cache.h"
+#include "solve_options.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace RubiksSolver {
+
+enum class BatchFormat {
+    Plain,  // 每行一个解 (或 "ERROR: ...")
+    NDJSON  // 每行一个JSON对象
+};
+
+struct BatchOptions {
+    std::string input_path = "-";   // "-" 表示标准输入
+    unsigned threads = 0;           // 0 表示使用硬件线程数
+    BatchFormat format = BatchFormat::Plain;
+    bool ordered = true;            // 按输入顺序输出；关闭时按完成顺序输出
+    size_t batch_size = 256;        // 每个批次的行数，在各阶段之间整体传递
+    size_t queue_capacity = 64;     // 阶段之间队列的批次数
+    SolutionCache* cache = nullptr; // 所有求解线程共享的解缓存
+    SolveOptions policy;            // 搜索策略
+    bool lockstep = false;          // 每个批次用 LockstepSolver 多通道同步求解 (只支持默认策略，不使用缓存)
+    unsigned interleave = 0;        // 大于0时每个批次用 InterleavedSolver 以此宽度交替求解 (限制同上)
+};
+
+struct BatchSummary {
+    uint64_t total = 0;
+    uint64_t solved = 0;
+    uint64_t failed = 0;
+    uint64_t elapsed_ns = 0;
+};
+
+// 非交互的批量求解：读取 -> 解析 -> 求解 (多线程) -> 输出 四个流水线阶段
+// 阶段之间用有界无锁队列连接；输入为每行一个打乱序列或54个字符的色块字符串，'#' 之后为注释
+// 普通文件用 mmap 读取，标准输入按大块读取
+// 选项组合无效 (例如缓存与非默认策略、lockstep 与 interleave) 时抛出 std::invalid_argument
+BatchSummary run_batch(const TableManager& tables, const BatchOptions& options, std::ostream& out);
+
+} // namespace RubiksSolver
+
+#endif // BATCH_SOLVER_H
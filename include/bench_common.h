@@ -0,0 +1,91 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "json_util.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 基准测试程序共用的计时与统计工具
+namespace RubiksSolver::Bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline uint64_t elapsed_ns(Clock::time_point start, Clock::time_point end) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+inline double ns_to_ms(double ns) { return ns / 1e6; }
+
+// 已排序样本的百分位数 (与原 benchmark 相同：取下标 p * (n - 1))
+template<typename T>
+inline T percentile_sorted(const std::vector<T>& sorted, double percentile) {
+    if (sorted.empty()) return T{};
+    size_t index = static_cast<size_t>((percentile / 100.0) * (sorted.size() - 1));
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// 延迟分布 (纳秒)
+struct LatencyStats {
+    size_t count = 0;
+    double mean_ns = 0.0;
+    uint64_t min_ns = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p95_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t max_ns = 0;
+};
+
+inline LatencyStats compute_latency_stats(std::vector<uint64_t> samples) {
+    LatencyStats stats;
+    if (samples.empty()) return stats;
+    std::sort(samples.begin(), samples.end());
+    stats.count = samples.size();
+    stats.mean_ns = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    stats.min_ns = samples.front();
+    stats.p50_ns = percentile_sorted(samples, 50.0);
+    stats.p90_ns = percentile_sorted(samples, 90.0);
+    stats.p95_ns = percentile_sorted(samples, 95.0);
+    stats.p99_ns = percentile_sorted(samples, 99.0);
+    stats.p999_ns = percentile_sorted(samples, 99.9);
+    stats.max_ns = samples.back();
+    return stats;
+}
+
+inline void write_latency_json(Json::Writer& w, const LatencyStats& stats) {
+    w.begin_object();
+    w.field("count", static_cast<uint64_t>(stats.count));
+    w.field("mean_ns", stats.mean_ns);
+    w.field("min_ns", stats.min_ns);
+    w.field("p50_ns", stats.p50_ns);
+    w.field("p90_ns", stats.p90_ns);
+    w.field("p95_ns", stats.p95_ns);
+    w.field("p99_ns", stats.p99_ns);
+    w.field("p999_ns", stats.p999_ns);
+    w.field("max_ns", stats.max_ns);
+    w.end_object();
+}
+
+inline void print_latency(std::ostream& os, const LatencyStats& stats) {
+    auto ms = [](double ns) { return ns_to_ms(ns); };
+    os << std::fixed << std::setprecision(3);
+    os << "Average: " << ms(stats.mean_ns) << " ms" << std::endl;
+    os << "Median: " << ms(stats.p50_ns) << " ms" << std::endl;
+    os << "90th percentile: " << ms(stats.p90_ns) << " ms" << std::endl;
+    os << "95th percentile: " << ms(stats.p95_ns) << " ms" << std::endl;
+    os << "99th percentile: " << ms(stats.p99_ns) << " ms" << std::endl;
+    os << "99.9th percentile: " << ms(stats.p999_ns) << " ms" << std::endl;
+    os << "Min: " << ms(stats.min_ns) << " ms" << std::endl;
+    os << "Max: " << ms(stats.max_ns) << " ms" << std::endl;
+}
+
+} // namespace RubiksSolver::Bench
+
+#endif // BENCH_COMMON_H
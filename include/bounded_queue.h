@@ -0,0 +1,151 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace RubiksSolver {
+
+// 有界无锁多生产者多消费者队列 (Vyukov 环形缓冲区)
+// 每个槽位带一个序号：序号 == 入队位置 表示可写，序号 == 出队位置 + 1 表示可读
+// 队列满/空时 push/pop 先自旋再让出CPU；等待较久后在原子计数上阻塞 (std::atomic::wait)，
+// 空闲的消费者 (例如等待缓慢的标准输入时) 不再占满CPU。对方完成一次操作后，只在有阻塞者时才递增计数并唤醒
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity_(std::bit_ceil(std::max<size_t>(capacity, 2))),
+          mask_(capacity_ - 1),
+          cells_(std::make_unique<Cell[]>(capacity_)) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool try_push(T& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    wake(pushed_, pop_waiters_);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // 已满
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.data);
+                    cell.sequence.store(pos + capacity_, std::memory_order_release);
+                    wake(popped_, push_waiters_);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // 为空
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void push(T value) {
+        for (unsigned spins = 0; !try_push(value); ++spins) {
+            if (spins >= BLOCK_AFTER_SPINS) {
+                block_until(popped_, push_waiters_, [&] { return try_push(value); });
+                return;
+            }
+            backoff(spins);
+        }
+    }
+
+    T pop() {
+        T value;
+        for (unsigned spins = 0; !try_pop(value); ++spins) {
+            if (spins >= BLOCK_AFTER_SPINS) {
+                block_until(pushed_, pop_waiters_, [&] { return try_pop(value); });
+                break;
+            }
+            backoff(spins);
+        }
+        return value;
+    }
+
+    inline size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    // 前32次自旋，之后让出CPU，共 BLOCK_AFTER_SPINS 次仍未成功时阻塞
+    static constexpr unsigned BLOCK_AFTER_SPINS = 256;
+
+    static inline void backoff(unsigned spins) {
+        if (spins >= 32) {
+            std::this_thread::yield();
+        }
+    }
+
+    // 登记为阻塞者后再尝试，失败则等待 signal 变化；先读 signal 再尝试，不会错过其间的唤醒
+    template<typename Attempt>
+    static void block_until(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiters, Attempt&& attempt) {
+        waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (;;) {
+            uint32_t observed = signal.load(std::memory_order_acquire);
+            if (attempt()) break;
+            signal.wait(observed, std::memory_order_acquire);
+        }
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // 与 block_until 中的栅栏配对：要么阻塞者的尝试能看到本次操作，要么这里能看到阻塞者
+    static inline void wake(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiters) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_all();
+        }
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    // 生产者与消费者的位置放在不同的缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) std::atomic<size_t> dequeue_pos_{0};
+    // 阻塞等待用的计数：入队/出队成功的通知次数，以及正在阻塞的消费者/生产者数
+    alignas(64) std::atomic<uint32_t> pushed_{0};
+    std::atomic<uint32_t> pop_waiters_{0};
+    alignas(64) std::atomic<uint32_t> popped_{0};
+    std::atomic<uint32_t> push_waiters_{0};
+};
+
+} // namespace RubiksSolver
+
+#endif // BOUNDED_QUEUE_H
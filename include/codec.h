@@ -0,0 +1,180 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace RubiksSolver {
+
+// C(n, k) 查询表
+constexpr std::array<std::array<int, 13>, 13> precompute_combinations() {
+    std::array<std::array<int, 13>, 13> table{};
+    for (int n = 0; n < 13; ++n) {
+        table[n][0] = 1;
+        for (int k = 1; k <= n; ++k) {
+            table[n][k] = table[n - 1][k - 1] + table[n - 1][k];
+        }
+    }
+    return table;
+}
+constexpr std::array<std::array<int, 13>, 13> C_nk_table = precompute_combinations();
+
+constexpr std::array<int, 13> factorials = {
+    1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800, 479001600
+};
+
+// 坐标编解码库：全部为 constexpr，不做任何堆分配
+// 排列使用位掩码 + popcount 计算 Lehmer 编码，组合使用组合数求和
+namespace Codec {
+
+// 返回 mask 中第 n 个 (从0开始) 置位的位置
+constexpr uint32_t select_bit(uint32_t mask, uint32_t n) {
+    for (; n > 0; --n) {
+        mask &= mask - 1;
+    }
+    return static_cast<uint32_t>(std::countr_zero(mask));
+}
+
+// 排列 -> Lehmer 编码
+// values 为 N 个互不相同的块编号，取值范围 [base, base + N)
+// 每一位的数字 = 尚未使用且小于当前值的块数
+template<size_t N>
+constexpr uint32_t rank_permutation(const uint8_t* values, uint8_t base = 0) {
+    static_assert(N <= 12, "Permutation too large");
+    uint32_t rank = 0;
+    uint32_t used = 0;
+    for (size_t i = 0; i < N; ++i) {
+        uint32_t v = values[i] - base;
+        uint32_t smaller_used = static_cast<uint32_t>(std::popcount(used & ((1u << v) - 1)));
+        rank += (v - smaller_used) * factorials[N - 1 - i];
+        used |= 1u << v;
+    }
+    return rank;
+}
+
+// Lehmer 编码 -> 排列
+template<size_t N>
+constexpr void unrank_permutation(uint32_t rank, uint8_t* values, uint8_t base = 0) {
+    static_assert(N <= 12, "Permutation too large");
+    uint32_t available = (1u << N) - 1;
+    for (size_t i = 0; i < N; ++i) {
+        uint32_t f = factorials[N - 1 - i];
+        uint32_t index = rank / f;
+        rank -= index * f;
+        uint32_t v = select_bit(available, index);
+        available &= ~(1u << v);
+        values[i] = static_cast<uint8_t>(base + v);
+    }
+}
+
+// 排列 -> Lehmer 编码，同时给出排列的奇偶性 (Lehmer 编码各位数字之和就是逆序数)
+template<size_t N>
+constexpr uint32_t rank_permutation_parity(const uint8_t* values, bool& odd, uint8_t base = 0) {
+    static_assert(N <= 12, "Permutation too large");
+    uint32_t rank = 0;
+    uint32_t used = 0;
+    uint32_t inversions = 0;
+    for (size_t i = 0; i < N; ++i) {
+        uint32_t v = values[i] - base;
+        uint32_t digit = v - static_cast<uint32_t>(std::popcount(used & ((1u << v) - 1)));
+        rank += digit * factorials[N - 1 - i];
+        inversions += digit;
+        used |= 1u << v;
+    }
+    odd = inversions & 1;
+    return rank;
+}
+
+// 有序选取 -> 坐标：values 为 K 个互不相同的槽位，取值范围 [0, SLOTS)
+// 与 Lehmer 编码相同，每一位的数字 = 尚未使用且小于当前值的槽位数，按 SLOTS, SLOTS-1, ... 进制组合
+// 坐标范围 [0, SLOTS! / (SLOTS-K)!)
+template<size_t K, size_t SLOTS>
+constexpr uint32_t rank_arrangement(const uint8_t* values) {
+    static_assert(K <= SLOTS && SLOTS <= 12, "Arrangement too large");
+    uint32_t rank = 0;
+    uint32_t used = 0;
+    for (size_t i = 0; i < K; ++i) {
+        uint32_t v = values[i];
+        uint32_t smaller_used = static_cast<uint32_t>(std::popcount(used & ((1u << v) - 1)));
+        rank = rank * static_cast<uint32_t>(SLOTS - i) + (v - smaller_used);
+        used |= 1u << v;
+    }
+    return rank;
+}
+
+// 坐标 -> 有序选取
+template<size_t K, size_t SLOTS>
+constexpr void unrank_arrangement(uint32_t rank, uint8_t* values) {
+    static_assert(K <= SLOTS && SLOTS <= 12, "Arrangement too large");
+    uint32_t digits[K] = {};
+    for (size_t i = K; i-- > 0;) {
+        digits[i] = rank % static_cast<uint32_t>(SLOTS - i);
+        rank /= static_cast<uint32_t>(SLOTS - i);
+    }
+    uint32_t available = (1u << SLOTS) - 1;
+    for (size_t i = 0; i < K; ++i) {
+        uint32_t v = select_bit(available, digits[i]);
+        available &= ~(1u << v);
+        values[i] = static_cast<uint8_t>(v);
+    }
+}
+
+// 组合 -> 坐标
+// mask 的低 SLOTS 位中恰有 K 位置位；按槽位从小到大，每个被选中的槽位 i 累加 C(SLOTS-1-i, k)
+template<int K, int SLOTS = 12>
+constexpr uint16_t rank_combination(uint32_t mask) {
+    uint16_t rank = 0;
+    int k = K;
+    for (int i = 0; i < SLOTS && k > 0; ++i) {
+        if ((mask >> i) & 1) {
+            rank += C_nk_table[SLOTS - 1 - i][k];
+            --k;
+        }
+    }
+    return rank;
+}
+
+// 坐标 -> 组合 (返回选中槽位的位掩码)
+template<int K, int SLOTS = 12>
+constexpr uint32_t unrank_combination(uint16_t rank) {
+    uint32_t mask = 0;
+    int k = K;
+    for (int i = 0; i < SLOTS && k > 0; ++i) {
+        if (rank >= C_nk_table[SLOTS - 1 - i][k]) {
+            rank -= C_nk_table[SLOTS - 1 - i][k];
+            mask |= 1u << i;
+            --k;
+        }
+    }
+    return mask;
+}
+
+// 朝向 -> 坐标：前 N-1 个朝向按 BASE 进制编码，最后一个由总和推断
+template<size_t N, uint8_t BASE>
+constexpr uint16_t rank_orientation(const uint8_t* ori) {
+    uint16_t coord = 0;
+    for (size_t i = 0; i + 1 < N; ++i) {
+        coord = coord * BASE + ori[i];
+    }
+    return coord;
+}
+
+// 坐标 -> 朝向：最后一个朝向使总和能被 BASE 整除
+template<size_t N, uint8_t BASE>
+constexpr void unrank_orientation(uint16_t coord, uint8_t* ori) {
+    int parity = 0;
+    for (size_t i = N - 1; i-- > 0;) {
+        ori[i] = coord % BASE;
+        coord /= BASE;
+        parity += ori[i];
+    }
+    ori[N - 1] = (BASE - parity % BASE) % BASE;
+}
+
+} // namespace Codec
+
+} // namespace RubiksSolver
+
+#endif // CODEC_H
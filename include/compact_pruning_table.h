@@ -0,0 +1,41 @@
+#ifndef COMPACT_PRUNING_TABLE_H
+#define COMPACT_PRUNING_TABLE_H
+
+#include "table_residency.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 运行时选择存储方式的剪枝表：每项1字节，或每项4位 (两项共用一个字节，低4位在前)
+// 组合剪枝表的距离都不超过15，可以无损压缩
+class CompactPruningTable {
+public:
+    // 从逐项的距离构建，huge_pages 时放入大页
+    void assign(const std::vector<uint8_t>& distances, bool packed, bool huge_pages);
+
+    inline uint8_t operator[](size_t i) const {
+        if (packed_) {
+            return (data_[i >> 1] >> ((i & 1) << 2)) & 0x0F;
+        }
+        return data_[i];
+    }
+
+    inline bool is_bound() const { return data_ != nullptr; }
+    // 原始数据 (packed 时每字节两项)，供批量查询使用
+    inline const uint8_t* data() const { return data_; }
+    inline bool packed() const { return packed_; }
+    inline size_t bytes() const { return bytes_; }
+    inline Residency residency() const { return region_.residency(); }
+
+private:
+    ResidentRegion region_;
+    const uint8_t* data_ = nullptr;
+    size_t bytes_ = 0;
+    bool packed_ = false;
+};
+
+} // namespace RubiksSolver
+
+#endif // COMPACT_PRUNING_TABLE_H
@@ -2,11 +2,11 @@
 #define COORDINATE_H
 
 #include "cube.h"
+#include "codec.h"
 #include <cstdint>
-#include <span>
-#include <ranges>
 #include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 #include <cassert>
 
@@ -15,60 +15,25 @@ namespace RubiksSolver {
 
 using Coord = uint16_t;
 
-// C(n, k) 查询表
-constexpr std::array<std::array<int, 13>, 13> precompute_combinations() {
-    std::array<std::array<int, 13>, 13> table{};
-    for (int n = 0; n < 13; ++n) {
-        table[n][0] = 1;
-        for (int k = 1; k <= n; ++k) {
-            table[n][k] = table[n - 1][k - 1] + table[n - 1][k];
-        }
-    }
-    return table;
-}
-constexpr std::array<std::array<int, 13>, 13> C_nk_table = precompute_combinations();
-
-constexpr std::array<int, 9> factorials = {1, 1, 2, 6, 24, 120, 720, 5040, 40320};
-
+// 第一阶段坐标：纯值类型，不携带魔方状态
 struct Phase1Coord {
-    
+
 public:
-    Phase1Coord() 
-    : corner_orientation(0), edge_orientation(0), uds_edge_position(0) {}
-    
-    Phase1Coord(const Cube& cube) {
-        this->cube = cube;
-        encode_from_cube(cube);
-    }
-    
-    Phase1Coord(Coord co, Coord eo, Coord uds) 
-    : cube(Cube()), corner_orientation(co), edge_orientation(eo), uds_edge_position(uds) { decode_to_cube(cube); }
-    // 应用一次转动,修改内部魔方状态，并更新坐标
-    void apply_move(Move m) {
-        cube.apply_move(m);
-        encode_from_cube(cube);
-    }
-    // 设置角块朝向坐标，并更新魔方状态
-    void set_corner_orientation(Coord co) {
-        corner_orientation = co;
-        decode_corner_orientation(cube);
-    }
-    
-    void set_edge_orientation(Coord eo) {
-        edge_orientation = eo;
-        decode_edge_orientation(cube);
-    }
-    
-    void set_ud_slice_edges(Coord uds) {
-        uds_edge_position = uds;
-        decode_ud_slice_position(cube);
-    }
-    
-    inline Coord get_corner_orientation() const { return corner_orientation; }
-    inline Coord get_edge_orientation() const { return edge_orientation; }
-    inline Coord get_ud_slice_position() const { return uds_edge_position; }
+    constexpr Phase1Coord() = default;
+
+    constexpr Phase1Coord(const Cube& cube)
+    : corner_orientation(encode_corner_orientation(cube)),
+      edge_orientation(encode_edge_orientation(cube)),
+      uds_edge_position(encode_ud_slice_position(cube)) {}
+
+    constexpr Phase1Coord(Coord co, Coord eo, Coord uds)
+    : corner_orientation(co), edge_orientation(eo), uds_edge_position(uds) {}
 
-    inline bool is_solved() const {
+    constexpr Coord get_corner_orientation() const { return corner_orientation; }
+    constexpr Coord get_edge_orientation() const { return edge_orientation; }
+    constexpr Coord get_ud_slice_position() const { return uds_edge_position; }
+
+    constexpr bool is_solved() const {
         return corner_orientation == 0 && edge_orientation == 0 && uds_edge_position == 0;
     }
 
@@ -79,32 +44,28 @@ public:
         Move::F1, Move::F2, Move::F3, Move::B1, Move::B2, Move::B3
     };
 
-private:
-    // 设置角块朝向坐标编码
-    void encode_corner_orientation(const Cube& cube);
-    // 设置棱块朝向坐标编码
-    void encode_edge_orientation(const Cube& cube);
-    // 设置UDSlice棱块位置坐标编码
-    void encode_ud_slice_position(const Cube& cube);
-    void encode_from_cube(const Cube& cube) {
-        encode_corner_orientation(cube);
-        encode_edge_orientation(cube);
-        encode_ud_slice_position(cube);
+    // 角块朝向坐标编码 (前7个角块的朝向按3进制编码，最后一个是推断出来的)
+    static constexpr Coord encode_corner_orientation(const Cube& cube) {
+        uint8_t ori[8] = {};
+        for (int i = 0; i < 8; ++i) ori[i] = cube.corners[i].orientation;
+        return Codec::rank_orientation<8, 3>(ori);
     }
-
-    // 解码角块朝向坐标
-    void decode_corner_orientation(Cube& cube);
-    // 解码棱块朝向坐标
-    void decode_edge_orientation(Cube& cube);
-    // 解码UDSlice棱块位置坐标
-    void decode_ud_slice_position(Cube& cube);
-    void decode_to_cube(Cube& cube) {
-        decode_corner_orientation(cube);
-        decode_edge_orientation(cube);
-        decode_ud_slice_position(cube);
+    // 棱块朝向坐标编码 (前11个棱块的朝向按2进制编码)
+    static constexpr Coord encode_edge_orientation(const Cube& cube) {
+        uint8_t ori[12] = {};
+        for (int i = 0; i < 12; ++i) ori[i] = cube.edges[i].orientation;
+        return Codec::rank_orientation<12, 2>(ori);
+    }
+    // UDSlice棱块位置坐标编码 (4个中层棱块所在槽位的组合)
+    static constexpr Coord encode_ud_slice_position(const Cube& cube) {
+        uint32_t mask = 0;
+        for (int i = 0; i < 12; ++i) {
+            mask |= static_cast<uint32_t>(cube.edges[i].piece >= 8) << i;
+        }
+        return Codec::rank_combination<4>(mask);
     }
 
-    Cube cube;
+private:
     // 角块朝向坐标 (0-2186)
     Coord corner_orientation = 0;
     // 棱块朝向坐标 (0-2047)
@@ -113,43 +74,25 @@ private:
     Coord uds_edge_position = 0;
 };
 
+// 第二阶段坐标：纯值类型，只对G1子群内的魔方有意义 (从魔方编码时，不在G1中则抛出 std::invalid_argument)
 struct Phase2Coord {
 
 public:
-    Phase2Coord() 
-    : cube(Cube()), corner_permutation(0), ud_edge_permutation(0), slice_edge_permutation(0) {}
-    
-    Phase2Coord(const Cube& cube) {
-        this->cube = cube;
-        encode_from_cube(cube);
-    }
+    constexpr Phase2Coord() = default;
 
-    Phase2Coord(Coord cp, Coord udep, Coord sep) 
-    : cube(Cube()), corner_permutation(cp), ud_edge_permutation(udep), slice_edge_permutation(sep) { decode_to_cube(cube); }
+    constexpr Phase2Coord(const Cube& cube)
+    : corner_permutation(encode_corner_permutation(cube)),
+      ud_edge_permutation(encode_ud_edge_permutation(cube)),
+      slice_edge_permutation(encode_slice_edge_permutation(cube)) {}
 
-    void apply_move(Move m) {
-        cube.apply_move(m);
-        encode_from_cube(cube);
-    }
+    constexpr Phase2Coord(Coord cp, Coord udep, Coord sep)
+    : corner_permutation(cp), ud_edge_permutation(udep), slice_edge_permutation(sep) {}
 
-    void set_corner_permutation(Coord cp) {
-        corner_permutation = cp;
-        decode_corner_permutation(cube);
-    }
-    void set_ud_edge_permutation(Coord udep) {
-        ud_edge_permutation = udep;
-        decode_ud_edge_permutation(cube);
-    }
-    void set_slice_edge_permutation(Coord sep) {
-        slice_edge_permutation = sep;
-        decode_slice_edge_permutation(cube);
-    }
+    constexpr Coord get_corner_permutation() const { return corner_permutation; }
+    constexpr Coord get_ud_edge_permutation() const { return ud_edge_permutation; }
+    constexpr Coord get_slice_edge_permutation() const { return slice_edge_permutation; }
 
-    inline Coord get_corner_permutation() const { return corner_permutation; }
-    inline Coord get_ud_edge_permutation() const { return ud_edge_permutation; }
-    inline Coord get_slice_edge_permutation() const { return slice_edge_permutation; }
-
-    inline bool is_solved() const {
+    constexpr bool is_solved() const {
         return corner_permutation == 0 && ud_edge_permutation == 0 && slice_edge_permutation == 0;
     }
 
@@ -159,104 +102,261 @@ public:
         Move::L3, Move::R3, Move::F3, Move::B3
     };
 
-private:
     // 编码角块排列坐标
-    void encode_corner_permutation(const Cube& cube) {
-        this->corner_permutation = encode_perm<Coord, Corner>(cube.corners);
+    static constexpr Coord encode_corner_permutation(const Cube& cube) {
+        uint8_t pieces[8] = {};
+        for (int i = 0; i < 8; ++i) pieces[i] = cube.corners[i].piece;
+        return Codec::rank_permutation<8>(pieces);
     }
     // 编码UD层棱块排列坐标
-    void encode_ud_edge_permutation(const Cube& cube) {
-        this->ud_edge_permutation = encode_perm<Coord, Edge>(std::span(cube.edges).subspan(0, 8));
+    static constexpr Coord encode_ud_edge_permutation(const Cube& cube) {
+        uint8_t pieces[8] = {};
+        for (int i = 0; i < 8; ++i) {
+            pieces[i] = cube.edges[i].piece;
+            if (pieces[i] >= 8) throw std::invalid_argument("Cube is not in G1: slice edge in UD layer");
+        }
+        return Codec::rank_permutation<8>(pieces);
     }
     // 编码中层棱块排列坐标
-    void encode_slice_edge_permutation(const Cube& cube) {
-        this->slice_edge_permutation = encode_perm<Coord, Edge>(std::span(cube.edges).subspan(8, 4));
+    static constexpr Coord encode_slice_edge_permutation(const Cube& cube) {
+        uint8_t pieces[4] = {};
+        for (int i = 0; i < 4; ++i) {
+            pieces[i] = cube.edges[8 + i].piece;
+            if (pieces[i] < 8) throw std::invalid_argument("Cube is not in G1: UD edge in slice layer");
+        }
+        return Codec::rank_permutation<4>(pieces, 8);
+    }
+
+private:
+    // 角块排列坐标 (0-40319)(8!)
+    Coord corner_permutation = 0;
+    // UD层棱块排列坐标 (0-40319)(8!)
+    Coord ud_edge_permutation = 0;
+    // 中层棱块排列坐标 (0-23)(4!)
+    Coord  slice_edge_permutation = 0;
+};
+
+// 3个块的位置坐标 -> 各自所在的槽位 (编译期生成，到达G1时避免逐位解码)
+template<size_t SLOTS>
+constexpr auto make_positions_decode_table() {
+    std::array<std::array<uint8_t, 3>, SLOTS * (SLOTS - 1) * (SLOTS - 2)> table{};
+    for (uint32_t i = 0; i < table.size(); ++i) {
+        Codec::unrank_arrangement<3, SLOTS>(i, table[i].data());
+    }
+    return table;
+}
+inline constexpr auto CORNER_POSITIONS_DECODE = make_positions_decode_table<8>();
+inline constexpr auto EDGE_POSITIONS_DECODE = make_positions_decode_table<12>();
+
+// 第一阶段中追踪的第二阶段坐标：纯值类型，对任意魔方都有定义
+// 第二阶段的排列坐标只在G1子群内有意义，这里改为记录几组块 (每组3个) 所在的槽位，
+// 它们在所有18种转动下都能查表更新：角块 0-2、3-5 在8个角块槽位中的位置，
+// 棱块 0-2、3-5、8-10 在12个棱块槽位中的位置，以及角块排列的奇偶性
+// 到达G1时，其余的块 (角块6、7，棱块6、7、11) 只能位于剩余的槽位，顺序由奇偶性决定
+struct Phase2Tracking {
+    // 3个角块在8个槽位中的位置坐标 (8*7*6)，3个棱块在12个槽位中的位置坐标 (12*11*10)
+    static constexpr Coord CORNER_POSITIONS = 336;
+    static constexpr Coord EDGE_POSITIONS = 1320;
+
+    constexpr Phase2Tracking() : Phase2Tracking(Cube{}) {}
+
+    constexpr Phase2Tracking(const Cube& cube)
+    : corner_positions{encode_corner_positions(cube, 0), encode_corner_positions(cube, 3)},
+      edge_positions{encode_edge_positions(cube, 0), encode_edge_positions(cube, 3), encode_edge_positions(cube, 8)},
+      corner_parity(encode_corner_parity(cube)) {}
+
+    // 一次转动；corner_next/edge_next 为位置坐标的转动 (下面的坐标层面转动函数，或者查移动表)
+    template<typename CornerNext, typename EdgeNext>
+    constexpr Phase2Tracking after(Move m, CornerNext&& corner_next, EdgeNext&& edge_next) const {
+        Phase2Tracking next = *this;
+        for (auto& positions : next.corner_positions) positions = corner_next(positions, m);
+        for (auto& positions : next.edge_positions) positions = edge_next(positions, m);
+        // 90度转动是角块的一个4-循环 (奇置换)，180度转动是两个对换
+        next.corner_parity ^= static_cast<int>(m) % 3 != 2;
+        return next;
     }
-    void encode_from_cube(const Cube& cube) {
-        encode_corner_permutation(cube);
-        encode_ud_edge_permutation(cube);
-        encode_slice_edge_permutation(cube);
+
+    // 第二阶段坐标，只对G1子群内的魔方有意义
+    constexpr Phase2Coord to_phase2() const {
+        uint8_t corners[8] = {};
+        const uint32_t used_corners = place(CORNER_POSITIONS_DECODE[corner_positions[0]], 0, corners)
+                                    | place(CORNER_POSITIONS_DECODE[corner_positions[1]], 3, corners);
+        const Coord cp = rank_with_pair<8>(corners, used_corners, 6, corner_parity);
+
+        uint8_t edges[12] = {};
+        const uint32_t used_ud = place(EDGE_POSITIONS_DECODE[edge_positions[0]], 0, edges)
+                               | place(EDGE_POSITIONS_DECODE[edge_positions[1]], 3, edges);
+        const uint32_t used_slice = place(EDGE_POSITIONS_DECODE[edge_positions[2]], 8, edges);
+        assert((used_ud & SLICE_SLOTS) == 0 && (used_slice & ~SLICE_SLOTS) == 0 && "Cube is not in G1");
+        edges[std::countr_zero(~used_slice & SLICE_SLOTS)] = 11;
+        // 棱块排列与角块排列的奇偶性相同；G1中它是UD层和中层两个排列的奇偶性之和
+        bool slice_parity = false;
+        const Coord sep = static_cast<Coord>(Codec::rank_permutation_parity<4>(edges + 8, slice_parity, 8));
+        const Coord udep = rank_with_pair<8>(edges, used_ud, 6, corner_parity != slice_parity);
+        return Phase2Coord(cp, udep, sep);
     }
 
-    void decode_corner_permutation(Cube& cube) {
-        decode_perm<Corner, Coord>(cube.corners, corner_permutation);
+    constexpr bool operator==(const Phase2Tracking&) const = default;
+
+    // 块 first_piece 到 first_piece+2 所在槽位的位置坐标
+    static constexpr Coord encode_corner_positions(const Cube& cube, uint8_t first_piece) {
+        uint8_t slots[3] = {};
+        for (uint8_t i = 0; i < 8; ++i) {
+            const uint8_t piece = cube.corners[i].piece;
+            if (piece >= first_piece && piece < first_piece + 3) slots[piece - first_piece] = i;
+        }
+        return static_cast<Coord>(Codec::rank_arrangement<3, 8>(slots));
     }
-    void decode_ud_edge_permutation(Cube& cube) {
-        decode_perm<Edge, Coord>(std::span(cube.edges).subspan(0, 8), ud_edge_permutation);
+    static constexpr Coord encode_edge_positions(const Cube& cube, uint8_t first_piece) {
+        uint8_t slots[3] = {};
+        for (uint8_t i = 0; i < 12; ++i) {
+            const uint8_t piece = cube.edges[i].piece;
+            if (piece >= first_piece && piece < first_piece + 3) slots[piece - first_piece] = i;
+        }
+        return static_cast<Coord>(Codec::rank_arrangement<3, 12>(slots));
     }
-    void decode_slice_edge_permutation(Cube& cube) {
-        decode_perm<Edge, Coord>(std::span(cube.edges).subspan(8, 4), slice_edge_permutation);
+    static constexpr bool encode_corner_parity(const Cube& cube) {
+        uint8_t pieces[8] = {};
+        for (int i = 0; i < 8; ++i) pieces[i] = cube.corners[i].piece;
+        bool odd = false;
+        Codec::rank_permutation_parity<8>(pieces, odd);
+        return odd;
     }
-    void decode_to_cube(Cube& cube) {
-        decode_corner_permutation(cube);
-        decode_ud_edge_permutation(cube);
-        decode_slice_edge_permutation(cube);
+
+private:
+    static constexpr uint32_t SLICE_SLOTS = 0xF00;
+
+    // 把块 first_piece 到 first_piece+2 放入解码得到的槽位，返回这些槽位的位掩码
+    static constexpr uint32_t place(const std::array<uint8_t, 3>& slots, uint8_t first_piece, uint8_t* pieces) {
+        uint32_t used = 0;
+        for (uint8_t i = 0; i < 3; ++i) {
+            pieces[slots[i]] = first_piece + i;
+            used |= 1u << slots[i];
+        }
+        return used;
     }
 
-    
-    // 排列编码为坐标
-    template<typename R, HasPiece T>
-    R encode_perm(std::span<const T> perm) {
+    // 前 N 个槽位中剩下的两个空位放入块 first_piece 和 first_piece+1，返回奇偶性等于 parity 的排列的编码
+    // 先按从小到大的顺序放入：交换这两个块只让前一个空位的 Lehmer 数字加1，编码加上对应的阶乘
+    template<size_t N>
+    static constexpr Coord rank_with_pair(uint8_t* pieces, uint32_t used, uint8_t first_piece, bool parity) {
+        // free 中恰有两位置位；取模只是让编译器确认下标不会越界
+        const uint32_t free = ~used & ((1u << N) - 1);
+        const int first = std::countr_zero(free) % N;
+        pieces[first] = first_piece;
+        pieces[std::countr_zero(free & (free - 1)) % N] = first_piece + 1;
+        bool odd = false;
+        uint32_t rank = Codec::rank_permutation_parity<N>(pieces, odd);
+        rank += (odd != parity) * factorials[N - 1 - first];
+        return static_cast<Coord>(rank);
+    }
 
-        R rank = 0;
+    std::array<Coord, 2> corner_positions{};
+    std::array<Coord, 3> edge_positions{};
+    bool corner_parity = false;
+};
 
-        int n = static_cast<int>(perm.size());
-        std::vector<uint8_t> available_pieces;
-        if (n == 8) {
-            available_pieces = {0, 1, 2, 3, 4, 5, 6, 7};
-        } else {
-            available_pieces = {8, 9, 10, 11};
-        }
+// 坐标层面的转动：直接对朝向数组/槽位做置换，不经过完整的魔方
+// 用于生成移动表 (编译期和运行时通用)，编码方式与上面的坐标类型完全一致
 
-        for (int i = 0; i < n; ++i) {
-            // 找到当前piece在可用列表中的索引
-            auto it = std::find_if(available_pieces.begin(), available_pieces.end(), [&](const uint8_t& piece) { return piece == perm[i].piece; });
-            if (it == available_pieces.end()) {
-                throw std::invalid_argument("Piece not found in available pieces.");
-            }
-            int index = std::distance(available_pieces.begin(), it);
-            
-            // 累加到rank中
-            rank += index * factorials[n - 1 - i];
-            
-            // 从可用列表中移除
-            available_pieces.erase(it);
-        }
-        // rank 小于40320
-        if (rank >= 40320) {
-            throw std::out_of_range("Permutation rank exceeds maximum value for 8 pieces.");
-        }
-        return rank;
+// 按转动定义置换4个受影响的槽位
+constexpr void permute_slots(uint8_t* slots, const MoveMap& map) {
+    uint8_t temp[4] = {};
+    for (int i = 0; i < 4; ++i) temp[i] = slots[map.affected_indices[i]];
+    for (int i = 0; i < 4; ++i) slots[map.target_map[i]] = temp[i];
+}
+
+// 角块朝向坐标 (0-2186) 的一次转动
+constexpr Coord corner_orientation_move(Coord co, Move m) {
+    const MoveDefinition& move_def = ALL_MOVES_DATA[static_cast<int>(m)];
+    uint8_t ori[8] = {};
+    Codec::unrank_orientation<8, 3>(co, ori);
+
+    permute_slots(ori, move_def.corner_permutation);
+    for (int i = 0; i < 4; ++i) {
+        uint8_t idx = move_def.corner_permutation.affected_indices[i];
+        ori[idx] = (ori[idx] + move_def.corner_orientation_changes[i]) % 3;
     }
+    return Codec::rank_orientation<8, 3>(ori);
+}
 
-    // 解码坐标为排列
-    template<HasPiece T, typename R>
-    void decode_perm(std::span<T> perm, R rank) const {
-        int n = static_cast<int>(perm.size());
-        std::vector<uint8_t> available_pieces;
-        if (n == 8) {
-            available_pieces = {0, 1, 2, 3, 4, 5, 6, 7};
-        } else {
-            available_pieces = {8, 9, 10, 11};
-        }
+// 棱块朝向坐标 (0-2047) 的一次转动
+constexpr Coord edge_orientation_move(Coord eo, Move m) {
+    const MoveDefinition& move_def = ALL_MOVES_DATA[static_cast<int>(m)];
+    uint8_t ori[12] = {};
+    Codec::unrank_orientation<12, 2>(eo, ori);
+
+    permute_slots(ori, move_def.edge_permutation);
+    for (int i = 0; i < 4; ++i) {
+        ori[move_def.edge_permutation.affected_indices[i]] ^= move_def.edge_orientation_changes[i];
+    }
+    return Codec::rank_orientation<12, 2>(ori);
+}
+
+// UDSlice棱块位置坐标 (0-494) 的一次转动
+constexpr Coord ud_slice_position_move(Coord uds, Move m) {
+    const MoveDefinition& move_def = ALL_MOVES_DATA[static_cast<int>(m)];
+    uint32_t mask = Codec::unrank_combination<4>(uds);
+    uint8_t occupied[12] = {};
+    for (int i = 0; i < 12; ++i) occupied[i] = (mask >> i) & 1;
 
-        for (int i = 0; i < n; ++i) {
-            int index = rank / factorials[n - 1 - i];
-            perm[i].piece = available_pieces[index];
-            available_pieces.erase(available_pieces.begin() + index);
-            rank %= factorials[n - 1 - i];
+    permute_slots(occupied, move_def.edge_permutation);
+
+    mask = 0;
+    for (int i = 0; i < 12; ++i) mask |= static_cast<uint32_t>(occupied[i]) << i;
+    return Codec::rank_combination<4>(mask);
+}
+
+// 角块排列坐标 (0-40319) 的一次转动，对所有18种转动都有意义
+constexpr Coord corner_permutation_move(Coord cp, Move m) {
+    uint8_t pieces[8] = {};
+    Codec::unrank_permutation<8>(cp, pieces);
+    permute_slots(pieces, ALL_MOVES_DATA[static_cast<int>(m)].corner_permutation);
+    return Codec::rank_permutation<8>(pieces);
+}
+
+// UD层棱块排列坐标 (0-40319) 的一次转动，只对第二阶段的转动有意义
+constexpr Coord ud_edge_permutation_move(Coord udep, Move m) {
+    uint8_t pieces[12] = {0, 0, 0, 0, 0, 0, 0, 0, 8, 9, 10, 11};
+    Codec::unrank_permutation<8>(udep, pieces);
+    permute_slots(pieces, ALL_MOVES_DATA[static_cast<int>(m)].edge_permutation);
+    return Codec::rank_permutation<8>(pieces);
+}
+
+// 中层棱块排列坐标 (0-23) 的一次转动，只对第二阶段的转动有意义
+constexpr Coord slice_edge_permutation_move(Coord sep, Move m) {
+    uint8_t pieces[12] = {0, 1, 2, 3, 4, 5, 6, 7};
+    Codec::unrank_permutation<4>(sep, pieces + 8, 8);
+    permute_slots(pieces, ALL_MOVES_DATA[static_cast<int>(m)].edge_permutation);
+    return Codec::rank_permutation<4>(pieces + 8, 8);
+}
+
+// 一组3个块所在槽位的位置坐标的一次转动：位于受影响槽位的块随转动移到目标槽位
+template<size_t SLOTS>
+constexpr Coord positions_move(Coord positions, const MoveMap& map) {
+    uint8_t at[3] = {};
+    Codec::unrank_arrangement<3, SLOTS>(positions, at);
+    for (auto& slot : at) {
+        for (int i = 0; i < 4; ++i) {
+            if (slot == map.affected_indices[i]) {
+                slot = map.target_map[i];
+                break;
+            }
         }
     }
+    return static_cast<Coord>(Codec::rank_arrangement<3, SLOTS>(at));
+}
 
-    Cube cube;
-    // 角块排列坐标 (0-40319)(8!)
-    Coord corner_permutation = 0;
-    // UD层棱块排列坐标 (0-40319)(8!)
-    Coord ud_edge_permutation = 0;
-    // 中层棱块排列坐标 (0-23)(4!)
-    Coord  slice_edge_permutation = 0;
-};
+// 3个角块的位置坐标 (0-335) 的一次转动，对所有18种转动都有意义
+constexpr Coord corner_positions_move(Coord positions, Move m) {
+    return positions_move<8>(positions, ALL_MOVES_DATA[static_cast<int>(m)].corner_permutation);
+}
+
+// 3个棱块的位置坐标 (0-1319) 的一次转动，对所有18种转动都有意义
+constexpr Coord edge_positions_move(Coord positions, Move m) {
+    return positions_move<12>(positions, ALL_MOVES_DATA[static_cast<int>(m)].edge_permutation);
+}
 
 } // namespace RubiksSolver
 
-#endif // COORDINATE_H
\ No newline at end of file
+#endif // COORDINATE_H
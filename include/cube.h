@@ -2,8 +2,11 @@
 #define CUBE_H
 
 #include "moves.h"
+#include "move_data.h"
+#include <stdexcept>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <array>
 #include <cstdint>
 #include <concepts>
@@ -63,26 +66,73 @@ concept HasPiece = requires(T t) {
 };
 // 角块
 struct Corner { 
-    Piece piece : 3;       // 0-7，只需要3位
-    Orientation orientation : 2; // 0-2，只需要2位
-    uint8_t _reserved : 3;   // 保留位
+    Piece piece : 3 = 0;       // 0-7，只需要3位
+    Orientation orientation : 2 = 0; // 0-2，只需要2位
+    uint8_t _reserved : 3 = 0;   // 保留位
 };
 // 棱块
 struct Edge { 
-    Piece piece : 4;       // 0-11，需要4位
-    Orientation orientation : 1; // 0-1，只需要1位
-    uint8_t _reserved : 3;   // 保留位
+    Piece piece : 4 = 0;       // 0-11，需要4位
+    Orientation orientation : 1 = 0; // 0-1，只需要1位
+    uint8_t _reserved : 3 = 0;   // 保留位
 };
 
 class Cube {
 public:
-    Cube();
+    constexpr Cube() {
+        // 初始化角块
+        for (uint8_t i = 0; i < 8; ++i) {
+            corners[i].piece = i;
+            corners[i].orientation = 0;
+        }
+        // 初始化棱块
+        for (uint8_t i = 0; i < 12; ++i) {
+            edges[i].piece = i;
+            edges[i].orientation = 0;
+        }
+    }
 
     // 从打乱序列构造
     static Cube from_scramble(const std::string& scramble);
+
+    // 从54个色块的字符串构造 (按 U R F D L B 面的顺序，每面9个色块逐行排列)
+    // 每个面的中心色块决定该面使用的字符，任意6种不同的字符都可以
+    // 不做任何堆分配；无法复原的状态会抛出 std::invalid_argument
+    static Cube from_facelets(std::string_view facelets);
+
+    // 从块数组构造：每个槽位上的块编号和朝向
+    // 会检查块是否唯一、角块朝向之和、棱块朝向之和以及排列奇偶性
+    static Cube from_pieces(const std::array<uint8_t, 8>& corner_pieces,
+                            const std::array<uint8_t, 8>& corner_orientations,
+                            const std::array<uint8_t, 12>& edge_pieces,
+                            const std::array<uint8_t, 12>& edge_orientations);
+
+    // 54个字符且不含空格的输入视为色块字符串，否则按打乱序列解析
+    static Cube parse(const std::string& text);
+
+    // 转换为 from_facelets 接受的54个字符 (使用 U R F D L B 作为面字符)
+    std::string to_facelets() const;
     
     // 应用一次转动
-    void apply_move(Move m);
+    constexpr void apply_move(Move m) {
+        if (m >= Move::COUNT)   
+            throw std::out_of_range("Invalid move");
+        // 1. 从数据表中获取当前转动的定义
+        const auto& move_def = ALL_MOVES_DATA[static_cast<int>(m)];
+
+        // 2. 应用置换
+        cycle_pieces(corners, move_def.corner_permutation.affected_indices, move_def.corner_permutation.target_map);
+        cycle_pieces(edges, move_def.edge_permutation.affected_indices, move_def.edge_permutation.target_map);
+
+        // 3. 应用朝向变化
+        for (int i = 0; i < 4; ++i) {
+            uint8_t c_idx = move_def.corner_permutation.affected_indices[i];
+            corners[c_idx].orientation = (corners[c_idx].orientation + move_def.corner_orientation_changes[i]) % 3;
+
+            uint8_t e_idx = move_def.edge_permutation.affected_indices[i];
+            edges[e_idx].orientation = (edges[e_idx].orientation + move_def.edge_orientation_changes[i]) % 2;
+        }
+    }
     
     // 应用一个转动序列
     void apply_sequence(const std::vector<Move>& sequence);
@@ -107,8 +157,14 @@ public:
     friend class Coordinate;
     friend class Phase1Coord;
     friend class Phase2Coord;
+    friend struct Phase2Tracking;
+    // 紧凑表示需要直接读写块数组
+    friend class PackedCube;
 
 private:
+    // 对块数组做一次遍历，检查是否为可复原的合法状态，否则抛出 std::invalid_argument
+    void validate() const;
+
     std::array<Corner, 8> corners;
     std::array<Edge, 12> edges;
 };
@@ -0,0 +1,36 @@
+#ifndef EMBEDDED_TABLES_H
+#define EMBEDDED_TABLES_H
+
+#include <cstddef>
+
+// 构建时由 table_generator 生成的第二阶段大型移动表和剪枝表
+// 通过 .incbin 链接进可执行文件的只读段 (.rodata.rubiks_tables)，启动时无需任何I/O或计算
+// 仅在定义了 RUBIKS_EMBEDDED_TABLES 时可用 (CMake选项 EMBED_TABLES)
+#ifdef RUBIKS_EMBEDDED_TABLES
+
+#define RUBIKS_DECLARE_EMBEDDED_TABLE(name) \
+    extern "C" const unsigned char rubiks_embedded_##name[]; \
+    extern "C" const unsigned char rubiks_embedded_##name##_end[];
+
+RUBIKS_DECLARE_EMBEDDED_TABLE(cp_move_table)
+RUBIKS_DECLARE_EMBEDDED_TABLE(udep_move_table)
+RUBIKS_DECLARE_EMBEDDED_TABLE(cp_pruning_table)
+RUBIKS_DECLARE_EMBEDDED_TABLE(udep_pruning_table)
+
+namespace RubiksSolver {
+
+struct EmbeddedTable {
+    const unsigned char* begin;
+    const unsigned char* end;
+
+    inline std::size_t size() const { return static_cast<std::size_t>(end - begin); }
+};
+
+} // namespace RubiksSolver
+
+#define RUBIKS_EMBEDDED_TABLE(name) \
+    ::RubiksSolver::EmbeddedTable{rubiks_embedded_##name, rubiks_embedded_##name##_end}
+
+#endif // RUBIKS_EMBEDDED_TABLES
+
+#endif // EMBEDDED_TABLES_H
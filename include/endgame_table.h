@@ -0,0 +1,79 @@
+#ifndef ENDGAME_TABLE_H
+#define ENDGAME_TABLE_H
+
+#include "moves.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 终局数据库的扁平存储：开放寻址 (线性探测) 哈希表，每个槽16字节
+// 不含指针，可以整体放进大页或共享内存，由其他进程直接只读使用
+// 内存布局：[64字节头：容量、状态数][容量个槽]
+class EndgameTable {
+public:
+    static constexpr size_t MAX_PATH_LENGTH = 7; // 第二阶段深度6的数据库，路径最长7步
+
+    struct Slot {
+        uint64_t key;    // 空槽为 EMPTY_KEY
+        uint8_t length;
+        std::array<Move, MAX_PATH_LENGTH> moves;
+    };
+    static_assert(sizeof(Slot) == 16);
+
+    // 容纳 entries 个状态所需的字节数 (负载因子不超过 3/4)
+    static size_t bytes_for(size_t entries);
+    // 在 memory (至少 bytes_for(db.size()) 字节) 中构建
+    static void build(const std::unordered_map<uint64_t, std::vector<Move>>& db, void* memory);
+
+    // 绑定已构建的只读数据 (不接管所有权)
+    void bind(const void* memory);
+
+    inline bool find(uint64_t key, std::vector<Move>& path) const {
+        size_t i = slot_index(key);
+        for (;;) {
+            const Slot& slot = slots_[i];
+            if (slot.key == key) {
+                path.assign(slot.moves.begin(), slot.moves.begin() + slot.length);
+                return true;
+            }
+            if (slot.key == EMPTY_KEY) return false;
+            i = (i + 1) & mask_;
+        }
+    }
+
+    // 预取 key 所在的槽，供随后的 find 使用
+    inline void prefetch(uint64_t key) const {
+        __builtin_prefetch(&slots_[slot_index(key)]);
+    }
+
+    inline size_t size() const { return entries_; }
+    inline size_t bytes() const { return HEADER_SIZE + (mask_ + 1) * sizeof(Slot); }
+
+private:
+    static constexpr uint64_t EMPTY_KEY = ~uint64_t{0}; // 键只用低48位
+    static constexpr size_t HEADER_SIZE = 64;
+
+    struct Header {
+        uint64_t capacity;
+        uint64_t entries;
+    };
+
+    static size_t capacity_for(size_t entries);
+
+    inline size_t slot_index(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    const Slot* slots_ = nullptr;
+    size_t mask_ = 0;
+    unsigned shift_ = 64;
+    size_t entries_ = 0;
+};
+
+} // namespace RubiksSolver
+
+#endif // ENDGAME_TABLE_H
@@ -0,0 +1,105 @@
+#ifndef IDA_FRONTIER_H
+#define IDA_FRONTIER_H
+
+#include "moves.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RubiksSolver {
+
+// IDA* 在相邻两轮迭代之间保留的前沿
+// 一轮迭代中因超出深度上限而被剪掉的子节点记为前沿节点；上限加一后的下一轮迭代
+// 只需从这些节点继续搜索，不必从根节点重新展开已经展开过的浅层节点
+// 前沿节点的路径前缀存成一棵父指针树 (相邻前沿节点共享前缀)，按路径编号引用
+// 节点数或路径树超出容量时放弃记录，调用方退回普通的 IDA* (每轮从根节点开始)
+class IdaFrontier {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = size_t{1} << 20;
+    static constexpr uint32_t NO_PATH = UINT32_MAX;
+
+    struct Node {
+        uint16_t x1, x2, x3;
+        Move last_move;
+        uint8_t depth;
+        uint8_t h;
+        uint32_t path_id; // 到父节点的路径，根节点的子节点为 NO_PATH
+    };
+    static_assert(sizeof(Node) == 16);
+
+    explicit IdaFrontier(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+
+    // 第一轮迭代从根节点开始 (由调用方压栈)，此时没有起始节点
+    // 取出本轮迭代的下一个起始节点，并把它的路径前缀写入 path[1 .. depth-1]；本轮起始节点用完时返回 false
+    bool next(Node& node, std::vector<Move>& path);
+
+    // 节点出栈时调用：深度不小于 depth 的路径前缀编号失效 (根节点深度为 0 时为 -1，record 中按 0 处理)
+    inline void leave(int depth) {
+        valid_depth_ = std::min(valid_depth_, depth - 1);
+    }
+
+    // 记录超出本轮上限的节点，path[1 .. depth-1] 是它的路径前缀
+    inline void record(const Node& node, const std::vector<Move>& path);
+
+    // 一轮迭代结束：记录完整时，下一轮从本轮的前沿继续；否则标记为溢出
+    void finish_iteration();
+
+    // 曾经溢出：之后的迭代应当从根节点开始
+    inline bool overflowed() const { return overflowed_; }
+    // 上一轮迭代没有剪掉任何节点，更深的迭代不会有新的节点
+    inline bool exhausted() const { return !overflowed_ && nodes_.empty(); }
+    // 本次搜索记录的前沿节点总数
+    inline uint64_t recorded() const { return recorded_; }
+
+private:
+    struct PathLink {
+        uint32_t parent;
+        Move move;
+    };
+
+    size_t capacity_;
+    // 本轮迭代的起始节点及其路径树
+    std::vector<Node> nodes_;
+    std::vector<PathLink> paths_;
+    size_t next_index_ = 0;
+    uint32_t last_parent_ = NO_PATH;
+    // 本轮迭代记录的前沿 (下一轮的起始节点)
+    std::vector<Node> next_nodes_;
+    std::vector<PathLink> next_paths_;
+    // 当前搜索路径上各深度前缀在 next_paths_ 中的编号，前 valid_depth_ 个有效
+    std::vector<uint32_t> prefix_ids_;
+    int valid_depth_ = 0;
+    bool full_ = false;
+    bool overflowed_ = false;
+    uint64_t recorded_ = 0;
+};
+
+inline void IdaFrontier::record(const Node& node, const std::vector<Move>& path) {
+    if (full_) {
+        return;
+    }
+    const int depth = node.depth;
+    // 调用前已对该节点调用过 leave()，valid_depth_ 不超过 depth - 1
+    if (next_nodes_.size() >= capacity_ || next_paths_.size() + depth > capacity_) {
+        full_ = true;
+        return;
+    }
+    if (prefix_ids_.size() < path.size()) {
+        prefix_ids_.resize(path.size());
+    }
+    prefix_ids_[0] = NO_PATH;
+    for (int k = std::max(valid_depth_, 0) + 1; k < depth; ++k) {
+        prefix_ids_[k] = static_cast<uint32_t>(next_paths_.size());
+        next_paths_.push_back({prefix_ids_[k - 1], path[k]});
+    }
+    valid_depth_ = depth - 1;
+    Node recorded = node;
+    recorded.path_id = prefix_ids_[depth - 1];
+    next_nodes_.push_back(recorded);
+    ++recorded_;
+}
+
+} // namespace RubiksSolver
+
+#endif // IDA_FRONTIER_H
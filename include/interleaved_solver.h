@@ -0,0 +1,91 @@
+#ifndef INTERLEAVED_SOLVER_H
+#define INTERLEAVED_SOLVER_H
+
+#include "cube.h"
+#include "moves.h"
+#include "solve_options.h"
+#include "table_manager.h"
+#include "two_phase_search.h"
+#include <array>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 在一个线程上交替执行多个求解的批量求解器
+// 每个求解是一个 C++20 协程：在查表之前先预取，然后挂起，调度器按轮转顺序恢复其他协程；
+// 轮到它时数据多半已经进入缓存，这样一个线程上同时有多个未完成的访存，不需要额外的线程
+// 总是在查询终局数据库 (随机访问的哈希表) 之前让出；table_yields 时还在读取当前节点的移动表行
+// 和子节点的剪枝表项之前让出 (表远大于缓存时才有收益)
+// 搜索与 Solver 的默认策略 (plain,noclamp,sorted,restart) 完全相同，得到的解也相同
+class InterleavedSolver {
+public:
+    static constexpr unsigned DEFAULT_WIDTH = 8;
+
+    struct Result {
+        std::vector<Move> solution;
+        std::string error; // 为空表示成功
+    };
+
+    // width 为同时进行的求解数，1 表示不交替 (只有预取和协程切换的开销)
+    explicit InterleavedSolver(const TableManager& tables, unsigned width = DEFAULT_WIDTH, bool table_yields = false,
+                               const SearchLimits& limits = SearchLimits::tuned());
+
+    // 求解所有状态，结果与输入一一对应；会先等待所有表就绪
+    std::vector<Result> solve(const std::vector<Cube>& cubes);
+
+    // 自构造以来展开的节点总数和协程挂起的次数
+    inline uint64_t nodes_expanded() const { return nodes_expanded_; }
+    inline uint64_t suspensions() const { return suspensions_; }
+    inline unsigned width() const { return width_; }
+    inline bool table_yields() const { return table_yields_; }
+
+    // 只支持默认的搜索策略开关 (深度上限可以任意)
+    static inline bool supports(const SolveOptions& options) { return TwoPhaseSearch::supports(options); }
+
+private:
+    class Task;
+    struct Yield;
+
+    using Node = TwoPhaseSearch::Node;
+    using Search = TwoPhaseSearch::Search;
+    using Status = TwoPhaseSearch::Status;
+
+    const TableManager& tables_;
+    unsigned width_;
+    bool table_yields_;
+    SearchLimits limits_;
+    TableManager::RawTables raw_{};
+    std::array<int, 2> probe_depth_{};
+    uint64_t nodes_expanded_ = 0;
+    uint64_t suspensions_ = 0;
+
+    // 等待恢复的协程，按挂起的先后顺序
+    std::deque<std::coroutine_handle<>> ready_;
+    const std::vector<Cube>* cubes_ = nullptr;
+    std::vector<Result>* results_ = nullptr;
+    size_t next_item_ = 0;
+
+    // 每个协程循环从队列中取状态求解，队列为空时结束
+    Task worker();
+    // 与 Solver::ida_next 相同：继续当前搜索，直到找到解或超出上限
+    template<uint8_t PHASE>
+    Task ida(Search& search);
+
+    template<uint8_t PHASE>
+    void start_search(Search& search, uint16_t x1, uint16_t x2, uint16_t x3, int limit, int first_depth);
+
+    template<uint8_t PHASE>
+    void prefetch_moves(const Node& node) const;
+    template<uint8_t PHASE>
+    void prefetch_pruning(uint16_t x1, uint16_t x2, uint16_t x3) const;
+    template<uint8_t PHASE>
+    uint8_t pruning(uint16_t x1, uint16_t x2, uint16_t x3) const;
+};
+
+} // namespace RubiksSolver
+
+#endif // INTERLEAVED_SOLVER_H
@@ -0,0 +1,276 @@
+#ifndef JSON_UTIL_H
+#define JSON_UTIL_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace RubiksSolver::Json {
+
+// 转义字符串中的特殊字符
+inline std::string escape(std::string_view text) {
+    std::string result;
+    result.reserve(text.size() + 2);
+    for (char c : text) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char* hex = "0123456789abcdef";
+                    result += "\\u00";
+                    result += hex[(c >> 4) & 0xF];
+                    result += hex[c & 0xF];
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+// 流式JSON写出器：自动处理逗号分隔，不做格式化缩进
+// 用法: w.begin_object(); w.key("n").value(1); w.end_object();
+class Writer {
+public:
+    explicit Writer(std::ostream& os) : os_(os) {}
+
+    Writer& begin_object() { separate(); os_ << '{'; first_.push_back(true); return *this; }
+    Writer& end_object() { first_.pop_back(); os_ << '}'; return *this; }
+    Writer& begin_array() { separate(); os_ << '['; first_.push_back(true); return *this; }
+    Writer& end_array() { first_.pop_back(); os_ << ']'; return *this; }
+
+    Writer& key(std::string_view k) {
+        separate();
+        os_ << '"' << escape(k) << "\":";
+        after_key_ = true;
+        return *this;
+    }
+
+    Writer& value(std::string_view v) { separate(); os_ << '"' << escape(v) << '"'; return *this; }
+    Writer& value(const char* v) { return value(std::string_view(v)); }
+    Writer& value(const std::string& v) { return value(std::string_view(v)); }
+    Writer& value(bool v) { separate(); os_ << (v ? "true" : "false"); return *this; }
+    Writer& value(double v) { separate(); os_ << std::setprecision(12) << v; return *this; }
+    Writer& value(int v) { separate(); os_ << v; return *this; }
+    Writer& value(int64_t v) { separate(); os_ << v; return *this; }
+    Writer& value(uint64_t v) { separate(); os_ << v; return *this; }
+    Writer& null() { separate(); os_ << "null"; return *this; }
+
+    template<typename T>
+    Writer& field(std::string_view k, const T& v) { return key(k).value(v); }
+
+private:
+    void separate() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (!first_.empty()) {
+            if (!first_.back()) os_ << ',';
+            first_.back() = false;
+        }
+    }
+
+    std::ostream& os_;
+    std::vector<bool> first_;
+    bool after_key_ = false;
+};
+
+// 以下 find_* 函数在JSON文本中按模式查找键 (要求 "key": 中间没有空白)，不检查结构
+// 只用于读取本项目自己写出的扁平结果文件，不是通用的JSON解析器；不可信的输入用 parse_flat_object
+
+// 在JSON文本中查找 "key": <数字>，从 from 位置开始的第一次出现
+inline std::optional<double> find_number(std::string_view text, std::string_view key, size_t from = 0) {
+    std::string pattern = "\"" + std::string(key) + "\":";
+    size_t pos = text.find(pattern, from);
+    if (pos == std::string_view::npos) {
+        return std::nullopt;
+    }
+    pos += pattern.size();
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n')) {
+        ++pos;
+    }
+    std::string number(text.substr(pos, 32));
+    char* end = nullptr;
+    double value = std::strtod(number.c_str(), &end);
+    if (end == number.c_str()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// 在JSON文本中查找 "key":，返回其后的位置
+inline size_t find_key(std::string_view text, std::string_view key, size_t from = 0) {
+    std::string pattern = "\"" + std::string(key) + "\":";
+    size_t pos = text.find(pattern, from);
+    return pos == std::string_view::npos ? pos : pos + pattern.size();
+}
+
+// 在JSON文本中查找 "key": "<字符串>" 并反转义 (支持 \" \\ \/ \n \r \t，不支持 \u)
+inline std::optional<std::string> find_string(std::string_view text, std::string_view key, size_t from = 0) {
+    size_t pos = find_key(text, key, from);
+    if (pos == std::string_view::npos) {
+        return std::nullopt;
+    }
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+        ++pos;
+    }
+    if (pos >= text.size() || text[pos] != '"') {
+        return std::nullopt;
+    }
+    std::string result;
+    for (++pos; pos < text.size(); ++pos) {
+        char c = text[pos];
+        if (c == '"') {
+            return result;
+        }
+        if (c == '\\' && ++pos < text.size()) {
+            switch (text[pos]) {
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                default:  c = text[pos]; break;
+            }
+        }
+        result += c;
+    }
+    return std::nullopt; // 字符串未结束
+}
+
+// 扁平JSON对象中的一个值：字符串已反转义，数字保留原文 (由调用方按需要的类型解析)
+struct FlatValue {
+    enum class Type : uint8_t { String, Number, Bool, Null };
+    Type type = Type::Null;
+    std::string text;
+
+    inline bool is_true() const { return type == Type::Bool && text == "true"; }
+};
+
+using FlatObject = std::unordered_map<std::string, FlatValue>;
+
+// 是否符合JSON的数字语法：-?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+inline bool is_number(std::string_view text) {
+    size_t pos = 0;
+    auto digits = [&]() {
+        size_t start = pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') ++pos;
+        return pos > start;
+    };
+    if (pos < text.size() && text[pos] == '-') ++pos;
+    if (pos < text.size() && text[pos] == '0') {
+        ++pos;
+    } else if (!digits()) {
+        return false;
+    }
+    if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        if (!digits()) return false;
+    }
+    if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        ++pos;
+        if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) ++pos;
+        if (!digits()) return false;
+    }
+    return pos == text.size();
+}
+
+// 解析一个只含标量值 (字符串、数字、true、false、null) 的JSON对象，例如服务器的一行请求
+// 不支持嵌套的对象和数组以及 \u 转义；格式错误时返回 std::nullopt。重复的键以最后一次为准
+inline std::optional<FlatObject> parse_flat_object(std::string_view text) {
+    size_t pos = 0;
+    auto skip_space = [&]() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) {
+            ++pos;
+        }
+    };
+    auto at = [&](char c) { return pos < text.size() && text[pos] == c; };
+    // pos 指向开头的引号，读到结尾的引号之后
+    auto read_string = [&](std::string& out) {
+        for (++pos; pos < text.size(); ++pos) {
+            char c = text[pos];
+            if (c == '"') {
+                ++pos;
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) return false;
+            if (c == '\\') {
+                if (++pos >= text.size()) return false;
+                switch (text[pos]) {
+                    case '"': case '\\': case '/': c = text[pos]; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'n': c = '\n'; break;
+                    case 'r': c = '\r'; break;
+                    case 't': c = '\t'; break;
+                    default: return false;
+                }
+            }
+            out += c;
+        }
+        return false;
+    };
+
+    FlatObject fields;
+    skip_space();
+    if (!at('{')) return std::nullopt;
+    ++pos;
+    skip_space();
+    if (at('}')) {
+        ++pos;
+    } else {
+        for (;;) {
+            skip_space();
+            std::string key;
+            if (!at('"') || !read_string(key)) return std::nullopt;
+            skip_space();
+            if (!at(':')) return std::nullopt;
+            ++pos;
+            skip_space();
+            FlatValue value;
+            if (at('"')) {
+                value.type = FlatValue::Type::String;
+                if (!read_string(value.text)) return std::nullopt;
+            } else {
+                size_t end = text.find_first_of(",} \t\r\n", pos);
+                value.text = text.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+                pos += value.text.size();
+                if (value.text == "true" || value.text == "false") {
+                    value.type = FlatValue::Type::Bool;
+                } else if (value.text == "null") {
+                    value.type = FlatValue::Type::Null;
+                } else if (is_number(value.text)) {
+                    value.type = FlatValue::Type::Number;
+                } else {
+                    return std::nullopt;
+                }
+            }
+            fields[std::move(key)] = std::move(value);
+            skip_space();
+            if (at(',')) {
+                ++pos;
+            } else if (at('}')) {
+                ++pos;
+                break;
+            } else {
+                return std::nullopt;
+            }
+        }
+    }
+    skip_space();
+    if (pos != text.size()) return std::nullopt;
+    return fields;
+}
+
+} // namespace RubiksSolver::Json
+
+#endif // JSON_UTIL_H
@@ -0,0 +1,132 @@
+#ifndef LOCKSTEP_SOLVER_H
+#define LOCKSTEP_SOLVER_H
+
+#include "cube.h"
+#include "moves.h"
+#include "solve_options.h"
+#include "table_manager.h"
+#include "two_phase_search.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 只在 x86-64 上编译 AVX2 版本的查询，运行时再检测 CPU 是否支持
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RUBIKS_LOCKSTEP_AVX2 1
+#endif
+
+namespace RubiksSolver {
+
+// 同时求解多个状态的批量求解器：每个通道 (lane) 一个状态，所有通道同步推进
+// 每一步每个通道弹出一个节点；需要展开的节点一起计算子节点，对每个转动用一条 AVX2 gather
+// 同时查询所有通道的移动表和剪枝表 (CPU 不支持 AVX2 时逐通道查询)
+// 通道有各自的栈和两阶段状态机，求解完成的通道立即从队列中取下一个状态
+// 搜索与 Solver 的默认策略 (plain,noclamp,sorted,restart) 完全相同，得到的解也相同
+class LockstepSolver {
+public:
+    static constexpr int LANES = 8;
+
+    struct Result {
+        std::vector<Move> solution;
+        std::string error; // 为空表示成功
+    };
+
+    explicit LockstepSolver(const TableManager& tables, const SearchLimits& limits = SearchLimits::tuned());
+
+    // 求解所有状态，结果与输入一一对应；会先等待所有表就绪
+    std::vector<Result> solve(const std::vector<Cube>& cubes);
+
+    // 自构造以来展开的节点总数，以及平均每步有多少通道在展开节点
+    inline uint64_t nodes_expanded() const { return nodes_expanded_; }
+    inline double lane_utilization() const {
+        return steps_ == 0 ? 0.0 : static_cast<double>(lane_steps_) / (steps_ * LANES);
+    }
+
+    // 本机是否使用 AVX2 gather (否则为逐通道的标量查询)
+    static bool uses_avx2();
+    // 只支持默认的搜索策略开关 (深度上限可以任意)
+    static inline bool supports(const SolveOptions& options) { return TwoPhaseSearch::supports(options); }
+
+private:
+    using Node = TwoPhaseSearch::Node;
+    using Search = TwoPhaseSearch::Search;
+    // 一个通道上当前 IDA* 的状态
+    using Status = TwoPhaseSearch::Status;
+
+    enum class Stage : uint8_t {
+        Idle,
+        Phase1,  // 在 phase1 中搜索第一阶段的 (下一个) 解
+        Phase2,  // 在预算内搜索第二阶段
+        Widened  // 放宽预算后的第二阶段
+    };
+
+    struct Lane {
+        Stage stage = Stage::Idle;
+        size_t item = 0;
+        Search phase1;
+        Search phase2;
+        std::vector<Move> phase1_solution;
+        int budget = 0;
+        int resumes = 0;
+        bool resuming = false; // Phase1 阶段是在继续搜索下一个第一阶段的解
+    };
+
+    // 需要展开的节点 (每个通道至多一个)，按阶段分组后整体计算子节点
+    struct Expansion {
+        uint32_t mask = 0;
+        std::array<uint16_t, LANES> x1{}, x2{}, x3{};
+        std::array<int, LANES> depth{}, h{}, bound{};
+        std::array<Move, LANES> last_move{};
+    };
+
+    // 子节点的坐标和启发值：[转动][通道]，每项32位以便整行存入向量寄存器
+    struct Children {
+        std::array<std::array<uint32_t, LANES>, 18> x1, x2, x3, h;
+    };
+
+    const TableManager& tables_;
+    SearchLimits limits_;
+    TableManager::RawTables raw_{};
+    std::array<int, 2> probe_depth_{};
+    bool avx2_ = false;
+    uint64_t nodes_expanded_ = 0;
+    uint64_t steps_ = 0;
+    uint64_t lane_steps_ = 0;
+
+    std::array<Lane, LANES> lanes_;
+    const std::vector<Cube>* cubes_ = nullptr;
+    std::vector<Result>* results_ = nullptr;
+    size_t next_item_ = 0;
+
+    std::vector<Move> endgame_path_;
+
+    inline Search& current_search(Lane& lane) {
+        return lane.stage == Stage::Phase1 ? lane.phase1 : lane.phase2;
+    }
+
+    // 从队列中取下一个状态开始求解；队列为空时通道空闲
+    Status refill(Lane& lane);
+    template<uint8_t PHASE>
+    void start_search(Search& search, uint16_t x1, uint16_t x2, uint16_t x3, int limit, int first_depth);
+    // 按两阶段流程推进通道，直到它回到搜索中或变为空闲
+    void advance(Lane& lane, Status status);
+    Status begin_phase2(Lane& lane);
+    Status widen(Lane& lane);
+
+    // 弹出一个节点：找到解返回 true；需要展开时加入 expansion
+    template<uint8_t PHASE>
+    bool visit(int lane_index, Search& search, Expansion& expansion);
+    template<uint8_t PHASE>
+    void expand(const Expansion& expansion);
+    template<uint8_t PHASE>
+    void children_scalar(const Expansion& expansion, Children& children) const;
+#ifdef RUBIKS_LOCKSTEP_AVX2
+    template<uint8_t PHASE>
+    __attribute__((target("avx2"))) void children_avx2(const Expansion& expansion, Children& children) const;
+#endif
+};
+
+} // namespace RubiksSolver
+
+#endif // LOCKSTEP_SOLVER_H
@@ -0,0 +1,97 @@
+#ifndef MOVE_DATA_H
+#define MOVE_DATA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace RubiksSolver {
+
+// 角块位置
+enum CornerPos : uint8_t { UFL, UBL, UBR, UFR, DFL, DBL, DBR, DFR };
+
+// 棱块位置
+enum EdgePos : uint8_t { UF, UL, UB, UR, DF, DL, DB, DR, FL, BL, BR, FR };
+
+
+// 例如 cycle(arr, {0, 1, 2, 3}) 会将 arr[0]<-arr[1]<-arr[1]<-arr[2]<-arr[3]<-arr[0]
+template<typename T, size_t ArraySize>
+constexpr void cycle_pieces(
+    std::array<T, ArraySize>& arr,
+    const std::array<uint8_t, 4>& affected_indices, // 受影响的槽位索引
+    const std::array<uint8_t, 4>& target_map   // 置换映射表
+) {
+    std::array<T, 4> temp_pieces;
+    for (size_t i = 0; i < 4; ++i) {
+        temp_pieces[i] = arr[affected_indices[i]];
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        arr[target_map[i]] = temp_pieces[i];
+    }
+}
+
+
+struct MoveMap {
+    // 受影响的槽位索引
+    std::array<uint8_t, 4> affected_indices;
+
+    // 移动后的位置映射
+    std::array<uint8_t, 4> target_map;
+};
+
+// 描述一次转动效果的数据结构
+struct MoveDefinition {
+    // 角块置换
+    MoveMap corner_permutation;
+    // 棱块置换
+    MoveMap edge_permutation;
+    // 对应角块的朝向变化 (模3)
+    std::array<uint8_t, 4> corner_orientation_changes;
+    // 对应棱块的朝向变化 (模2)
+    std::array<uint8_t, 4> edge_orientation_changes;
+};
+
+constexpr std::array<MoveDefinition, 18> ALL_MOVES_DATA = {{
+    // Move::U1
+    { {{UFL, UBL, UBR, UFR}, {UBL, UBR, UFR, UFL}}, {{UF, UL, UB, UR}, {UL, UB, UR, UF}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::U2
+    { {{UFL, UFR, UBR, UBL}, {UFR, UBR, UBL, UFL}}, {{UF, UR, UB, UL}, {UR, UB, UL, UF}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::U3
+    { {{UFL, UBR, UFR, UBL}, {UBR, UFL, UBL, UFR}}, {{UF, UB, UL, UR}, {UB, UF, UR, UL}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::D1
+    { {{DFL, DFR, DBR, DBL}, {DFR, DBR, DBL, DFL}}, {{DF, DR, DB, DL}, {DR, DB, DL, DF}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::D2
+    { {{DFL, DBL, DBR, DFR}, {DBL, DBR, DFR, DFL}}, {{DF, DL, DB, DR}, {DL, DB, DR, DF}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::D3
+    { {{DFL, DBR, DFR, DBL}, {DBR, DFL, DBL, DFR}}, {{DF, DB, DL, DR}, {DB, DF, DR, DL}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::F1
+    { {{UFL, UFR, DFR, DFL}, {UFR, DFR, DFL, UFL}}, {{UF, FR, DF, FL}, {FR, DF, FL, UF}}, {2,1,2,1}, {1,1,1,1} },
+    // Move::F2
+    { {{UFL, DFL, DFR, UFR}, {DFL, DFR, UFR, UFL}}, {{UF, FL, DF, FR}, {FL, DF, FR, UF}}, {2,1,2,1}, {1,1,1,1} },
+    // Move::F3
+    { {{UFL, DFR, UFR, DFL}, {DFR, UFL, DFL, UFR}}, {{UF, DF, FL, FR}, {DF, UF, FR, FL}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::B1
+    { {{UBL, DBL, DBR, UBR}, {DBL, DBR, UBR, UBL}}, {{UB, BL, DB, BR}, {BL, DB, BR, UB}}, {1,2,1,2}, {1,1,1,1} },
+    // Move::B2
+    { {{UBL, UBR, DBR, DBL}, {UBR, DBR, DBL, UBL}}, {{UB, BR, DB, BL}, {BR, DB, BL, UB}}, {1,2,1,2}, {1,1,1,1} },
+    // Move::B3
+    { {{UBL, DBR, UBR, DBL}, {DBR, UBL, DBL, UBR}}, {{UB, DB, BL, BR}, {DB, UB, BR, BL}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::L1
+    { {{UFL, DFL, DBL, UBL}, {DFL, DBL, UBL, UFL}}, {{UL, FL, DL, BL}, {FL, DL, BL, UL}}, {1,2,1,2}, {0,0,0,0} },
+    // Move::L2
+    { {{UFL, UBL, DBL, DFL}, {UBL, DBL, DFL, UFL}}, {{UL, BL, DL, FL}, {BL, DL, FL, UL}}, {1,2,1,2}, {0,0,0,0} },
+    // Move::L3
+    { {{UFL, DBL, UBL, DFL}, {DBL, UFL, DFL, UBL}}, {{UL, DL, FL, BL}, {DL, UL, BL, FL}}, {0,0,0,0}, {0,0,0,0} },
+    // Move::R1
+    { {{UFR, UBR, DBR, DFR}, {UBR, DBR, DFR, UFR}}, {{UR, BR, DR, FR}, {BR, DR, FR, UR}}, {2,1,2,1}, {0,0,0,0} },
+    // Move::R2
+    { {{UFR, DFR, DBR, UBR}, {DFR, DBR, UBR, UFR}}, {{UR, FR, DR, BR}, {FR, DR, BR, UR}}, {2,1,2,1}, {0,0,0,0} },
+    // Move::R3
+    { {{UFR, DBR, UBR, DFR}, {DBR, UFR, DFR, UBR}}, {{UR, DR, FR, BR}, {DR, UR, BR, FR}}, {0,0,0,0}, {0,0,0,0} },
+
+}};
+
+} // namespace RubiksSolver
+
+#endif // MOVE_DATA_H
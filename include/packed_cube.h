@@ -0,0 +1,182 @@
+#ifndef PACKED_CUBE_H
+#define PACKED_CUBE_H
+
+#include "cube.h"
+#include "move_data.h"
+#include "moves.h"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define RUBIKS_PACKED_CUBE_SIMD 1
+#else
+#define RUBIKS_PACKED_CUBE_SIMD 0
+#endif
+
+namespace RubiksSolver {
+
+// 紧凑的魔方表示：角块和棱块各占一个128位寄存器的字节通道
+// 每个字节的低4位是块编号，高4位是朝向；未使用的通道 (角块8-15，棱块12-15) 保持恒等
+// 魔方状态与转动统一用"置换+朝向"表示，一次转动就是一次复合运算：
+//     result[i] = a[b.piece(i)]，朝向 = a 的朝向 + b 的朝向
+// 在支持 SSSE3 时，每组块的复合是一条 pshufb 加上朝向的加法/比较；否则使用等价的标量实现
+// 适用于打乱序列回放、解的验证等批量转动场景
+class PackedCube {
+public:
+    using Lanes = std::array<uint8_t, 16>;
+
+    static constexpr uint8_t PIECE_MASK = 0x0F;
+    static constexpr uint8_t ORI_SHIFT = 4;
+
+    // 已复原状态
+    constexpr PackedCube() {
+        for (uint8_t i = 0; i < 16; ++i) {
+            corners_[i] = i;
+            edges_[i] = i;
+        }
+    }
+
+    // 与 Cube 互相转换
+    constexpr explicit PackedCube(const Cube& cube) : PackedCube() {
+        for (uint8_t i = 0; i < 8; ++i) {
+            corners_[i] = cube.corners[i].piece | (cube.corners[i].orientation << ORI_SHIFT);
+        }
+        for (uint8_t i = 0; i < 12; ++i) {
+            edges_[i] = cube.edges[i].piece | (cube.edges[i].orientation << ORI_SHIFT);
+        }
+    }
+
+    constexpr Cube to_cube() const {
+        Cube cube;
+        for (uint8_t i = 0; i < 8; ++i) {
+            cube.corners[i].piece = corners_[i] & PIECE_MASK;
+            cube.corners[i].orientation = corners_[i] >> ORI_SHIFT;
+        }
+        for (uint8_t i = 0; i < 12; ++i) {
+            cube.edges[i].piece = edges_[i] & PIECE_MASK;
+            cube.edges[i].orientation = edges_[i] >> ORI_SHIFT;
+        }
+        return cube;
+    }
+
+    // 单次转动作用于已复原魔方得到的状态
+    static constexpr PackedCube from_move(Move m) {
+        const auto& move_def = ALL_MOVES_DATA[static_cast<int>(m)];
+        PackedCube cube;
+        for (int i = 0; i < 4; ++i) {
+            cube.corners_[move_def.corner_permutation.target_map[i]] = move_def.corner_permutation.affected_indices[i];
+            cube.edges_[move_def.edge_permutation.target_map[i]] = move_def.edge_permutation.affected_indices[i];
+        }
+        for (int i = 0; i < 4; ++i) {
+            cube.corners_[move_def.corner_permutation.affected_indices[i]] |= move_def.corner_orientation_changes[i] << ORI_SHIFT;
+            cube.edges_[move_def.edge_permutation.affected_indices[i]] |= move_def.edge_orientation_changes[i] << ORI_SHIFT;
+        }
+        return cube;
+    }
+
+    // 复合：先做 *this，再做 other
+    inline PackedCube operator*(const PackedCube& other) const {
+        PackedCube result = *this;
+        result.compose(other);
+        return result;
+    }
+
+    inline void compose(const PackedCube& other) {
+#if RUBIKS_PACKED_CUBE_SIMD
+        const __m128i piece_mask = _mm_set1_epi8(PIECE_MASK);
+
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(corners_.data()));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(other.corners_.data()));
+        __m128i c = _mm_add_epi8(_mm_shuffle_epi8(a, _mm_and_si128(b, piece_mask)),
+                                 _mm_andnot_si128(piece_mask, b));
+        // 朝向达到3 (即字节 >= 0x30) 时减去3
+        __m128i wrap = _mm_cmpgt_epi8(c, _mm_set1_epi8(0x2F));
+        c = _mm_sub_epi8(c, _mm_and_si128(wrap, _mm_set1_epi8(0x30)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(corners_.data()), c);
+
+        a = _mm_load_si128(reinterpret_cast<const __m128i*>(edges_.data()));
+        b = _mm_load_si128(reinterpret_cast<const __m128i*>(other.edges_.data()));
+        __m128i e = _mm_xor_si128(_mm_shuffle_epi8(a, _mm_and_si128(b, piece_mask)),
+                                  _mm_andnot_si128(piece_mask, b));
+        _mm_store_si128(reinterpret_cast<__m128i*>(edges_.data()), e);
+#else
+        Lanes corners{}, edges{};
+        for (int i = 0; i < 16; ++i) {
+            uint8_t b = other.corners_[i];
+            uint8_t c = corners_[b & PIECE_MASK] + (b & ~PIECE_MASK);
+            corners[i] = c >= 0x30 ? c - 0x30 : c;
+        }
+        for (int i = 0; i < 16; ++i) {
+            uint8_t b = other.edges_[i];
+            edges[i] = edges_[b & PIECE_MASK] ^ (b & ~PIECE_MASK);
+        }
+        corners_ = corners;
+        edges_ = edges;
+#endif
+    }
+
+    // 逆：满足 cube * cube.inverse() == 已复原状态
+    constexpr PackedCube inverse() const {
+        PackedCube result;
+        for (uint8_t i = 0; i < 8; ++i) {
+            uint8_t ori = corners_[i] >> ORI_SHIFT;
+            result.corners_[corners_[i] & PIECE_MASK] = i | (((3 - ori) % 3) << ORI_SHIFT);
+        }
+        for (uint8_t i = 0; i < 12; ++i) {
+            result.edges_[edges_[i] & PIECE_MASK] = i | (edges_[i] & ~PIECE_MASK);
+        }
+        return result;
+    }
+
+    // 应用一次转动；热点路径上不做越界检查
+    inline void apply_move(Move m) {
+        assert(m < Move::COUNT && "Invalid move");
+        compose(MOVE_CUBES[static_cast<int>(m)]);
+    }
+
+    inline void apply_sequence(const std::vector<Move>& sequence) {
+        for (Move m : sequence) {
+            apply_move(m);
+        }
+    }
+
+    inline bool is_solved() const { return *this == PackedCube(); }
+
+    inline bool operator==(const PackedCube& other) const {
+#if RUBIKS_PACKED_CUBE_SIMD
+        __m128i c = _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(corners_.data())),
+                                   _mm_load_si128(reinterpret_cast<const __m128i*>(other.corners_.data())));
+        __m128i e = _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(edges_.data())),
+                                   _mm_load_si128(reinterpret_cast<const __m128i*>(other.edges_.data())));
+        return _mm_movemask_epi8(_mm_and_si128(c, e)) == 0xFFFF;
+#else
+        return corners_ == other.corners_ && edges_ == other.edges_;
+#endif
+    }
+
+    inline const Lanes& corner_lanes() const { return corners_; }
+    inline const Lanes& edge_lanes() const { return edges_; }
+
+private:
+    static const std::array<PackedCube, 18> MOVE_CUBES;
+
+    alignas(16) Lanes corners_{};
+    alignas(16) Lanes edges_{};
+};
+
+inline constexpr std::array<PackedCube, 18> make_packed_move_cubes() {
+    std::array<PackedCube, 18> cubes{};
+    for (int m = 0; m < 18; ++m) {
+        cubes[m] = PackedCube::from_move(static_cast<Move>(m));
+    }
+    return cubes;
+}
+
+inline constexpr std::array<PackedCube, 18> PackedCube::MOVE_CUBES = make_packed_move_cubes();
+
+} // namespace RubiksSolver
+
+#endif // PACKED_CUBE_H
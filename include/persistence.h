@@ -2,6 +2,7 @@
 #define PERSISTENCE_H
 
 #include <array>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -115,8 +116,10 @@ void save_map_binary(const std::unordered_map<uint64_t, std::vector<T>>& map, co
     std::cout << "Map saved to " << filename << " (size: " << map_size << ")" << std::endl;
 }
 
+// max_vector_size: 跳过更长的值 (只加载一部分时避免先整体读入内存)
 template<typename T>
-bool load_map_binary(std::unordered_map<uint64_t, std::vector<T>>& map, const std::string& filename) {
+bool load_map_binary(std::unordered_map<uint64_t, std::vector<T>>& map, const std::string& filename,
+                     uint64_t max_vector_size = UINT64_MAX) {
     std::ifstream in(filename, std::ios::binary);
      if (!in.is_open()) {
         std::cerr << "Failed to open file for reading: " << filename << std::endl;
@@ -126,7 +129,9 @@ bool load_map_binary(std::unordered_map<uint64_t, std::vector<T>>& map, const st
     uint64_t map_size;
     in.read(reinterpret_cast<char*>(&map_size), sizeof(map_size));
     
-    map.reserve(map_size); // 预分配空间，提高性能
+    if (max_vector_size == UINT64_MAX) {
+        map.reserve(map_size); // 预分配空间，提高性能
+    }
 
     for (uint64_t i = 0; i < map_size; ++i) {
         uint64_t key;
@@ -135,12 +140,16 @@ bool load_map_binary(std::unordered_map<uint64_t, std::vector<T>>& map, const st
         uint64_t vec_size;
         in.read(reinterpret_cast<char*>(&vec_size), sizeof(vec_size));
 
+        if (vec_size > max_vector_size) {
+            in.seekg(vec_size * sizeof(T), std::ios::cur);
+            continue;
+        }
         std::vector<T> vec(vec_size);
         in.read(reinterpret_cast<char*>(vec.data()), vec_size * sizeof(T));
 
         map[key] = std::move(vec);
     }
-    std::cout << "Map loaded from " << filename << " (size: " << map_size << ")" << std::endl;
+    std::cout << "Map loaded from " << filename << " (size: " << map.size() << ")" << std::endl;
     return true;
 }
 
@@ -0,0 +1,118 @@
+#ifndef PIPELINED_SOLVER_H
+#define PIPELINED_SOLVER_H
+
+#include "coordinate.h"
+#include "cube.h"
+#include "moves.h"
+#include "solve_options.h"
+#include "table_manager.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 流水线两阶段求解：寻找尽量短的解
+// 第一阶段线程按长度递增枚举所有到达 G1 的路径 (终点)，把终点的第二阶段坐标和路径放入无锁队列；
+// 第二阶段线程并行取出终点，在 "当前最优长度 - 1 - 第一阶段长度" 之内做第二阶段 IDA*
+// 最优长度是所有线程共享的原子变量：第二阶段据此收紧深度上限，第一阶段据此丢弃不可能更短的终点
+// 达到目标长度、或者超出时间预算 (且已经有解) 时停止，返回找到的最短解
+class PipelinedSolver {
+public:
+    struct Options {
+        unsigned phase1_threads = 1;
+        unsigned phase2_threads = 0;  // 0 表示硬件线程数减去第一阶段线程数 (至少1)
+        bool serial = false;          // 在调用线程中依次执行：每个终点立即做第二阶段搜索 (用于比较)
+        int target_length = 20;       // 找到不超过该长度的解时立即停止
+        uint64_t budget_us = 50000;   // 时间预算；用完时返回已找到的最短解 (还没有解时等到第一个解)
+        int max_length = 30;          // 初始的长度上限：第一阶段长度不超过12时一定有解
+        size_t queue_capacity = 1024; // 终点队列的容量，队列满时第一阶段等待
+        SearchLimits limits = SearchLimits::tuned(); // 使用 phase1_max_depth 和两个阶段的 probe_depth
+    };
+
+    // 最近一次求解的统计
+    struct Stats {
+        uint64_t endpoints = 0;          // 第一阶段枚举到的终点数
+        uint64_t endpoints_searched = 0; // 做过第二阶段搜索的终点数
+        uint64_t phase1_nodes = 0;
+        uint64_t phase2_nodes = 0;
+        int improvements = 0;            // 最优解被更新的次数
+        uint64_t first_solution_ns = 0;  // 从开始到找到第一个解
+        uint64_t best_solution_ns = 0;   // 从开始到找到最终返回的解
+    };
+
+    PipelinedSolver(const TableManager& tables, const Options& options);
+
+    PipelinedSolver(const PipelinedSolver&) = delete;
+    PipelinedSolver& operator=(const PipelinedSolver&) = delete;
+
+    // 找不到解 (第一阶段深度上限过小) 时抛出 std::runtime_error
+    std::vector<Move> solve(const Cube& cube);
+
+    inline const Stats& last_stats() const { return stats_; }
+
+private:
+    // 第一阶段的长度不超过 SearchLimits 允许的最大 phase1_max_depth
+    static constexpr int MAX_PHASE1_LENGTH = 20;
+    static constexpr uint8_t END_OF_STREAM = 0xFF;
+
+    // 队列中的终点：第二阶段的三个坐标和第一阶段的路径
+    struct Endpoint {
+        uint16_t cp, udep, sep;
+        uint8_t length; // END_OF_STREAM 表示第一阶段已结束
+        std::array<Move, MAX_PHASE1_LENGTH> path;
+    };
+
+    // 每个线程自己的计数 (求解结束时汇总) 和查询终局数据库的缓冲区
+    // 第一阶段线程还沿当前路径追踪第二阶段坐标：tracked[d] 为路径前 d 步之后的追踪坐标，前 tracked_depth+1 项有效
+    // 深度优先枚举中相邻终点的路径前缀大多相同，生成终点时只需从第一处不同的转动开始查表
+    struct Worker {
+        uint64_t endpoints = 0;
+        uint64_t endpoints_searched = 0;
+        uint64_t phase1_nodes = 0;
+        uint64_t phase2_nodes = 0;
+        std::vector<Move> endgame_path;
+        std::array<Phase2Tracking, MAX_PHASE1_LENGTH + 1> tracked;
+        int tracked_depth = 0;
+    };
+
+    const TableManager& tables_;
+    const Options options_;
+    std::array<int, 2> probe_depth_{};
+    Stats stats_;
+
+    // 以下只在一次 solve() 期间有效
+    const Cube* cube_ = nullptr;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::atomic<int> best_length_{0};
+    std::atomic<bool> stop_{false};
+    std::mutex best_mutex_;
+    std::vector<Move> best_solution_;
+
+    // 第一阶段：枚举首步属于本线程 (首步编号 % 线程数 == index) 的终点，每个终点交给 emit
+    template<typename Emit>
+    void enumerate_phase1(unsigned index, unsigned count, Worker& worker, Emit&& emit);
+    template<typename Emit>
+    bool phase1_dfs(uint16_t co, uint16_t eo, uint16_t uds, Move last, int depth, int bound, unsigned index,
+                    unsigned count, std::array<Move, MAX_PHASE1_LENGTH>& path, Worker& worker, Emit& emit);
+    // 生成终点；不可能比当前最优解更短时返回 false
+    bool make_endpoint(const std::array<Move, MAX_PHASE1_LENGTH>& path, int length, Worker& worker,
+                       Endpoint& endpoint) const;
+
+    // 第二阶段：在当前最优长度之内搜索终点的第二阶段解，找到更短的解时更新最优解
+    void search_phase2(const Endpoint& endpoint, Worker& worker);
+    bool phase2_dfs(uint16_t cp, uint16_t udep, uint16_t sep, Move last, int depth, int bound, int limit,
+                    std::vector<Move>& path, Worker& worker);
+
+    void offer(const Endpoint& endpoint, const std::vector<Move>& phase2_path);
+    // 定期检查：超出时间预算且已有解时停止
+    bool should_stop(uint64_t nodes);
+};
+
+} // namespace RubiksSolver
+
+#endif // PIPELINED_SOLVER_H
@@ -0,0 +1,80 @@
+#ifndef RACING_SOLVER_H
+#define RACING_SOLVER_H
+
+#include "cube.h"
+#include "solver.h"
+#include "table_manager.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 多方向竞速求解
+// 两阶段算法的耗时很大程度上取决于 G1 选用的轴。同时搜索6个变体：魔方沿 UD/RL/FB 三个轴的共轭，
+// 以及它们的逆 (逆状态的解倒序取逆就是原状态的解)。解变换回原坐标系后返回
+//   budget_us == 0: 第一个找到的解获胜，其余搜索立即取消
+//   budget_us > 0 : 在预算时间内等待更多变体完成，返回最短的解；预算用完时仍没有解则继续等待第一个解
+class RacingSolver {
+public:
+    static constexpr int VARIANT_COUNT = 6;
+
+    struct Options {
+        unsigned threads = VARIANT_COUNT; // 工作线程数，超过6没有意义
+        uint64_t budget_us = 0;
+        SolveOptions solve;            // 各变体使用的搜索策略
+    };
+
+    // 最近一次求解的结果
+    struct RaceStats {
+        int winner = -1;                               // 变体编号：axis * 2 + (是否取逆)
+        std::array<int, VARIANT_COUNT> lengths{};      // 各变体的解长度，-1 表示未完成或失败
+    };
+
+    RacingSolver(const TableManager& tables, const Options& options);
+    ~RacingSolver();
+
+    RacingSolver(const RacingSolver&) = delete;
+    RacingSolver& operator=(const RacingSolver&) = delete;
+
+    std::vector<Move> solve(const Cube& cube);
+
+    inline const RaceStats& last_race() const { return last_race_; }
+
+private:
+    struct Variant {
+        Cube cube;
+        std::vector<Move> solution;
+        bool done = false;
+        bool success = false;
+    };
+
+    bool race_finished() const;
+
+    const Options options_;
+    std::array<uint8_t, 3> axis_symmetry_; // 把 UD/RL/FB 轴变换为 UD 轴的对称编号
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable variant_done_;
+    std::array<Variant, VARIANT_COUNT> variants_;
+    uint64_t generation_ = 0;     // 每次 solve 加一，唤醒工作线程
+    int next_variant_ = VARIANT_COUNT;
+    int finished_ = VARIANT_COUNT;
+    bool deadline_passed_ = false;
+    bool shutdown_ = false;
+    std::atomic<bool> cancel_{false};
+    RaceStats last_race_;
+
+    std::vector<std::unique_ptr<Solver>> solvers_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace RubiksSolver
+
+#endif // RACING_SOLVER_H
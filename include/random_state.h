@@ -0,0 +1,32 @@
+#ifndef RANDOM_STATE_H
+#define RANDOM_STATE_H
+
+#include "cube.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 均匀随机魔方状态生成器
+// 直接随机生成角块/棱块的排列和朝向 (而不是随机转动序列)，对所有可复原状态均匀分布：
+//   - 角块、棱块排列各自用 Fisher-Yates 洗牌
+//   - 若两者奇偶性不同，交换最后两个棱块 (这是奇偶性相反的排列之间的双射，不破坏均匀性)
+//   - 前7个角块、前11个棱块的朝向随机，最后一个由朝向之和推出
+// 相同的种子总是生成相同的序列
+class RandomStateGenerator {
+public:
+    explicit RandomStateGenerator(uint64_t seed) : rng_(seed) {}
+
+    Cube next();
+
+    // 生成 count 个状态
+    std::vector<Cube> generate(size_t count);
+
+private:
+    std::mt19937_64 rng_;
+};
+
+} // namespace RubiksSolver
+
+#endif // RANDOM_STATE_H
@@ -0,0 +1,105 @@
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include "cube.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 以48对称类的代表元为键的解缓存
+// 代表元是48个对称变换后色块序列 (每个非中心色块3位，共144位) 字典序最小的一个，
+// 只差一个整体旋转或镜像的状态共享同一条缓存项；命中时解被变换回调用者的坐标系
+// 按哈希分片加锁，每个分片用 CLOCK 算法淘汰；可以保存为快照文件并通过 mmap 恢复
+class SolutionCache {
+public:
+    using Key = std::array<uint64_t, 3>;
+
+    // 查找时算出的代表元，未命中时传给 insert 以免重复计算
+    struct CanonicalForm {
+        Key key{};
+        uint8_t symmetry = 0; // 把状态变换为代表元的对称编号
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t capacity = 0;
+        size_t memory_bytes = 0;      // 缓存项与索引的近似内存占用
+        double mean_lookup_ns = 0.0;  // 包括计算代表元的时间
+
+        inline double hit_rate() const {
+            uint64_t lookups = hits + misses;
+            return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+        }
+    };
+
+    // 能缓存的最长解
+    static constexpr size_t MAX_SOLUTION_LENGTH = 39;
+
+    explicit SolutionCache(size_t capacity);
+
+    static CanonicalForm canonicalize(const Cube& cube);
+
+    // 命中时把解 (调用者坐标系) 写入 solution；无论是否命中都会填写 form
+    bool lookup(const Cube& cube, std::vector<Move>& solution, CanonicalForm& form);
+    void insert(const CanonicalForm& form, const std::vector<Move>& solution);
+
+    Stats stats() const;
+
+    // 快照：固定大小的缓存项数组，恢复时通过 mmap 读取，返回实际恢复的项数 (跳过长度或转动编号无效的项)
+    void save(const std::string& path) const;
+    size_t load(const std::string& path);
+
+private:
+    // 64字节的缓存项，也是快照文件中的格式
+    struct Entry {
+        Key key;
+        uint8_t length;
+        std::array<uint8_t, MAX_SOLUTION_LENGTH> moves;
+    };
+    static_assert(sizeof(Entry) == 64);
+
+    struct KeyHash {
+        inline size_t operator()(const Key& key) const {
+            uint64_t h = key[0] * 0x9E3779B97F4A7C15ULL ^ key[1] * 0xC2B2AE3D27D4EB4FULL ^ key[2];
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, uint32_t, KeyHash> index;
+        std::vector<Entry> slots;
+        std::vector<uint8_t> referenced; // CLOCK 的访问位
+        size_t hand = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+    };
+
+    static constexpr size_t SHARD_COUNT = 16;
+
+    inline Shard& shard_for(const Key& key) { return shards_[KeyHash{}(key) % SHARD_COUNT]; }
+    void insert_canonical(const Key& key, const uint8_t* moves, uint8_t length);
+
+    size_t capacity_per_shard_;
+    std::unique_ptr<Shard[]> shards_;
+    std::atomic<uint64_t> lookup_ns_{0};
+    std::atomic<uint64_t> lookups_{0};
+};
+
+} // namespace RubiksSolver
+
+#endif // SOLUTION_CACHE_H
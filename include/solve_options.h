@@ -0,0 +1,76 @@
+#ifndef SOLVE_OPTIONS_H
+#define SOLVE_OPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+namespace RubiksSolver {
+
+// 子节点的排序方式
+enum class MoveOrdering : uint8_t {
+    Heuristic, // 按启发值升序，优先搜索更接近目标的子节点
+    Natural    // 按转动编号顺序，省去排序
+};
+
+// 搜索的深度上限和阈值 (不影响解的正确性，只影响速度和解的长度)
+// 默认值可由 benchmark --tune 针对本机和语料调优后写入配置文件，进程启动时加载
+struct SearchLimits {
+    int phase1_max_depth = 12;   // 第一阶段 IDA* 的深度上限
+    int phase2_total = 25;       // 第二阶段预算为 max(phase2_min, phase2_total - 第一阶段长度)
+    int phase2_min = 8;
+    int p1_probe_depth = 6;      // 启发值不超过该值时查询终局数据库 (超过数据库深度时按数据库深度)
+    int p2_probe_depth = 7;
+    int max_phase1_resumes = 4;  // 第二阶段在预算内无解时，最多继续第一阶段搜索的次数
+
+    // 配置文件中的键名，与 set() 接受的名字一致
+    static constexpr const char* KEYS[] = {
+        "phase1_max_depth", "phase2_total", "phase2_min", "p1_probe_depth", "p2_probe_depth", "max_phase1_resumes"};
+
+    // 按键名设置字段；键名未知或取值越界时抛出 std::invalid_argument
+    void set(const std::string& key, int value);
+    int get(const std::string& key) const;
+
+    // 每行 key=value，'#' 之后为注释；无法打开或格式错误时抛出异常
+    static SearchLimits load(const std::string& path);
+    void save(const std::string& path, const std::string& comment) const;
+
+    // 进程默认值：RUBIKS_TUNING_FILE 指定的文件 (为空时不加载)，未设置时为当前目录下的 tuning.conf (存在时)
+    // 只加载一次；文件有误时打印警告并使用内置默认值
+    static const SearchLimits& tuned();
+    // tuned() 的来源文件，使用内置默认值时为空
+    static const std::string& tuned_source();
+
+    std::string describe() const;
+
+    inline bool operator==(const SearchLimits&) const = default;
+};
+
+// 每次求解可选的搜索策略
+// 每种组合都编译成独立的搜索内核 (见 SearchPolicies)，运行时只在求解入口分派一次
+struct SolveOptions {
+    // 子节点启发值至少为父节点减一 (pathmax)，剪掉更多节点
+    bool parent_heuristic = false;
+    // 终局数据库未命中时，认为到目标至少还要 (数据库深度 + 1) 步，并据此剪枝；
+    // 严格限制解的长度：更慢，但解更短
+    bool endgame_clamp = false;
+    MoveOrdering ordering = MoveOrdering::Heuristic;
+    // IDA* 加深时从上一轮的前沿继续，不再重新展开浅层节点；前沿超出容量时退回普通 IDA*
+    bool reuse_frontier = false;
+    // 深度上限和阈值，默认取调优后的进程默认值
+    SearchLimits limits = SearchLimits::tuned();
+
+    // 预设："fast" 为默认策略；"short" 同时开启 parent_heuristic 和 endgame_clamp
+    static SolveOptions fast() { return {}; }
+    static SolveOptions shortest() { return {true, true, MoveOrdering::Heuristic}; }
+
+    // 解析逗号分隔的预设或开关，如 "short"、"fast,natural"、"pathmax,clamp,frontier"；无法识别时抛出 std::invalid_argument
+    static SolveOptions parse(const std::string& text);
+    // 只描述策略开关 (limits 见 SearchLimits::describe)
+    std::string describe() const;
+
+    inline bool operator==(const SolveOptions&) const = default;
+};
+
+} // namespace RubiksSolver
+
+#endif // SOLVE_OPTIONS_H
@@ -0,0 +1,42 @@
+#ifndef SOLVE_SERVER_H
+#define SOLVE_SERVER_H
+
+#include "table_manager.h"
+#include "solution_cache.h"
+#include "solve_options.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace RubiksSolver {
+
+struct ServerOptions {
+    std::string socket_path;      // Unix 域套接字路径，为空时不监听
+    int tcp_port = 0;             // 127.0.0.1 上的TCP端口，0 表示不监听
+    unsigned threads = 0;         // 求解线程数，0 表示使用硬件线程数
+    size_t max_batch = 32;        // 每个工作线程一次取出的最大请求数
+    size_t max_in_flight = 4096;  // 已接收但尚未回复的请求上限，超出时直接回复错误
+    SolutionCache* cache = nullptr;
+    SolveOptions policy;          // 默认搜索策略，JSON 请求可以用 "policy" 字段单独指定
+};
+
+// 常驻求解服务：表只加载一次，多个客户端通过套接字提交请求
+// 一个 epoll 线程负责所有连接的读写，请求经无锁队列分批交给工作线程
+// 每个连接可以连续发送多个请求而不等待回复 (流水线)，回复按完成顺序返回并带有请求ID
+//
+// 协议由连接的第一个字节决定：
+//   JSON: 每行一个请求 {"id": 1, "cube": "<打乱序列或色块字符串>"}，可选 "policy": "short" 等 (见 SolveOptions::parse)
+//         回复 {"id":1,"solution":"R U ...","length":20} 或 {"id":1,"error":"..."}
+//         id 可省略，必须是非负整数；只含标量值的对象之外的行回复错误 (id 为 0)
+//         {"id": 2, "stats": true} 立即返回缓存统计 {"id":2,"cache":{...}} (未启用缓存时 "cache":null)
+//   二进制: 第一个字节为 BINARY_MAGIC，之后每个请求为
+//         [u32 id][u16 长度][文本]，回复为 [u32 id][u8 状态][u8 长度][数据]
+//         状态 0 时数据为转动编号 (Move 的值)，状态 1 时为错误信息；整数均为小端
+// 收到 SIGINT/SIGTERM 后取消未完成的求解并返回；启用缓存时 policy 必须是默认策略，否则抛出 std::invalid_argument
+void run_server(const TableManager& tables, const ServerOptions& options);
+
+inline constexpr uint8_t BINARY_MAGIC = 0xB1;
+
+} // namespace RubiksSolver
+
+#endif // SOLVE_SERVER_H
@@ -3,6 +3,11 @@
 
 #include "cube.h"
 #include "table_manager.h"
+#include "solution_cache.h"
+#include "solve_options.h"
+#include "ida_frontier.h"
+#include <atomic>
+#include <stdexcept>
 #include <vector>
 #include <stack>
 #include <tuple>
@@ -11,96 +16,329 @@
 
 namespace RubiksSolver {
 
+// 一次求解的搜索工作量统计，与计时无关，相同输入下结果确定
+struct SearchStats {
+    struct Phase {
+        std::vector<uint64_t> nodes_per_iteration; // 每个IDA*深度上限展开的节点数
+        uint64_t endgame_probes = 0;               // 终局数据库查询次数
+        uint64_t endgame_hits = 0;                 // 终局数据库命中次数
+        uint64_t frontier_nodes = 0;               // 记录的前沿节点数 (只在 reuse_frontier 时)
+        bool frontier_overflowed = false;          // 前沿超出容量，退回每轮从根节点开始
+        int solution_length = 0;
+
+        inline uint64_t nodes() const {
+            uint64_t total = 0;
+            for (uint64_t n : nodes_per_iteration) total += n;
+            return total;
+        }
+    };
+    std::array<Phase, 2> phases;
+    int phase1_resumes = 0;      // 第二阶段在深度预算内无解、继续第一阶段搜索的次数
+    bool phase2_widened = false; // 最终放宽了第二阶段的深度预算
+};
+
+// Solver 自构造以来各种兜底路径的触发次数
+struct FallbackCounters {
+    uint64_t solves = 0;
+    uint64_t resumed_solves = 0;   // 至少继续过一次第一阶段的求解
+    uint64_t phase1_resumes = 0;
+    uint64_t phase2_widenings = 0;
+};
+
+// 搜索被 Solver::set_cancel_flag 设置的标志取消
+class SolveCancelled : public std::runtime_error {
+public:
+    SolveCancelled() : std::runtime_error("Solve cancelled") {}
+};
+
+// 搜索策略类型：SolveOptions 的每个开关对应一个编译期参数，搜索内核中没有运行时分支
+namespace SearchPolicy {
+
+struct PlainHeuristic {
+    static inline int child_h(int h, int /*parent_h*/) { return h; }
+};
+// pathmax：子节点启发值至少为父节点减一
+struct ParentHeuristic {
+    static inline int child_h(int h, int parent_h) { return std::max(h, parent_h - 1); }
+};
+
+struct NoEndgameClamp {
+    static constexpr bool CLAMP = false;
+};
+struct EndgameClamp {
+    static constexpr bool CLAMP = true;
+};
+
+struct SortByHeuristic {
+    template<typename It>
+    static inline void order(It begin, It end) {
+        std::sort(begin, end, [](const auto& a, const auto& b) { return a.h < b.h; });
+    }
+};
+struct NaturalOrder {
+    template<typename It>
+    static inline void order(It, It) {}
+};
+
+// 每轮迭代从根节点重新开始
+struct RestartFromRoot {
+    static constexpr bool REUSE = false;
+};
+// 保留上一轮迭代的前沿，下一轮从前沿继续 (见 IdaFrontier)
+struct ReuseFrontier {
+    static constexpr bool REUSE = true;
+};
+
+} // namespace SearchPolicy
+
+template<typename H, typename E, typename O, typename F = SearchPolicy::RestartFromRoot>
+struct SearchPolicies {
+    using Heuristic = H;
+    using Endgame = E;
+    using Ordering = O;
+    using Frontier = F;
+    // 相同策略但每轮从根节点开始 (前沿溢出后使用)
+    using Restarting = SearchPolicies<H, E, O, SearchPolicy::RestartFromRoot>;
+};
+using DefaultSearchPolicies = SearchPolicies<SearchPolicy::PlainHeuristic, SearchPolicy::NoEndgameClamp,
+                                             SearchPolicy::SortByHeuristic>;
+
 class Solver {
 public:
-    Solver(const TableManager& tables);
+    // G1 子群在第二阶段转动下的直径，深度预算放宽到这里一定有解
+    static constexpr int PHASE2_MAX_DEPTH = 18;
 
+    // verbose 为 false 时不输出任何求解过程信息 (用于基准测试等批量场景)
+    Solver(const TableManager& tables, bool verbose = true);
+
+    // 使用 set_options 设置的策略求解
     std::vector<Move> solve(const Cube& scrambled_cube);
+    // 使用指定的策略求解 (只影响这一次求解)
+    std::vector<Move> solve(const Cube& scrambled_cube, const SolveOptions& options);
+
+    // solve(cube) 使用的默认策略
+    inline void set_options(const SolveOptions& options) { options_ = options; }
+    inline const SolveOptions& options() const { return options_; }
+
+    // 自构造以来 search_iterative 展开的节点总数
+    inline uint64_t nodes_expanded() const { return nodes_expanded_; }
+    // 最近一次 solve() 的搜索统计 (求解失败时包含失败前的部分)
+    inline const SearchStats& last_stats() const { return stats_; }
+
+    inline const FallbackCounters& fallback_counters() const { return fallbacks_; }
+
+    // 可选的解缓存 (可被多个 Solver 共享)；命中时 last_stats() 为空
+    inline void set_cache(SolutionCache* cache) { cache_ = cache; }
+
+    // 搜索时定期检查该标志，置位后 solve() 抛出 SolveCancelled
+    inline void set_cancel_flag(const std::atomic<bool>* cancel) { cancel_ = cancel; }
 
 private:
+    // 微基准测试需要直接调用启发函数和搜索内核
+    friend class SolverBenchmark;
+
     TableManager const& tables_;
+    bool verbose_;
+    SolveOptions options_;
+    SolutionCache* cache_ = nullptr;
+    const std::atomic<bool>* cancel_ = nullptr;
+    uint64_t nodes_expanded_ = 0;
+    // 本次求解是否使用组合剪枝表 (求解开始时确定，保证一次求解内启发函数不变)
+    bool combined_phase1_ = false;
+    bool combined_phase2_ = false;
+    // 本次求解各阶段查询终局数据库的启发值上限 (不超过数据库深度)
+    std::array<int, 2> probe_depth_ = {0, 0};
+    SearchStats stats_;
+    FallbackCounters fallbacks_;
 
-    template<uint8_t PHASE, typename C>
-    bool ida_star(C start_coord, std::vector<Move>& solution, int limit) {
-        if (start_coord.is_solved()) {
-            return true;
-        }
+    // 按策略类型实例化的求解流程，solve() 根据 SolveOptions 分派
+    template<typename P>
+    std::vector<Move> solve_with(const Cube& scrambled_cube, const SearchLimits& limits, bool use_cache);
 
+    // 迭代搜索的状态结构
+    struct SearchState {
         uint16_t x1, x2, x3;
+        Move last_move;
+        int depth, h;
+    };
+
+    // 可以中断后继续的 IDA* 搜索
+    // 找到解时栈中保留着尚未展开的节点，再次调用 ida_next 会从中断处继续，得到下一个解
+    struct IdaSearch {
+        uint16_t x1 = 0, x2 = 0, x3 = 0;
+        int root_h = 0;
+        int max_depth = 0;      // 当前迭代的深度上限
+        int limit = 0;
+        bool solved_at_start = false;
+        std::vector<SearchState> stack;
+        std::vector<Move> path;
+        IdaFrontier frontier;   // 只在 ReuseFrontier 策略下使用
+    };
+
+    // first_depth 大于启发值时跳过更浅的迭代 (这些深度已知无解)
+    template<uint8_t PHASE, typename C>
+    IdaSearch start_ida(const C& start_coord, int limit, int first_depth = 0) const {
+        IdaSearch search;
+        search.limit = limit;
+        search.solved_at_start = start_coord.is_solved();
         if constexpr (PHASE == 1) {
-            x1 = start_coord.get_corner_orientation();
-            x2 = start_coord.get_edge_orientation();
-            x3 = start_coord.get_ud_slice_position();
+            search.x1 = start_coord.get_corner_orientation();
+            search.x2 = start_coord.get_edge_orientation();
+            search.x3 = start_coord.get_ud_slice_position();
         } else if constexpr (PHASE == 2) {
-            x1 = start_coord.get_corner_permutation();
-            x2 = start_coord.get_ud_edge_permutation();
-            x3 = start_coord.get_slice_edge_permutation();
+            search.x1 = start_coord.get_corner_permutation();
+            search.x2 = start_coord.get_ud_edge_permutation();
+            search.x3 = start_coord.get_slice_edge_permutation();
         }
-        int min_depth = heuristic<PHASE>(x1, x2, x3);
-        
-        std::vector<SearchState> stack;
-        stack.reserve(limit + 1);
-        
-        for (int max_depth = min_depth; max_depth <= limit; ++max_depth) {
+        search.root_h = heuristic<PHASE>(search.x1, search.x2, search.x3);
+        search.max_depth = std::max(search.root_h, first_depth);
+        search.stack.reserve(limit + 1);
+        search.stack.push_back({search.x1, search.x2, search.x3, Move::COUNT, 0, search.root_h});
+        return search;
+    }
+
+    // 返回下一个解 (深度上限内)；搜索空间耗尽时返回 false
+    template<uint8_t PHASE, typename P, typename C>
+    bool ida_next(IdaSearch& search, std::vector<Move>& solution) {
+        if (search.solved_at_start) {
+            search.solved_at_start = false;
+            search.max_depth = search.limit + 1; // 起点即解，不再继续
             solution.clear();
-            solution.resize(limit + 1);
-            stack.clear();
-            stack.push_back({x1, x2, x3, Move::COUNT, 0, min_depth});
+            return true;
+        }
+        auto& phase_stats = stats_.phases[PHASE - 1];
+        while (search.max_depth <= search.limit) {
+            search.path.resize(search.limit + 1);
 
-            if (search_iterative<PHASE>(stack, solution, max_depth, start_coord.AVAILABLE_MOVES)) {
+            uint64_t nodes_before = nodes_expanded_;
+            bool found;
+            if constexpr (P::Frontier::REUSE) {
+                if (!search.frontier.overflowed()) {
+                    uint64_t recorded_before = search.frontier.recorded();
+                    found = frontier_iteration<PHASE, P, C>(search);
+                    phase_stats.frontier_nodes += search.frontier.recorded() - recorded_before;
+                } else {
+                    found = restart_iteration<PHASE, typename P::Restarting, C>(search);
+                }
+            } else {
+                found = restart_iteration<PHASE, P, C>(search);
+            }
+            phase_stats.nodes_per_iteration.push_back(nodes_expanded_ - nodes_before);
+            if (found) {
+                solution = search.path;
                 return true;
             }
+            ++search.max_depth;
+            if constexpr (P::Frontier::REUSE) {
+                if (!search.frontier.overflowed()) {
+                    search.frontier.finish_iteration();
+                    if (search.frontier.overflowed()) {
+                        phase_stats.frontier_overflowed = true;
+                    } else if (search.frontier.exhausted()) {
+                        return false; // 没有被剪掉的节点，更深的迭代也不会有解
+                    }
+                }
+            }
         }
-        
         return false;
     }
 
-    // 迭代搜索的状态结构
-    struct SearchState {
-        uint16_t x1, x2, x3;
-        Move last_move;
-        int depth, h;
-    };
+    // 从根节点开始 (或从中断处继续) 一轮迭代
+    template<uint8_t PHASE, typename P, typename C>
+    bool restart_iteration(IdaSearch& search) {
+        if (search.stack.empty()) {
+            search.stack.push_back({search.x1, search.x2, search.x3, Move::COUNT, 0, search.root_h});
+        }
+        return search_iterative<PHASE, P>(search.stack, search.path, search.max_depth, C::AVAILABLE_MOVES);
+    }
 
-    template<uint8_t PHASE, size_t N>
-    bool search_iterative(std::vector<SearchState>& stack, std::vector<Move>& path, int max_depth, std::array<Move, N> MOVES) {
-        const int ENDGAME_DB_MAX_DEPTH = []() {
-            if constexpr (PHASE == 1) {
-                return 6;
-            } else if constexpr (PHASE == 2) {
-                return 7;
+    // 依次从本轮的起始节点 (第一轮为根节点，之后为上一轮的前沿) 搜索，同时记录本轮的前沿
+    template<uint8_t PHASE, typename P, typename C>
+    bool frontier_iteration(IdaSearch& search) {
+        // 第一轮的根节点已由 start_ida 压入栈中，此时前沿为空
+        for (;;) {
+            if (search.stack.empty()) {
+                IdaFrontier::Node node;
+                if (!search.frontier.next(node, search.path)) {
+                    return false;
+                }
+                search.stack.push_back({node.x1, node.x2, node.x3, node.last_move, node.depth, node.h});
             }
-        }();
+            if (search_iterative<PHASE, P>(search.stack, search.path, search.max_depth, C::AVAILABLE_MOVES, &search.frontier)) {
+                return true;
+            }
+        }
+    }
+
+    template<uint8_t PHASE, typename P, typename C>
+    bool ida_star(const C& start_coord, std::vector<Move>& solution, int limit, int first_depth = 0) {
+        IdaSearch search = start_ida<PHASE>(start_coord, limit, first_depth);
+        return ida_next<PHASE, P, C>(search, solution);
+    }
+
+    // 每展开 CANCEL_CHECK_MASK + 1 个节点检查一次取消标志
+    static constexpr uint64_t CANCEL_CHECK_MASK = 255;
+
+    // ReuseFrontier 策略下，超出 max_depth 的子节点也压入栈中，出栈时记入 frontier 而不展开
+    template<uint8_t PHASE, typename P = DefaultSearchPolicies, size_t N>
+    bool search_iterative(std::vector<SearchState>& stack, std::vector<Move>& path, int max_depth, std::array<Move, N> MOVES,
+                          IdaFrontier* frontier = nullptr) {
+        const int ENDGAME_DB_MAX_DEPTH = tables_.endgame_db_depth<PHASE>();
+        const int probe_depth = probe_depth_[PHASE - 1];
+        // 终局数据库仍在后台加载时退化为纯IDA*搜索
+        const bool use_endgame_db = tables_.is_endgame_db_ready<PHASE>();
 
         while (!stack.empty()) {
             auto current = stack.back();
             stack.pop_back();
+            if constexpr (P::Frontier::REUSE) {
+                frontier->leave(current.depth);
+                if (current.depth + current.h > max_depth) {
+                    frontier->record({current.x1, current.x2, current.x3, current.last_move,
+                                      static_cast<uint8_t>(current.depth), static_cast<uint8_t>(current.h), 0}, path);
+                    continue;
+                }
+            }
+            ++nodes_expanded_;
+            if (cancel_ && (nodes_expanded_ & CANCEL_CHECK_MASK) == 0 && cancel_->load(std::memory_order_relaxed)) {
+                throw SolveCancelled();
+            }
 
             path[current.depth] = current.last_move;
-            if (current.h <= ENDGAME_DB_MAX_DEPTH) {
+            if (use_endgame_db && current.h <= probe_depth) {
                 std::vector<Move> endgame_path;
                 
+                ++stats_.phases[PHASE - 1].endgame_probes;
                 if (tables_.search_endgame_db<PHASE>(current.x1, current.x2, current.x3, endgame_path)) {
-                    std::cout << "Found endgame solution for (" 
-                              << current.x1 << ", " << current.x2 << ", " << current.x3 << ") at depth " 
-                              << current.depth 
-                              << " in maxdepth " << max_depth
-                              << " with " << endgame_path.size() << " moves."
-                              << std::endl;
+                    ++stats_.phases[PHASE - 1].endgame_hits;
+                    if (verbose_) {
+                        std::cout << "Found endgame solution for (" 
+                                  << current.x1 << ", " << current.x2 << ", " << current.x3 << ") at depth " 
+                                  << current.depth 
+                                  << " in maxdepth " << max_depth
+                                  << " with " << endgame_path.size() << " moves."
+                                  << std::endl;
+                    }
 
                     path.resize(current.depth + 1);
                     path.insert(path.end(), endgame_path.begin(), endgame_path.end());
                     return true;
                 }
-                // 增强启发函数，会严格限制解的长度
-                // 不开启增强可以获得长度大于当前max_depth的解，可以提前获得深度更高时才能获得的解
-#ifdef USE_ENHANCED_HEURISTIC
-                if (current.depth + ENDGAME_DB_MAX_DEPTH > max_depth) {
-                    continue; // 超过最大深度，跳过
-                } else {
-                    current.h = ENDGAME_DB_MAX_DEPTH + 1;
+                // 未命中说明距离大于数据库深度，据此剪枝会严格限制解的长度
+                // 不剪枝可以获得长度大于当前max_depth的解，可以提前获得深度更高时才能获得的解
+                if constexpr (P::Endgame::CLAMP) {
+                    if (current.depth + ENDGAME_DB_MAX_DEPTH > max_depth) {
+                        if constexpr (P::Frontier::REUSE) {
+                            // 下一轮以数据库深度 + 1 作为启发值从这里继续，不再重复查询
+                            frontier->record({current.x1, current.x2, current.x3, current.last_move,
+                                              static_cast<uint8_t>(current.depth),
+                                              static_cast<uint8_t>(ENDGAME_DB_MAX_DEPTH + 1), 0}, path);
+                        }
+                        continue; // 超过最大深度，跳过
+                    } else {
+                        current.h = ENDGAME_DB_MAX_DEPTH + 1;
+                    }
                 }
-#endif
             }
             
             if (current.x1 == 0 && current.x2 == 0 && current.x3 == 0) {
@@ -113,6 +351,9 @@ private:
             // 基于启发值，对所有可能的移动进行排序，优先搜索启发值低的移动
             std::array<SearchState, 18> scored_moves;
             int valid_moves = 0;
+            // 超出本轮上限的子节点 (只在 ReuseFrontier 时保留)，排在本轮可展开的子节点之后
+            std::array<SearchState, 18> deferred_moves;
+            int deferred = 0;
             
             for (Move move : MOVES) {
                 if (!is_valid_move(move, current.last_move)) {
@@ -122,19 +363,22 @@ private:
                 uint16_t next_x1 = current.x1, next_x2 = current.x2, next_x3 = current.x3;
                 get_next_coord<PHASE>(next_x1, next_x2, next_x3, move);
 
-#ifdef USE_ENHANCED_HEURISTIC
-                int next_h = std::max(heuristic<PHASE>(next_x1, next_x2, next_x3), static_cast<uint8_t>(current.h - 1));
-#else
-                int next_h = heuristic<PHASE>(next_x1, next_x2, next_x3);
-#endif
+                int next_h = P::Heuristic::child_h(heuristic<PHASE>(next_x1, next_x2, next_x3), current.h);
                 if (current.depth + 1 + next_h <= max_depth) {
                     scored_moves[valid_moves++] = {next_x1, next_x2, next_x3, move, current.depth + 1, next_h};
+                } else if constexpr (P::Frontier::REUSE) {
+                    deferred_moves[deferred++] = {next_x1, next_x2, next_x3, move, current.depth + 1, next_h};
                 }
             }
             
-            std::sort(scored_moves.begin(), scored_moves.begin() + valid_moves,
-                     [](const auto& a, const auto& b) { return a.h < b.h; });
-            
+            P::Ordering::order(scored_moves.begin(), scored_moves.begin() + valid_moves);
+            if constexpr (P::Frontier::REUSE) {
+                P::Ordering::order(deferred_moves.begin(), deferred_moves.begin() + deferred);
+                for (int i = deferred - 1; i >= 0; --i) {
+                    stack.push_back(deferred_moves[i]);
+                }
+            }
+
             // 按排序后的顺序添加到栈中（逆序，因为栈是LIFO）
             for (int i = valid_moves - 1; i >= 0; --i) {
                 stack.push_back(std::move(scored_moves[i]));
@@ -172,6 +416,51 @@ private:
     inline bool is_valid_move(Move current, Move last) const;
 };
 
+inline uint8_t Solver::heuristic_phase1(const Phase1Coord& coord) const {
+    return tables_.get_phase1_pruning(coord);
+}
+
+inline uint8_t Solver::heuristic_phase2(const Phase2Coord& coord) const {
+    return tables_.get_phase2_pruning(coord);
+}
+
+inline uint8_t Solver::heuristic_phase1(uint16_t x1, uint16_t x2, uint16_t x3) const {
+    if (combined_phase1_) {
+        // 组合表的值不小于对应的单坐标表
+        return std::max(tables_.get_co_uds_pruning(x1, x3), tables_.get_eo_uds_pruning(x2, x3));
+    }
+    uint8_t h1 = tables_.get_co_pruning(x1);
+    uint8_t h2 = tables_.get_eo_pruning(x2);
+    uint8_t h3 = tables_.get_uds_pruning(x3);
+    
+    return std::max({h1, h2, h3});
+}
+
+inline uint8_t Solver::heuristic_phase2(uint16_t x1, uint16_t x2, uint16_t x3) const {
+    if (combined_phase2_) {
+        return std::max(tables_.get_cp_sep_pruning(x1, x3), tables_.get_udep_sep_pruning(x2, x3));
+    }
+    uint8_t h1 = tables_.get_cp_pruning(x1);
+    uint8_t h2 = tables_.get_udep_pruning(x2);
+    uint8_t h3 = tables_.get_sep_pruning(x3);
+    
+    return std::max({h1, h2, h3});
+}
+
+inline bool Solver::is_valid_move(Move current, Move last) const {
+    if (last == Move::COUNT) return true; // 第一步
+    
+    uint8_t current_face = static_cast<uint8_t>(get_face(current));
+    uint8_t last_face = static_cast<uint8_t>(get_face(last));
+    
+    // 同一面的连续转动可以合并为一次转动
+    if (current_face == last_face) {
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace RubiksSolver
 
 #endif // SOLVER_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef STATIC_TABLES_H
+#define STATIC_TABLES_H
+
+#include "coordinate.h"
+#include "table_storage.h"
+#include <array>
+#include <cstdint>
+
+namespace RubiksSolver {
+
+// 编译期生成的小表
+// 第一阶段的三个移动表/剪枝表和中层棱块排列表都很小，直接在编译期计算，
+// 存放在只读段中，启动时没有任何开销；表大小在编译期已知，热点循环也无需经过指针间接访问
+namespace StaticTables {
+
+// 填充移动表：C::AVAILABLE_MOVES 之外的列保持为0
+// 只直接计算每个面的第一种转动，其余转动由查表复合得到，以减少计算量
+// (U2 = U' = U*U*U，U3 = U2 = U*U；第二阶段中 F3 等180度转动本身就是首个可用转动)
+// next 为 coordinate.h 中的坐标层面转动函数；编译期和运行时 (TableManager) 共用
+template<typename C, size_t N, typename Next>
+constexpr void fill_move_table(MoveTable<N>& table, Next&& next) {
+    std::array<bool, 18> available{};
+    for (auto move : C::AVAILABLE_MOVES) {
+        available[static_cast<int>(move)] = true;
+    }
+
+    for (int face = 0; face < 6; ++face) {
+        int base = face * 3;
+        if (available[base]) {
+            for (uint16_t i = 0; i < N; ++i) {
+                table[i][base] = next(i, static_cast<Move>(base));
+            }
+            for (uint16_t i = 0; i < N; ++i) {
+                uint16_t once = table[i][base];
+                uint16_t twice = table[once][base];
+                table[i][base + 2] = twice;
+                table[i][base + 1] = table[twice][base];
+            }
+        } else if (available[base + 2]) {
+            for (uint16_t i = 0; i < N; ++i) {
+                table[i][base + 2] = next(i, static_cast<Move>(base + 2));
+            }
+        }
+    }
+}
+
+template<typename C, size_t N, typename Next>
+constexpr MoveTable<N> make_move_table(Next&& next) {
+    MoveTable<N> table{};
+    fill_move_table<C, N>(table, next);
+    return table;
+}
+
+// 从目标状态开始广度优先搜索，生成剪枝表
+template<typename C, size_t N>
+constexpr PruningTable<N> make_pruning_table(const MoveTable<N>& move_table) {
+    PruningTable<N> table{};
+    for (auto& depth : table) depth = 0xFF; // 0xFF 代表 "未访问"
+
+    std::array<uint16_t, N> queue{};
+    size_t head = 0, tail = 0;
+
+    table[0] = 0;
+    queue[tail++] = 0;
+    while (head < tail) {
+        uint16_t current = queue[head++];
+        for (auto move : C::AVAILABLE_MOVES) {
+            uint16_t next = move_table[current][static_cast<int>(move)];
+            if (table[next] == 0xFF) {
+                table[next] = table[current] + 1;
+                queue[tail++] = next;
+            }
+        }
+    }
+    return table;
+}
+
+// 移动表
+extern const MoveTable<2187> CO_MOVE_TABLE;
+extern const MoveTable<2048> EO_MOVE_TABLE;
+extern const MoveTable<495> UDS_MOVE_TABLE;
+extern const MoveTable<24> SEP_MOVE_TABLE;
+// 第二阶段坐标追踪用的位置移动表 (Phase2Tracking)，所有18列都有效
+extern const MoveTable<Phase2Tracking::CORNER_POSITIONS> CORNER_POSITIONS_MOVE_TABLE;
+extern const MoveTable<Phase2Tracking::EDGE_POSITIONS> EDGE_POSITIONS_MOVE_TABLE;
+
+// 剪枝表
+extern const PruningTable<2187> CO_PRUNING_TABLE;
+extern const PruningTable<2048> EO_PRUNING_TABLE;
+extern const PruningTable<495> UDS_PRUNING_TABLE;
+extern const PruningTable<24> SEP_PRUNING_TABLE;
+
+} // namespace StaticTables
+
+} // namespace RubiksSolver
+
+#endif // STATIC_TABLES_H
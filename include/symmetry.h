@@ -0,0 +1,42 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "cube.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 魔方的48个对称 (24个整体旋转 × 是否镜像)
+// 每个对称是一个带符号的 3x3 置换矩阵 (x 指向 R，y 指向 U，z 指向 F)，作用在色块的空间位置上；
+// 颜色随之重新标记，使各面中心保持原来的颜色。这等价于对魔方状态做共轭 S * C * S^-1
+inline constexpr int SYMMETRY_COUNT = 48;
+
+struct Symmetry {
+    std::array<std::array<int8_t, 3>, 3> matrix;
+    std::array<uint8_t, 54> facelet_target; // 色块 i 变换后所在的下标
+    std::array<uint8_t, 6> face_map;        // 面 f (U R F D L B) 变换后对应的面
+    std::array<Move, 18> move_map;          // 满足 T(C * m) == T(C) * move_map[m]
+    uint8_t inverse;                        // 逆对称的编号
+    bool reflection;
+};
+
+// 编号 0 是恒等对称
+const std::array<Symmetry, SYMMETRY_COUNT>& symmetries();
+
+// 每个色块所属的面 (0..5 对应 U R F D L B)，布局与 Cube::to_facelets 相同
+using FaceletFaces = std::array<uint8_t, 54>;
+
+FaceletFaces facelet_faces(const Cube& cube);
+FaceletFaces apply_symmetry(const Symmetry& symmetry, const FaceletFaces& faces);
+
+// 变换后的魔方状态
+Cube conjugate(const Cube& cube, const Symmetry& symmetry);
+
+// 把一个转动序列变换到对称后的坐标系
+std::vector<Move> map_moves(const Symmetry& symmetry, const std::vector<Move>& moves);
+
+} // namespace RubiksSolver
+
+#endif // SYMMETRY_H
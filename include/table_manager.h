@@ -1,31 +1,77 @@
 #ifndef TABLE_MANAGER_H
 #define TABLE_MANAGER_H
 
+#include "compact_pruning_table.h"
 #include "coordinate.h"
+#include "endgame_table.h"
 #include "moves.h"
 #include "persistence.h"
+#include "static_tables.h"
+#include "table_residency.h"
+#include "table_storage.h"
+#include "table_tiers.h"
 #include <array>
+#include <atomic>
+#include <future>
 #include <string>
 #include <functional>
 #include <queue>
+#include <thread>
+#include <vector>
 
 namespace RubiksSolver {
 
+// 分阶段初始化的表分组
+// 第一阶段的表在 get_instance() 返回前就绪，其余在后台线程中加载
+enum class TableGroup : uint8_t {
+    Phase1,         // 第一阶段移动表和剪枝表 (编译期生成，始终就绪)
+    Phase2,         // 第二阶段移动表和剪枝表
+    Phase1Endgame,  // 第一阶段终局数据库
+    Phase2Endgame,  // 第二阶段终局数据库
+    Combined,       // 按档位启用的组合剪枝表 (未启用时立即就绪)
+    COUNT
+};
+
+// 一张 (或一组) 表的内存占用和所在位置
+struct TableFootprint {
+    std::string name;
+    size_t bytes;
+    Residency residency;
+};
+
 class TableManager {
 public:
     // 获取单例实例
     static const TableManager& get_instance();
+    // 指定单例使用的表档位，必须在第一次 get_instance() 之前调用；
+    // 未调用时由环境变量 RUBIKS_TABLE_BUDGET 决定 (见 TableTiers::from_environment)
+    static void configure(const TableTiers& tiers);
+
+    inline const TableTiers& tiers() const { return tiers_; }
+
+    // 生成第二阶段的大型移动表和剪枝表并保存到指定目录 (供构建时的 table_generator 使用)
+    static void generate_core_tables(const std::string& dir);
+
+    ~TableManager();
+
+    // 查询某组表是否已经就绪 (不阻塞)
+    inline bool is_ready(TableGroup group) const {
+        return ready_flags_[static_cast<size_t>(group)].load(std::memory_order_acquire);
+    }
+    // 阻塞直到某组表就绪，后台加载失败时抛出对应异常
+    void wait_until_ready(TableGroup group) const;
+    void wait_until_all_ready() const;
 
     // 移动表查询
     // Phase 1
     inline uint16_t get_co_move(uint16_t coord, Move m) const {
-        return co_move_table[coord][static_cast<uint8_t>(m)];
+        return StaticTables::CO_MOVE_TABLE[coord][static_cast<uint8_t>(m)];
     }
     inline uint16_t get_eo_move(uint16_t coord, Move m) const {
-        return eo_move_table[coord][static_cast<uint8_t>(m)];
+        return StaticTables::EO_MOVE_TABLE[coord][static_cast<uint8_t>(m)];
     }
     inline uint16_t get_uds_move(uint16_t coord, Move m) const {
-        return uds_move_table[coord][static_cast<uint8_t>(m)];
+        return StaticTables::UDS_MOVE_TABLE[coord][static_cast<uint8_t>(m)];
     }
     // Phase 2
     inline uint16_t get_cp_move(uint16_t coord, Move m) const {
@@ -35,18 +81,18 @@ public:
         return udep_move_table[coord][static_cast<uint8_t>(m)];
     }
     inline uint16_t get_sep_move(uint16_t coord, Move m) const {
-        return sep_move_table[coord][static_cast<uint8_t>(m)];
+        return StaticTables::SEP_MOVE_TABLE[coord][static_cast<uint8_t>(m)];
     }
 
     // 剪枝表查询
     inline uint8_t get_co_pruning(uint16_t co_coord) const {
-        return co_pruning_table[co_coord];
+        return StaticTables::CO_PRUNING_TABLE[co_coord];
     }
     inline uint8_t get_eo_pruning(uint16_t eo_coord) const {
-        return eo_pruning_table[eo_coord];
+        return StaticTables::EO_PRUNING_TABLE[eo_coord];
     }
     inline uint8_t get_uds_pruning(uint16_t uds_coord) const {
-        return uds_pruning_table[uds_coord];
+        return StaticTables::UDS_PRUNING_TABLE[uds_coord];
     }
 
     inline uint8_t get_cp_pruning(uint16_t cp_coord) const {
@@ -56,16 +102,34 @@ public:
         return udep_pruning_table[udep_coord];
     }
     inline uint8_t get_sep_pruning(uint16_t sep_coord) const {
-        return sep_pruning_table[sep_coord];
+        return StaticTables::SEP_PRUNING_TABLE[sep_coord];
+    }
+
+    // 组合剪枝表，仅在 has_combined_pruning 为 true 时可用
+    template<uint8_t PHASE>
+    inline bool has_combined_pruning() const {
+        return (PHASE == 1 ? tiers_.phase1_combined : tiers_.phase2_combined) && is_ready(TableGroup::Combined);
+    }
+    inline uint8_t get_co_uds_pruning(uint16_t co_coord, uint16_t uds_coord) const {
+        return co_uds_pruning_table[static_cast<size_t>(co_coord) * 495 + uds_coord];
+    }
+    inline uint8_t get_eo_uds_pruning(uint16_t eo_coord, uint16_t uds_coord) const {
+        return eo_uds_pruning_table[static_cast<size_t>(eo_coord) * 495 + uds_coord];
+    }
+    inline uint8_t get_cp_sep_pruning(uint16_t cp_coord, uint16_t sep_coord) const {
+        return cp_sep_pruning_table[static_cast<size_t>(cp_coord) * 24 + sep_coord];
+    }
+    inline uint8_t get_udep_sep_pruning(uint16_t udep_coord, uint16_t sep_coord) const {
+        return udep_sep_pruning_table[static_cast<size_t>(udep_coord) * 24 + sep_coord];
     }
     
     // 批量查询
     inline void get_phase1_moves(uint16_t co, uint16_t eo, uint16_t uds, Move m,
                                  uint16_t& new_co, uint16_t& new_eo, uint16_t& new_uds) const {
         uint8_t move_idx = static_cast<uint8_t>(m);
-        new_co = co_move_table[co][move_idx];
-        new_eo = eo_move_table[eo][move_idx];
-        new_uds = uds_move_table[uds][move_idx];
+        new_co = StaticTables::CO_MOVE_TABLE[co][move_idx];
+        new_eo = StaticTables::EO_MOVE_TABLE[eo][move_idx];
+        new_uds = StaticTables::UDS_MOVE_TABLE[uds][move_idx];
     }
     
     inline void get_phase2_moves(uint16_t cp, uint16_t udep, uint16_t sep, Move m,
@@ -73,68 +137,134 @@ public:
         uint8_t move_idx = static_cast<uint8_t>(m);
         new_cp = cp_move_table[cp][move_idx];
         new_udep = udep_move_table[udep][move_idx];
-        new_sep = sep_move_table[sep][move_idx];
+        new_sep = StaticTables::SEP_MOVE_TABLE[sep][move_idx];
+    }
+    
+    // 第二阶段坐标追踪的一次转动 (两张编译期生成的位置移动表，对所有18种转动都有意义)
+    inline Phase2Tracking get_tracking_move(const Phase2Tracking& tracking, Move m) const {
+        return tracking.after(m,
+            [](Coord c, Move move) { return StaticTables::CORNER_POSITIONS_MOVE_TABLE[c][static_cast<uint8_t>(move)]; },
+            [](Coord c, Move move) { return StaticTables::EDGE_POSITIONS_MOVE_TABLE[c][static_cast<uint8_t>(move)]; });
+    }
+    // 沿第一阶段的解追踪，返回到达的G1状态的第二阶段坐标 (每步查表，不需要重放完整的魔方)
+    inline Phase2Coord track_phase2(Phase2Tracking tracking, const Move* moves, size_t count) const {
+        for (size_t i = 0; i < count; ++i) {
+            tracking = get_tracking_move(tracking, moves[i]);
+        }
+        return tracking.to_phase2();
     }
     
     // 复合启发函数 - 取最大值
     uint8_t get_phase1_pruning(const Phase1Coord& coord) const;
     uint8_t get_phase2_pruning(const Phase2Coord& coord) const;
 
+    template<uint8_t PHASE>
+    inline bool is_endgame_db_ready() const {
+        return is_ready(PHASE == 1 ? TableGroup::Phase1Endgame : TableGroup::Phase2Endgame);
+    }
+
     // 获取Phase1或Phase2的终局数据库
+    // 数据库仍在后台加载时视为未命中
     template<uint8_t PHASE>
     inline bool search_endgame_db(uint16_t x1, uint16_t x2, uint16_t x3, std::vector<Move>& path) const {
-        const auto& endgame_db = get_endgame_db<PHASE>();
-
-        uint64_t key = get_key(x1, x2, x3);
+        if (!is_endgame_db_ready<PHASE>()) {
+            return false;
+        }
+        return get_endgame_db<PHASE>().find(get_key(x1, x2, x3), path);
+    }
 
-        auto it = endgame_db.find(key);
-        if (it != endgame_db.end()) {
-            path = it->second;
-            return true;
+    template<uint8_t PHASE>
+    inline void prefetch_endgame_db(uint16_t x1, uint16_t x2, uint16_t x3) const {
+        if (is_endgame_db_ready<PHASE>()) {
+            get_endgame_db<PHASE>().prefetch(get_key(x1, x2, x3));
         }
-        return false;
     }
-    
+
+    // 终局数据库中路径的最大长度：距离不超过它的状态都在数据库中
+    template<uint8_t PHASE>
+    inline int endgame_db_depth() const {
+        return PHASE == 1 ? tiers_.p1_endgame_depth : tiers_.p2_endgame_depth;
+    }
+
+    // 终局数据库中的状态数
+    template<uint8_t PHASE>
+    inline size_t endgame_db_entries() const {
+        return is_endgame_db_ready<PHASE>() ? get_endgame_db<PHASE>().size() : 0;
+    }
+    // 终局数据库占用的字节数
+    template<uint8_t PHASE>
+    inline size_t endgame_db_bytes() const {
+        return is_endgame_db_ready<PHASE>() ? get_endgame_db<PHASE>().bytes() : 0;
+    }
+
+    // 各张表的原始数据，供一次查询多个状态的批量 (SIMD gather) 查询使用
+    // 移动表为 [坐标][18] 的 uint16_t 数组；组合剪枝表在对应档位关闭时为空指针
+    struct RawTables {
+        const uint16_t* co_move;
+        const uint16_t* eo_move;
+        const uint16_t* uds_move;
+        const uint16_t* cp_move;
+        const uint16_t* udep_move;
+        const uint16_t* sep_move;
+        const uint8_t* co_pruning;
+        const uint8_t* eo_pruning;
+        const uint8_t* uds_pruning;
+        const uint8_t* cp_pruning;
+        const uint8_t* udep_pruning;
+        const uint8_t* sep_pruning;
+        const uint8_t* co_uds_pruning;
+        const uint8_t* eo_uds_pruning;
+        const uint8_t* cp_sep_pruning;
+        const uint8_t* udep_sep_pruning;
+        bool combined_packed;
+    };
+    // 需要第二阶段的表已就绪
+    RawTables raw_tables() const;
+
+    // 各张表的内存占用和驻留方式；后台线程加载时会追加记录，所以两者都先等待全部表就绪
+    // (后台加载失败时抛出加载时的异常)
+    const std::vector<TableFootprint>& footprint() const;
+    void print_footprint(std::ostream& out) const;
 
 private:
-    template<uint16_t N>
-    using MoveTable = std::array<std::array<uint16_t, 18>, N>;
-    template<uint16_t N>
-    using PruningTable = std::array<uint8_t, N>;
     using EndgameDB = std::unordered_map<uint64_t, std::vector<Move>>;
 
-    TableManager();
+    explicit TableManager(const TableTiers& tiers);
+    // 仅构造空的表管理器，不加载任何表
+    struct Deferred {};
+    explicit TableManager(Deferred);
 
     void initialize();
+    // 后台线程：加载剩余的表并逐组标记就绪
+    void load_in_background(bool load_phase2_tables);
+    void mark_ready(TableGroup group);
+
+    // 绑定构建时内嵌于可执行文件的移动表和剪枝表
+    bool bind_embedded_tables();
+
+    void load_or_generate_phase2_tables(const std::string& dir);
+    // 按驻留配置把第二阶段的表移到大页或共享内存中并重新绑定，source 为当前所在位置
+    void place_phase2_tables(Residency source);
+    // 共享内存段名，未配置共享内存时为空
+    std::string shared_name(const std::string& table) const;
+    template<uint8_t PHASE>
+    void load_or_generate_endgame_db(const std::string& dir);
+    // 按档位生成组合剪枝表
+    void generate_combined_pruning_tables();
 
-    // 生成移动表
-    template<typename C, typename Set, typename Get, size_t N>
-    void generate_move_table(
-                    const std::string& name, 
-                    MoveTable<N>& table, 
-                    Set&& set, 
-                    Get&& get) {
-        std::cout << "Generating " << name << " Move Table..." << std::endl;
-        C coord;
-        for (uint16_t i = 0; i < N; ++i) {
-            set(coord, i);
-
-            for (auto move : coord.AVAILABLE_MOVES) {
-                C temp_coord = coord;
-                temp_coord.apply_move(move);
+    void generate_phase2_tables();
+    void save_phase2_tables(const std::string& dir) const;
 
-                table[i][static_cast<int>(move)] = get(temp_coord);
-            }
-        }
+    // 生成移动表 (与编译期小表共用 StaticTables::fill_move_table)
+    template<typename C, size_t N, typename Next>
+    void generate_move_table(const std::string& name, MoveTable<N>& table, Next&& next) {
+        std::cout << "Generating " << name << " Move Table..." << std::endl;
+        StaticTables::fill_move_table<C, N>(table, next);
         std::cout << name << " Move Table generated." << std::endl;
     }
 
-    void generate_co_move_table();
-    void generate_eo_move_table();
-    void generate_uds_move_table();
     void generate_cp_move_table();
     void generate_udep_move_table();
-    void generate_sep_move_table();
 
     // 生成剪枝表
     template<typename C, typename Get, size_t SIZE>
@@ -182,7 +312,7 @@ private:
     
     // 生成终局数据库
     template<uint8_t PHASE, typename C>
-    void generate_endgame_db() {
+    void generate_endgame_db(EndgameDB& endgame_db) {
 
         const int MAX_DEPTH = []() {
             if constexpr (PHASE == 1) {
@@ -196,8 +326,6 @@ private:
 
         std::queue<std::tuple<uint16_t, uint16_t, uint16_t, std::vector<Move>>> q;
 
-        auto& endgame_db = get_endgame_db<PHASE>();
-        
         endgame_db[0] = std::vector<Move>();
         q.push({0, 0, 0, std::vector<Move>()});
 
@@ -267,24 +395,36 @@ private:
         }
     }
 
-    // 移动表
-    MoveTable<2187> co_move_table;
-    MoveTable<2048> eo_move_table;
-    MoveTable<495> uds_move_table;
-    MoveTable<40320> cp_move_table;
-    MoveTable<40320> udep_move_table;
-    MoveTable<24> sep_move_table;
+    // 第二阶段的大型移动表 (第一阶段和中层棱块的表见 StaticTables)
+    TableStorage<MoveTable<40320>> cp_move_table;
+    TableStorage<MoveTable<40320>> udep_move_table;
     
-    // 剪枝表
-    PruningTable<2187> co_pruning_table;
-    PruningTable<2048> eo_pruning_table;
-    PruningTable<495> uds_pruning_table;
-    PruningTable<40320> cp_pruning_table;
-    PruningTable<40320> udep_pruning_table;
-    PruningTable<24> sep_pruning_table;
-    // 反向索引表
-    EndgameDB p1_endgame_db;
-    EndgameDB p2_endgame_db;
+    // 第二阶段的大型剪枝表
+    TableStorage<PruningTable<40320>> cp_pruning_table;
+    TableStorage<PruningTable<40320>> udep_pruning_table;
+    // 组合剪枝表
+    CompactPruningTable co_uds_pruning_table;
+    CompactPruningTable eo_uds_pruning_table;
+    CompactPruningTable cp_sep_pruning_table;
+    CompactPruningTable udep_sep_pruning_table;
+
+    // 反向索引表 (数据在 endgame_regions_ 中)
+    EndgameTable p1_endgame_db;
+    EndgameTable p2_endgame_db;
+
+    TableTiers tiers_;
+    // 驻留配置和按配置分配的内存
+    ResidencyConfig residency_config_;
+    ResidentRegion phase2_region_;
+    std::array<ResidentRegion, 2> endgame_regions_;
+    std::vector<TableFootprint> footprint_;
+
+    // 各组表的就绪状态
+    static constexpr size_t TABLE_GROUP_COUNT = static_cast<size_t>(TableGroup::COUNT);
+    std::array<std::promise<void>, TABLE_GROUP_COUNT> ready_promises_;
+    std::array<std::shared_future<void>, TABLE_GROUP_COUNT> ready_futures_;
+    std::array<std::atomic<bool>, TABLE_GROUP_COUNT> ready_flags_{};
+    std::thread loader_;
 };
 
 } // namespace RubiksSolver
@@ -0,0 +1,82 @@
+#ifndef TABLE_RESIDENCY_H
+#define TABLE_RESIDENCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace RubiksSolver {
+
+// 表所在内存的类型
+enum class Residency : uint8_t {
+    Embedded,        // 可执行文件的只读段 (同一可执行文件的进程共享页缓存)
+    Heap,            // 进程私有的普通 4 KB 页
+    HugePages,       // 进程私有的 2 MB 大页 (MAP_HUGETLB)
+    TransparentHuge, // 进程私有，已 madvise(MADV_HUGEPAGE) 的透明大页
+    SharedCreated,   // 本进程创建并发布的命名共享内存
+    SharedAttached   // 只读附加到其他进程发布的命名共享内存
+};
+
+const char* residency_name(Residency residency);
+
+// 表驻留方式的配置，默认从环境变量读取：
+//   RUBIKS_HUGE_PAGES=1     大型表放入 2 MB 大页
+//   RUBIKS_SHM_NAME=<前缀>  大型表发布到命名共享内存 /<前缀>-<表名>，之后启动的进程只读附加
+struct ResidencyConfig {
+    bool huge_pages = false;
+    std::string shm_name;
+
+    static ResidencyConfig from_environment();
+};
+
+// 一块存放只读表的匿名或共享内存映射 (只能移动)
+// 共享内存段以一个页大小的头开始，记录格式版本、数据大小和发布状态；创建者填充数据后调用 publish()，
+// 附加方等待发布完成后以只读方式映射。创建者在发布前析构 (例如加载失败) 时删除该段，避免附加方一直等待；
+// 创建者从创建到发布一直持有该段的排他 flock，进程崩溃时内核释放锁，附加方据此发现残留的未发布段并删除
+class ResidentRegion {
+public:
+    // attach_shared 的结果
+    enum class AttachStatus : uint8_t {
+        Attached,
+        Missing,  // 段不存在，或者创建者已退出 (残留的段已删除)：调用者可以创建
+        Unusable  // 等待超时或格式不符：调用者应改用进程私有内存，不要再创建或附加
+    };
+
+    ResidentRegion() = default;
+    ~ResidentRegion();
+    ResidentRegion(ResidentRegion&& other) noexcept;
+    ResidentRegion& operator=(ResidentRegion&& other) noexcept;
+    ResidentRegion(const ResidentRegion&) = delete;
+    ResidentRegion& operator=(const ResidentRegion&) = delete;
+
+    // 分配进程私有的可写内存；huge_pages 时依次尝试 MAP_HUGETLB 和 MADV_HUGEPAGE
+    static ResidentRegion allocate(size_t bytes, bool huge_pages);
+    // 创建命名共享内存段；段已存在时返回空区域 (由调用者改为附加)
+    static ResidentRegion create_shared(const std::string& name, size_t bytes, bool huge_pages);
+    // 只读附加已存在的共享内存段，创建者尚未发布时等待；失败时返回空区域，原因见 status
+    static ResidentRegion attach_shared(const std::string& name, AttachStatus& status);
+
+    // 创建者填充完数据后调用：标记为已发布并把映射改为只读
+    void publish();
+
+    inline explicit operator bool() const { return data_ != nullptr; }
+    inline void* data() { return data_; }
+    inline const void* data() const { return data_; }
+    inline size_t size() const { return size_; }
+    inline Residency residency() const { return residency_; }
+
+private:
+    void release();
+
+    void* mapping_ = nullptr;     // 整个映射 (共享内存段包括头)
+    size_t mapping_size_ = 0;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    Residency residency_ = Residency::Heap;
+    std::string unlink_name_;     // 尚未发布的共享内存段名
+    int lock_fd_ = -1;            // 创建者在发布前持有 flock 的文件描述符
+};
+
+} // namespace RubiksSolver
+
+#endif // TABLE_RESIDENCY_H
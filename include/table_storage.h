@@ -0,0 +1,49 @@
+#ifndef TABLE_STORAGE_H
+#define TABLE_STORAGE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace RubiksSolver {
+
+// 移动表：[坐标][转动] -> 新坐标
+template<size_t N>
+using MoveTable = std::array<std::array<uint16_t, 18>, N>;
+// 剪枝表：[坐标] -> 到目标状态的最少步数
+template<size_t N>
+using PruningTable = std::array<uint8_t, N>;
+
+// 表的只读视图
+// 数据可以来自内嵌于可执行文件的只读段，也可以来自运行时加载/生成的堆内存
+template<typename T>
+class TableStorage {
+public:
+    // 绑定外部只读数据（不接管所有权）
+    void bind(const T* data) {
+        owned_.reset();
+        view_ = data;
+    }
+
+    // 分配可写存储，用于从磁盘加载或运行时生成
+    T& allocate() {
+        owned_ = std::make_unique<T>();
+        view_ = owned_.get();
+        return *owned_;
+    }
+
+    inline bool is_bound() const { return view_ != nullptr; }
+
+    inline const T& operator*() const { return *view_; }
+    inline const T* operator->() const { return view_; }
+    inline decltype(auto) operator[](std::size_t i) const { return (*view_)[i]; }
+
+private:
+    const T* view_ = nullptr;
+    std::unique_ptr<T> owned_;
+};
+
+} // namespace RubiksSolver
+
+#endif // TABLE_STORAGE_H
@@ -0,0 +1,50 @@
+#ifndef TABLE_TIERS_H
+#define TABLE_TIERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace RubiksSolver {
+
+// 可选表的档位：在内存和速度之间取舍
+// 第一阶段的小表和第二阶段的移动表/剪枝表始终加载，其余的表按档位构建或加载
+struct TableTiers {
+    static constexpr int MAX_P1_ENDGAME_DEPTH = 6; // 终局数据库中路径的最大长度
+    static constexpr int MAX_P2_ENDGAME_DEPTH = 7;
+
+    // 组合剪枝表的项数
+    static constexpr size_t CO_UDS_ENTRIES = size_t{2187} * 495;
+    static constexpr size_t EO_UDS_ENTRIES = size_t{2048} * 495;
+    static constexpr size_t CP_SEP_ENTRIES = size_t{40320} * 24;
+    static constexpr size_t UDEP_SEP_ENTRIES = size_t{40320} * 24;
+
+    int p1_endgame_depth = MAX_P1_ENDGAME_DEPTH;
+    int p2_endgame_depth = MAX_P2_ENDGAME_DEPTH;
+    bool phase1_combined = true;  // 角块方向×中层位置、棱块方向×中层位置的组合剪枝表
+    bool phase2_combined = true;  // 角块排列×中层排列、UD棱块排列×中层排列的组合剪枝表
+    bool packed = false;          // 组合剪枝表每项4位 (否则每项1字节，查询少一次移位)
+    size_t budget = 0;            // 选择档位所依据的预算，0 表示不限
+
+    // 在预算 (字节) 内选择最快的档位组合；预算连必需的表都放不下时返回最小档位
+    static TableTiers for_budget(size_t budget);
+    // RUBIKS_TABLE_BUDGET=<大小> (如 256M、2G) 时按预算选择，否则为全部档位
+    static TableTiers from_environment();
+    // 解析 "256M"、"2G"、"1048576" 等大小，无法解析时抛出 std::invalid_argument
+    static size_t parse_size(const std::string& text);
+
+    // 必需的表的字节数
+    static size_t required_bytes();
+    // 各可选表的字节数
+    static size_t endgame_bytes(int phase, int depth);
+    size_t phase1_combined_bytes() const;
+    size_t phase2_combined_bytes() const;
+    // 按当前档位所有表的字节数
+    size_t total_bytes() const;
+
+    std::string describe() const;
+};
+
+} // namespace RubiksSolver
+
+#endif // TABLE_TIERS_H
@@ -0,0 +1,114 @@
+#ifndef TWO_PHASE_SEARCH_H
+#define TWO_PHASE_SEARCH_H
+
+#include "coordinate.h"
+#include "moves.h"
+#include "solve_options.h"
+#include "table_manager.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace RubiksSolver {
+
+// 批量求解器 (LockstepSolver、InterleavedSolver、PipelinedSolver) 共用的两阶段搜索部件
+// 与 Solver 默认策略的实现相同，这些求解器才能得到与 Solver 相同的解
+namespace TwoPhaseSearch {
+
+template<uint8_t PHASE>
+constexpr const auto& available_moves() {
+    if constexpr (PHASE == 1) {
+        return Phase1Coord::AVAILABLE_MOVES;
+    } else {
+        return Phase2Coord::AVAILABLE_MOVES;
+    }
+}
+
+// 不连续转动同一个面
+inline bool is_valid_move(Move current, Move last) {
+    return last == Move::COUNT || get_face(current) != get_face(last);
+}
+
+// 与 Solver::heuristic 的默认实现相同：组合剪枝表可用 (combined) 时只用组合表
+template<uint8_t PHASE>
+inline uint8_t pruning(const TableManager& tables, bool combined, uint16_t x1, uint16_t x2, uint16_t x3) {
+    if constexpr (PHASE == 1) {
+        return combined ? std::max(tables.get_co_uds_pruning(x1, x3), tables.get_eo_uds_pruning(x2, x3))
+                        : std::max({tables.get_co_pruning(x1), tables.get_eo_pruning(x2), tables.get_uds_pruning(x3)});
+    } else {
+        return combined ? std::max(tables.get_cp_sep_pruning(x1, x3), tables.get_udep_sep_pruning(x2, x3))
+                        : std::max({tables.get_cp_pruning(x1), tables.get_udep_pruning(x2), tables.get_sep_pruning(x3)});
+    }
+}
+
+// 每次查询组合剪枝表是否可用 (调用方没有在求解开始时记下时使用)
+template<uint8_t PHASE>
+inline uint8_t pruning(const TableManager& tables, uint16_t x1, uint16_t x2, uint16_t x3) {
+    return pruning<PHASE>(tables, tables.has_combined_pruning<PHASE>(), x1, x2, x3);
+}
+
+// 只支持默认的搜索策略开关 (深度上限可以任意)
+inline bool supports(const SolveOptions& options) {
+    SolveOptions plain;
+    plain.limits = options.limits;
+    return options == plain;
+}
+
+struct Node {
+    uint16_t x1, x2, x3;
+    Move last_move;
+    int depth, h;
+};
+
+// 当前 IDA* 的状态
+enum class Status { Running, Found, Exhausted };
+
+// 与 Solver::IdaSearch 相同的可继续的 IDA* 状态 (不记录前沿)
+struct Search {
+    uint16_t x1 = 0, x2 = 0, x3 = 0;
+    int root_h = 0;
+    int max_depth = 0;
+    int limit = 0;
+    bool solved_at_start = false;
+    std::vector<Node> stack;
+    std::vector<Move> path;
+
+    // 从 (x1, x2, x3) 开始新的搜索，深度上限为 limit，第一轮迭代的上限不小于 first_depth
+    template<uint8_t PHASE>
+    void start(const TableManager& tables, bool combined, uint16_t c1, uint16_t c2, uint16_t c3, int depth_limit,
+               int first_depth) {
+        x1 = c1;
+        x2 = c2;
+        x3 = c3;
+        limit = depth_limit;
+        solved_at_start = false;
+        root_h = pruning<PHASE>(tables, combined, c1, c2, c3);
+        max_depth = std::max(root_h, first_depth);
+        stack.clear();
+        stack.push_back({c1, c2, c3, Move::COUNT, 0, root_h});
+    }
+
+    // 与 Solver::ida_next 的循环体相同：继续 (或开始) 当前迭代
+    Status resume() {
+        if (solved_at_start) {
+            solved_at_start = false;
+            max_depth = limit + 1;
+            path.clear();
+            return Status::Found;
+        }
+        if (max_depth > limit) {
+            return Status::Exhausted;
+        }
+        if (stack.empty()) {
+            stack.push_back({x1, x2, x3, Move::COUNT, 0, root_h});
+        }
+        path.resize(limit + 1);
+        return Status::Running;
+    }
+};
+
+} // namespace TwoPhaseSearch
+
+} // namespace RubiksSolver
+
+#endif // TWO_PHASE_SEARCH_H
@@ -1,10 +1,181 @@
 #include "cube.h"
 #include "table_manager.h"
 #include "solver.h"
+#include "batch_solver.h"
+#include "solve_server.h"
 #include <coordinate.h>
+#include <algorithm>
+#include <fstream>
+#include <memory>
 #include <iostream>
+#include <string>
+
+namespace {
+
+void print_cache_stats(const RubiksSolver::SolutionCache& cache) {
+    auto stats = cache.stats();
+    std::cerr << "Cache: " << stats.hits << " hits, " << stats.misses << " misses ("
+              << stats.hit_rate() * 100.0 << "% hit rate), " << stats.entries << "/" << stats.capacity
+              << " entries, " << stats.evictions << " evictions, " << stats.memory_bytes / 1024 << " KiB, "
+              << stats.mean_lookup_ns / 1000.0 << " us mean lookup" << std::endl;
+}
+
+// --cache / --cache-file 的共同处理：快照文件存在时先恢复
+std::unique_ptr<RubiksSolver::SolutionCache> open_cache(size_t entries, const std::string& path) {
+    if (entries == 0) return nullptr;
+    auto cache = std::make_unique<RubiksSolver::SolutionCache>(entries);
+    if (!path.empty() && std::ifstream(path).good()) {
+        size_t restored = cache->load(path);
+        std::cerr << "Restored " << restored << " cached solutions from " << path << std::endl;
+    }
+    return cache;
+}
+
+void close_cache(const RubiksSolver::SolutionCache* cache, const std::string& path) {
+    if (!cache) return;
+    print_cache_stats(*cache);
+    if (!path.empty()) {
+        cache->save(path);
+        std::cerr << "Cache snapshot written to " << path << std::endl;
+    }
+}
+
+void print_usage() {
+    std::cout << "Usage: rubiks_solver                 interactive prompt\n"
+              << "       rubiks_solver --batch [options] solve one scramble or facelet string per line\n\n"
+              << "Batch options:\n"
+              << "  --input <file>        input file, '-' for stdin (default: -)\n"
+              << "  --output <file>       output file (default: stdout)\n"
+              << "  --format <plain|ndjson>  one solution per line, or one JSON object per line (default: plain)\n"
+              << "  --threads <n>         solver threads (default: hardware threads)\n"
+              << "  --unordered           emit results in completion order instead of input order\n"
+              << "  --batch-size <n>      lines per pipeline batch (default: 256)\n"
+              << "  --lockstep            solve each batch with the lockstep solver (8 cubes per step, default policy only)\n"
+              << "  --interleave <k>      solve each batch as k interleaved coroutines per thread (default policy only)\n"
+              << "  --cache <entries>     cache solutions by symmetry class (default: off)\n"
+              << "  --cache-file <file>   restore the cache from this snapshot and save it on exit\n"
+              << "  --policy <p>          search policy: fast (default), short (slower, shorter solutions),\n"
+              << "                        or comma-separated flags pathmax,clamp,natural,frontier\n\n"
+              << "       rubiks_solver --serve [options] solve requests from local clients (default socket /tmp/rubiks_solver.sock)\n\n"
+              << "Server options:\n"
+              << "  --socket <path>       listen on a Unix domain socket\n"
+              << "  --port <n>            listen on 127.0.0.1:<n>\n"
+              << "  --threads <n>         solver threads (default: hardware threads)\n"
+              << "  --max-batch <n>       requests a worker takes per wakeup (default: 32)\n"
+              << "  --max-in-flight <n>   pending requests before replying \"Server busy\" (default: 4096)\n"
+              << "  --cache <entries> / --cache-file <file> / --policy <p>  as in batch mode\n"
+              << "                        JSON requests may override the policy with \"policy\": \"short\"\n";
+}
+
+int run_server_mode(int argc, char* argv[]) {
+    RubiksSolver::ServerOptions options;
+    size_t cache_entries = 0;
+    std::string cache_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--serve") continue;
+        else if (arg == "--socket") options.socket_path = next();
+        else if (arg == "--port") options.tcp_port = std::stoi(next());
+        else if (arg == "--threads") options.threads = std::stoul(next());
+        else if (arg == "--max-batch") options.max_batch = std::max<size_t>(1, std::stoull(next()));
+        else if (arg == "--max-in-flight") options.max_in_flight = std::max<size_t>(1, std::stoull(next()));
+        else if (arg == "--policy") options.policy = RubiksSolver::SolveOptions::parse(next());
+        else if (arg == "--cache") cache_entries = std::stoull(next());
+        else if (arg == "--cache-file") cache_path = next();
+        else throw std::invalid_argument("Unknown option: " + arg);
+    }
+    if (options.socket_path.empty() && options.tcp_port == 0) {
+        options.socket_path = "/tmp/rubiks_solver.sock";
+    }
+
+    const auto& tables = RubiksSolver::TableManager::get_instance();
+    tables.wait_until_all_ready();
+    auto cache = open_cache(cache_entries, cache_path);
+    options.cache = cache.get();
+    RubiksSolver::run_server(tables, options);
+    close_cache(cache.get(), cache_path);
+    return 0;
+}
+
+// 批量模式：表加载等日志输出到标准错误，标准输出只包含结果
+int run_batch_mode(int argc, char* argv[]) {
+    RubiksSolver::BatchOptions options;
+    std::string output_path = "-";
+    size_t cache_entries = 0;
+    std::string cache_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--batch") continue;
+        else if (arg == "--input") options.input_path = next();
+        else if (arg == "--output") output_path = next();
+        else if (arg == "--threads") options.threads = std::stoul(next());
+        else if (arg == "--unordered") options.ordered = false;
+        else if (arg == "--batch-size") options.batch_size = std::stoull(next());
+        else if (arg == "--lockstep") options.lockstep = true;
+        else if (arg == "--interleave") options.interleave = std::stoul(next());
+        else if (arg == "--policy") options.policy = RubiksSolver::SolveOptions::parse(next());
+        else if (arg == "--cache") cache_entries = std::stoull(next());
+        else if (arg == "--cache-file") cache_path = next();
+        else if (arg == "--format") {
+            std::string format = next();
+            if (format == "plain") options.format = RubiksSolver::BatchFormat::Plain;
+            else if (format == "ndjson") options.format = RubiksSolver::BatchFormat::NDJSON;
+            else throw std::invalid_argument("Unknown format: " + format);
+        }
+        else throw std::invalid_argument("Unknown option: " + arg);
+    }
+
+    // 必须在替换缓冲区之前调用：它会重新设置标准流的缓冲区
+    std::ios::sync_with_stdio(false);
+    std::streambuf* stdout_buf = std::cout.rdbuf(std::cerr.rdbuf());
+    std::ostream stdout_stream(stdout_buf);
+    std::ofstream file;
+    if (output_path != "-") {
+        file.open(output_path, std::ios::binary);
+        if (!file) throw std::runtime_error("Cannot write " + output_path);
+    }
+    std::ostream& out = output_path == "-" ? stdout_stream : file;
+
+    const auto& tables = RubiksSolver::TableManager::get_instance();
+    tables.wait_until_all_ready();
+    auto cache = open_cache(cache_entries, cache_path);
+    options.cache = cache.get();
+    auto summary = RubiksSolver::run_batch(tables, options, out);
+    std::cout.rdbuf(stdout_buf);
+
+    double seconds = summary.elapsed_ns / 1e9;
+    std::cerr << "Solved " << summary.solved << "/" << summary.total << " (" << summary.failed << " failed) in "
+              << seconds << " s, " << (seconds > 0 ? summary.total / seconds : 0.0) << " states/s" << std::endl;
+    close_cache(cache.get(), cache_path);
+    return summary.failed == 0 ? 0 : 3;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        std::string first = argv[1];
+        if (first == "--help" || first == "-h") {
+            print_usage();
+            return 0;
+        }
+        try {
+            if (first == "--serve") return run_server_mode(argc, argv);
+            return run_batch_mode(argc, argv);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
-int main() {
     try {
         // 初始化所有表格
         // 第一次运行时需要生成，会比较慢
@@ -15,7 +186,7 @@ int main() {
         std::string scramble;
         
         while (std::cin.good()) {
-            std::cout << "Enter scramble sequence (or 'exit' to quit): ";
+            std::cout << "Enter scramble sequence or 54-character facelet string (or 'exit' to quit): ";
             std::getline(std::cin, scramble);
             if (scramble == "exit") {
                 break;
@@ -26,7 +197,7 @@ int main() {
             }
             try
             {
-                auto cube = RubiksSolver::Cube::from_scramble(scramble);
+                auto cube = RubiksSolver::Cube::parse(scramble);
                 std::cout << "Initial Cube State:\n" << cube << std::endl;
                 
                 std::cout << "Solving..." << std::endl;
@@ -39,7 +210,7 @@ int main() {
                 std::cout << std::endl;
             } catch(const std::invalid_argument& e) {
                 std::cerr << e.what() << '\n';
-                std::cout << "Please enter a valid scramble sequence." << std::endl;
+                std::cout << "Please enter a valid scramble sequence or cube state." << std::endl;
             } catch (const std::exception& e) {
                 std::cerr << "An error occurred: " << e.what() << std::endl;
             }
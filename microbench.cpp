@@ -0,0 +1,456 @@
+#include "cube.h"
+#include "packed_cube.h"
+#include "coordinate.h"
+#include "codec.h"
+#include "table_manager.h"
+#include "solver.h"
+#include "random_state.h"
+#include "bench_common.h"
+#include "json_util.h"
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using RubiksSolver::Bench::Clock;
+using RubiksSolver::Bench::elapsed_ns;
+
+namespace RubiksSolver {
+
+// 直接访问 Solver 私有的启发函数和搜索内核
+class SolverBenchmark {
+public:
+    explicit SolverBenchmark(const TableManager& tables) : solver_(tables, false) {}
+
+    static constexpr size_t SEARCH_STATE_BYTES = sizeof(Solver::SearchState);
+
+    inline uint8_t heuristic_phase1(uint16_t x1, uint16_t x2, uint16_t x3) const {
+        return solver_.heuristic_phase1(x1, x2, x3);
+    }
+    inline uint8_t heuristic_phase2(uint16_t x1, uint16_t x2, uint16_t x3) const {
+        return solver_.heuristic_phase2(x1, x2, x3);
+    }
+
+    // 以固定的最大深度执行一次迭代，返回展开的节点数
+    template<uint8_t PHASE>
+    uint64_t search_fixed_depth(uint16_t x1, uint16_t x2, uint16_t x3, int max_depth) {
+        stack_.clear();
+        path_.assign(max_depth + 1, Move::COUNT);
+        stack_.push_back({x1, x2, x3, Move::COUNT, 0, solver_.heuristic<PHASE>(x1, x2, x3)});
+        uint64_t before = solver_.nodes_expanded();
+        if constexpr (PHASE == 1) {
+            solver_.search_iterative<1>(stack_, path_, max_depth, Phase1Coord::AVAILABLE_MOVES);
+        } else {
+            solver_.search_iterative<2>(stack_, path_, max_depth, Phase2Coord::AVAILABLE_MOVES);
+        }
+        return solver_.nodes_expanded() - before;
+    }
+
+private:
+    Solver solver_;
+    std::vector<Solver::SearchState> stack_;
+    std::vector<Move> path_;
+};
+
+} // namespace RubiksSolver
+
+using namespace RubiksSolver;
+
+namespace {
+
+// 阻止编译器把结果优化掉
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct KernelResult {
+    std::string name;
+    uint64_t ops = 0;
+    double ns_per_op = 0.0;
+    double bytes_per_op = 0.0;   // 每次操作逻辑上读写的字节数
+    uint64_t working_set = 0;    // 随机输入覆盖的数据结构大小
+    std::string note;
+};
+
+struct Options {
+    uint64_t iterations = 1 << 22;
+    uint64_t seed = 1;
+    std::string filter;
+    std::string json_path;
+};
+
+// 随机输入个数：远大于分支预测器的历史长度，又能放进L2缓存
+constexpr size_t INPUTS = 1 << 14;
+
+// 运行 body(i) 共 iterations 次，取3次中最快的一次
+KernelResult run_kernel(const std::string& name, uint64_t iterations, double bytes_per_op, uint64_t working_set,
+                        const std::function<void(uint64_t)>& body_batch) {
+    body_batch(std::min<uint64_t>(iterations, INPUTS)); // 预热
+    uint64_t best = UINT64_MAX;
+    for (int trial = 0; trial < 3; ++trial) {
+        auto start = Clock::now();
+        body_batch(iterations);
+        best = std::min(best, elapsed_ns(start, Clock::now()));
+    }
+    KernelResult result;
+    result.name = name;
+    result.ops = iterations;
+    result.ns_per_op = static_cast<double>(best) / iterations;
+    result.bytes_per_op = bytes_per_op;
+    result.working_set = working_set;
+    return result;
+}
+
+std::vector<Move> random_moves(std::mt19937_64& rng, size_t count, bool phase2_only) {
+    std::vector<Move> moves(count);
+    for (auto& move : moves) {
+        if (phase2_only) {
+            move = Phase2Coord::AVAILABLE_MOVES[rng() % Phase2Coord::AVAILABLE_MOVES.size()];
+        } else {
+            move = static_cast<Move>(rng() % 18);
+        }
+    }
+    return moves;
+}
+
+// G1 内的随机魔方：对复原状态应用随机的第二阶段转动
+std::vector<Cube> random_g1_cubes(std::mt19937_64& rng, size_t count) {
+    std::vector<Cube> cubes(count);
+    for (auto& cube : cubes) {
+        cube.apply_sequence(random_moves(rng, 40, true));
+    }
+    return cubes;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--iterations") options.iterations = std::max<uint64_t>(1, std::stoull(next()));
+        else if (arg == "--seed") options.seed = std::stoull(next());
+        else if (arg == "--filter") options.filter = next();
+        else if (arg == "--json") options.json_path = next();
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: microbench [--iterations n] [--seed s] [--filter substring] [--json file]\n";
+            std::exit(0);
+        }
+        else throw std::invalid_argument("Unknown option: " + arg);
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parse_options(argc, argv);
+
+        const auto& tables = TableManager::get_instance();
+        tables.wait_until_all_ready();
+
+        std::mt19937_64 rng(options.seed);
+        const uint64_t n = options.iterations;
+        const size_t mask = INPUTS - 1;
+
+        // 随机输入
+        std::vector<Move> moves18 = random_moves(rng, INPUTS, false);
+        std::vector<Move> moves10 = random_moves(rng, INPUTS, true);
+        RandomStateGenerator generator(options.seed);
+        std::vector<Cube> cubes = generator.generate(INPUTS);
+        std::vector<Cube> g1_cubes = random_g1_cubes(rng, INPUTS);
+
+        std::vector<Phase1Coord> p1_coords;
+        for (const auto& cube : cubes) p1_coords.emplace_back(cube);
+        std::vector<Phase2Coord> p2_coords;
+        for (const auto& cube : g1_cubes) p2_coords.emplace_back(cube);
+
+        // 终局数据库：命中的键由从目标状态出发的短随机序列生成，未命中的键来自随机状态
+        auto walk = [&](auto&& step, int length, uint16_t& x1, uint16_t& x2, uint16_t& x3, bool phase2) {
+            x1 = x2 = x3 = 0;
+            for (int i = 0; i < length; ++i) {
+                Move m = phase2 ? moves10[rng() & mask] : moves18[rng() & mask];
+                step(x1, x2, x3, m);
+            }
+        };
+        struct Key { uint16_t x1, x2, x3; };
+        std::vector<Key> p1_hits(INPUTS), p1_misses(INPUTS), p2_hits(INPUTS), p2_misses(INPUTS);
+        for (size_t i = 0; i < INPUTS; ++i) {
+            walk([&](uint16_t& a, uint16_t& b, uint16_t& c, Move m) { tables.get_phase1_moves(a, b, c, m, a, b, c); },
+                 1 + rng() % 5, p1_hits[i].x1, p1_hits[i].x2, p1_hits[i].x3, false);
+            walk([&](uint16_t& a, uint16_t& b, uint16_t& c, Move m) { tables.get_phase2_moves(a, b, c, m, a, b, c); },
+                 1 + rng() % 6, p2_hits[i].x1, p2_hits[i].x2, p2_hits[i].x3, true);
+            const auto& p1 = p1_coords[i];
+            p1_misses[i] = {p1.get_corner_orientation(), p1.get_edge_orientation(), p1.get_ud_slice_position()};
+            const auto& p2 = p2_coords[i];
+            p2_misses[i] = {p2.get_corner_permutation(), p2.get_ud_edge_permutation(), p2.get_slice_edge_permutation()};
+        }
+
+        SolverBenchmark bench(tables);
+        std::vector<KernelResult> results;
+        auto selected = [&](const std::string& name) {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        };
+        auto add = [&](KernelResult result, const std::string& note = "") {
+            result.note = note;
+            std::cout << std::left << std::setw(26) << result.name << std::right
+                      << std::fixed << std::setprecision(2) << std::setw(10) << result.ns_per_op << " ns/op"
+                      << std::setw(10) << std::setprecision(0) << result.bytes_per_op << " B/op"
+                      << std::setw(12) << result.working_set << " B working set"
+                      << (note.empty() ? "" : "  (" + note + ")") << std::endl;
+            results.push_back(std::move(result));
+        };
+
+        std::cout << "\nKernel                         ns/op      bytes/op   working set" << std::endl;
+
+        // --- 魔方转动 ---
+        if (selected("cube_apply_move")) {
+            add(run_kernel("cube_apply_move", n, 2.0 * sizeof(Cube), sizeof(Cube), [&](uint64_t count) {
+                Cube cube;
+                for (uint64_t i = 0; i < count; ++i) cube.apply_move(moves18[i & mask]);
+                do_not_optimize(cube);
+            }));
+        }
+        if (selected("packed_apply_move")) {
+            add(run_kernel("packed_apply_move", n, 4.0 * 16 * 2, sizeof(PackedCube) * 19, [&](uint64_t count) {
+                PackedCube cube;
+                for (uint64_t i = 0; i < count; ++i) cube.apply_move(moves18[i & mask]);
+                do_not_optimize(cube);
+            }));
+        }
+
+        // --- 坐标编码/解码 ---
+        if (selected("phase1_encode")) {
+            add(run_kernel("phase1_encode", n, sizeof(Cube) + sizeof(Phase1Coord), INPUTS * sizeof(Cube), [&](uint64_t count) {
+                uint32_t sink = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    Phase1Coord coord(cubes[i & mask]);
+                    sink += coord.get_corner_orientation() ^ coord.get_edge_orientation() ^ coord.get_ud_slice_position();
+                }
+                do_not_optimize(sink);
+            }));
+        }
+        if (selected("phase2_encode")) {
+            add(run_kernel("phase2_encode", n, sizeof(Cube) + sizeof(Phase2Coord), INPUTS * sizeof(Cube), [&](uint64_t count) {
+                uint32_t sink = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    Phase2Coord coord(g1_cubes[i & mask]);
+                    sink += coord.get_corner_permutation() ^ coord.get_ud_edge_permutation() ^ coord.get_slice_edge_permutation();
+                }
+                do_not_optimize(sink);
+            }));
+        }
+        if (selected("phase1_decode")) {
+            add(run_kernel("phase1_decode", n, sizeof(Phase1Coord) + 8 + 12, INPUTS * sizeof(Phase1Coord), [&](uint64_t count) {
+                uint32_t sink = 0;
+                uint8_t co[8], eo[12];
+                for (uint64_t i = 0; i < count; ++i) {
+                    const auto& coord = p1_coords[i & mask];
+                    Codec::unrank_orientation<8, 3>(coord.get_corner_orientation(), co);
+                    Codec::unrank_orientation<12, 2>(coord.get_edge_orientation(), eo);
+                    uint32_t slice = Codec::unrank_combination<4>(coord.get_ud_slice_position());
+                    sink += co[i & 7] + eo[i % 12] + slice;
+                }
+                do_not_optimize(sink);
+            }));
+        }
+        if (selected("phase2_decode")) {
+            add(run_kernel("phase2_decode", n, sizeof(Phase2Coord) + 8 + 8 + 4, INPUTS * sizeof(Phase2Coord), [&](uint64_t count) {
+                uint32_t sink = 0;
+                uint8_t cp[8], udep[8], sep[4];
+                for (uint64_t i = 0; i < count; ++i) {
+                    const auto& coord = p2_coords[i & mask];
+                    Codec::unrank_permutation<8>(coord.get_corner_permutation(), cp);
+                    Codec::unrank_permutation<8>(coord.get_ud_edge_permutation(), udep);
+                    Codec::unrank_permutation<4>(coord.get_slice_edge_permutation(), sep, 8);
+                    sink += cp[i & 7] + udep[(i >> 3) & 7] + sep[i & 3];
+                }
+                do_not_optimize(sink);
+            }));
+        }
+
+        // --- 两阶段交接：由第一阶段的解 (这里为10步) 得到第二阶段的起始坐标 ---
+        // 起始状态 = G1 状态倒推10步随机转动，因此沿这10步转动一定回到 G1
+        constexpr size_t HANDOFF_LENGTH = 10;
+        if (selected("phase2_handoff")) {
+            std::vector<Cube> starts(INPUTS);
+            std::vector<Phase2Tracking> trackings(INPUTS);
+            std::vector<Move> paths(INPUTS * HANDOFF_LENGTH);
+            for (size_t i = 0; i < INPUTS; ++i) {
+                Move* path = &paths[i * HANDOFF_LENGTH];
+                for (size_t j = 0; j < HANDOFF_LENGTH; ++j) path[j] = moves18[rng() & mask];
+                starts[i] = g1_cubes[i];
+                for (size_t j = HANDOFF_LENGTH; j-- > 0;) starts[i].apply_move(invert_move(path[j]));
+                trackings[i] = Phase2Tracking(starts[i]);
+            }
+            add(run_kernel("phase2_handoff_replay", n, sizeof(Cube) + HANDOFF_LENGTH, INPUTS * sizeof(Cube), [&](uint64_t count) {
+                uint32_t sink = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    Cube cube = starts[i & mask];
+                    for (size_t j = 0; j < HANDOFF_LENGTH; ++j) cube.apply_move(paths[(i & mask) * HANDOFF_LENGTH + j]);
+                    Phase2Coord coord(cube);
+                    sink += coord.get_corner_permutation() ^ coord.get_ud_edge_permutation() ^ coord.get_slice_edge_permutation();
+                }
+                do_not_optimize(sink);
+            }), "Cube replay + Phase2Coord");
+            uint64_t ws = sizeof(StaticTables::CORNER_POSITIONS_MOVE_TABLE) + sizeof(StaticTables::EDGE_POSITIONS_MOVE_TABLE);
+            add(run_kernel("phase2_handoff_tracked", n, sizeof(Phase2Tracking) + HANDOFF_LENGTH * 5 * sizeof(uint16_t), ws, [&](uint64_t count) {
+                uint32_t sink = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    Phase2Coord coord = tables.track_phase2(trackings[i & mask], &paths[(i & mask) * HANDOFF_LENGTH], HANDOFF_LENGTH);
+                    sink += coord.get_corner_permutation() ^ coord.get_ud_edge_permutation() ^ coord.get_slice_edge_permutation();
+                }
+                do_not_optimize(sink);
+            }), "position tables + to_phase2");
+            std::vector<Phase2Tracking> arrivals;
+            for (const auto& cube : g1_cubes) arrivals.emplace_back(cube);
+            add(run_kernel("phase2_handoff_at_g1", n, sizeof(Phase2Tracking), INPUTS * sizeof(Phase2Tracking), [&](uint64_t count) {
+                uint32_t sink = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    Phase2Coord coord = arrivals[i & mask].to_phase2();
+                    sink += coord.get_corner_permutation() ^ coord.get_ud_edge_permutation() ^ coord.get_slice_edge_permutation();
+                }
+                do_not_optimize(sink);
+            }), "to_phase2 only");
+        }
+
+        // --- 移动表 (链式依赖，与搜索中的访问模式相同) ---
+        if (selected("get_phase1_moves")) {
+            uint64_t ws = sizeof(StaticTables::CO_MOVE_TABLE) + sizeof(StaticTables::EO_MOVE_TABLE) + sizeof(StaticTables::UDS_MOVE_TABLE);
+            add(run_kernel("get_phase1_moves", n, 3 * sizeof(uint16_t), ws, [&](uint64_t count) {
+                uint16_t x1 = 0, x2 = 0, x3 = 0;
+                for (uint64_t i = 0; i < count; ++i) tables.get_phase1_moves(x1, x2, x3, moves18[i & mask], x1, x2, x3);
+                do_not_optimize(x1 + x2 + x3);
+            }), "dependent chain");
+        }
+        if (selected("get_phase2_moves")) {
+            uint64_t ws = 2 * sizeof(MoveTable<40320>) + sizeof(StaticTables::SEP_MOVE_TABLE);
+            add(run_kernel("get_phase2_moves", n, 3 * sizeof(uint16_t), ws, [&](uint64_t count) {
+                uint16_t x1 = 0, x2 = 0, x3 = 0;
+                for (uint64_t i = 0; i < count; ++i) tables.get_phase2_moves(x1, x2, x3, moves10[i & mask], x1, x2, x3);
+                do_not_optimize(x1 + x2 + x3);
+            }), "dependent chain");
+        }
+
+        // --- 启发函数 (随机坐标，相互独立) ---
+        if (selected("heuristic_phase1")) {
+            uint64_t ws = sizeof(StaticTables::CO_PRUNING_TABLE) + sizeof(StaticTables::EO_PRUNING_TABLE) + sizeof(StaticTables::UDS_PRUNING_TABLE);
+            add(run_kernel("heuristic_phase1", n, 3, ws, [&](uint64_t count) {
+                uint32_t sink = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    const auto& c = p1_coords[i & mask];
+                    sink += bench.heuristic_phase1(c.get_corner_orientation(), c.get_edge_orientation(), c.get_ud_slice_position());
+                }
+                do_not_optimize(sink);
+            }));
+        }
+        if (selected("heuristic_phase2")) {
+            uint64_t ws = 2 * sizeof(PruningTable<40320>) + sizeof(StaticTables::SEP_PRUNING_TABLE);
+            add(run_kernel("heuristic_phase2", n, 3, ws, [&](uint64_t count) {
+                uint32_t sink = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    const auto& c = p2_coords[i & mask];
+                    sink += bench.heuristic_phase2(c.get_corner_permutation(), c.get_ud_edge_permutation(), c.get_slice_edge_permutation());
+                }
+                do_not_optimize(sink);
+            }));
+        }
+
+        // --- 终局数据库 ---
+        // 扁平哈希表：每次查询通常只读一个16字节的槽
+        uint64_t endgame_iterations = std::max<uint64_t>(1, n / 16);
+        auto endgame_kernel = [&](const std::string& name, const std::vector<Key>& keys, auto phase_tag, size_t table_bytes) {
+            constexpr uint8_t PHASE = decltype(phase_tag)::value;
+            uint64_t hits = 0;
+            auto result = run_kernel(name, endgame_iterations, sizeof(EndgameTable::Slot), table_bytes,
+                [&](uint64_t count) {
+                    std::vector<Move> path;
+                    hits = 0;
+                    for (uint64_t i = 0; i < count; ++i) {
+                        const auto& k = keys[i & mask];
+                        hits += tables.search_endgame_db<PHASE>(k.x1, k.x2, k.x3, path);
+                    }
+                    do_not_optimize(hits);
+                });
+            add(result, "hit rate " + std::to_string(100 * hits / endgame_iterations) + "%");
+        };
+        if (selected("endgame_p1_hit")) endgame_kernel("endgame_p1_hit", p1_hits, std::integral_constant<uint8_t, 1>{}, tables.endgame_db_bytes<1>());
+        if (selected("endgame_p1_miss")) endgame_kernel("endgame_p1_miss", p1_misses, std::integral_constant<uint8_t, 1>{}, tables.endgame_db_bytes<1>());
+        if (selected("endgame_p2_hit")) endgame_kernel("endgame_p2_hit", p2_hits, std::integral_constant<uint8_t, 2>{}, tables.endgame_db_bytes<2>());
+        if (selected("endgame_p2_miss")) endgame_kernel("endgame_p2_miss", p2_misses, std::integral_constant<uint8_t, 2>{}, tables.endgame_db_bytes<2>());
+
+        // --- 搜索内核：固定深度下的节点吞吐量 ---
+        auto search_kernel = [&](const std::string& name, auto phase_tag, int depth, uint64_t working_set, auto&& key_of) {
+            constexpr uint8_t PHASE = decltype(phase_tag)::value;
+            const size_t starts = 256;
+            uint64_t nodes = 0;
+            uint64_t best = UINT64_MAX;
+            for (int trial = 0; trial < 3; ++trial) {
+                nodes = 0;
+                auto start = Clock::now();
+                for (size_t i = 0; i < starts; ++i) {
+                    Key k = key_of(i);
+                    nodes += bench.search_fixed_depth<PHASE>(k.x1, k.x2, k.x3, depth);
+                }
+                best = std::min(best, elapsed_ns(start, Clock::now()));
+            }
+            KernelResult result;
+            result.name = name;
+            result.ops = nodes;
+            result.ns_per_op = nodes ? static_cast<double>(best) / nodes : 0.0;
+            result.bytes_per_op = SolverBenchmark::SEARCH_STATE_BYTES;
+            result.working_set = working_set;
+            std::ostringstream note;
+            note << "depth " << depth << ", " << nodes << " nodes, "
+                 << std::fixed << std::setprecision(2) << (nodes ? nodes * 1e3 / best : 0.0) << " M nodes/s";
+            add(result, note.str());
+        };
+        if (selected("search_phase1")) {
+            uint64_t ws = sizeof(StaticTables::CO_MOVE_TABLE) + sizeof(StaticTables::EO_MOVE_TABLE) + sizeof(StaticTables::UDS_MOVE_TABLE) +
+                          sizeof(StaticTables::CO_PRUNING_TABLE) + sizeof(StaticTables::EO_PRUNING_TABLE) + sizeof(StaticTables::UDS_PRUNING_TABLE);
+            search_kernel("search_phase1", std::integral_constant<uint8_t, 1>{}, 9, ws, [&](size_t i) { return p1_misses[i]; });
+        }
+        if (selected("search_phase2")) {
+            uint64_t ws = 2 * sizeof(MoveTable<40320>) + sizeof(StaticTables::SEP_MOVE_TABLE) +
+                          2 * sizeof(PruningTable<40320>) + sizeof(StaticTables::SEP_PRUNING_TABLE);
+            search_kernel("search_phase2", std::integral_constant<uint8_t, 2>{}, 12, ws, [&](size_t i) { return p2_misses[i]; });
+        }
+
+        if (!options.json_path.empty()) {
+            std::ofstream out(options.json_path);
+            if (!out) throw std::runtime_error("Cannot write " + options.json_path);
+            Json::Writer w(out);
+            w.begin_object();
+            w.field("benchmark", "microbench");
+            w.field("iterations", n);
+            w.field("seed", options.seed);
+            w.key("kernels").begin_array();
+            for (const auto& r : results) {
+                w.begin_object();
+                w.field("name", r.name);
+                w.field("ops", r.ops);
+                w.field("ns_per_op", r.ns_per_op);
+                w.field("bytes_per_op", r.bytes_per_op);
+                w.field("working_set_bytes", r.working_set);
+                if (!r.note.empty()) w.field("note", r.note);
+                w.end_object();
+            }
+            w.end_array();
+            w.end_object();
+            out << '\n';
+            std::cout << "JSON results written to " << options.json_path << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
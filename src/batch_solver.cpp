@@ -0,0 +1,402 @@
+#include "batch_solver.h"
+#include "bounded_queue.h"
+#include "cube.h"
+#include "interleaved_solver.h"
+#include "json_util.h"
+#include "lockstep_solver.h"
+#include "solver.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RubiksSolver {
+
+namespace {
+
+struct BatchItem {
+    std::string input;
+    Cube cube;
+    std::string error;
+    std::vector<Move> solution;
+    uint64_t solve_ns = 0;
+};
+
+struct Batch {
+    uint64_t sequence = 0;
+    uint64_t first_index = 0;
+    std::vector<BatchItem> items;
+};
+
+// 队列中传递批次的所有权；空指针表示流结束
+using BatchPtr = std::unique_ptr<Batch>;
+using BatchQueue = BoundedQueue<BatchPtr>;
+
+// 按行读取输入：普通文件整体映射到内存，其他输入 (管道、终端) 按 1 MiB 的块读取
+class LineReader {
+public:
+    explicit LineReader(const std::string& path) {
+        if (path == "-") {
+            fd_ = STDIN_FILENO;
+        } else {
+            fd_ = ::open(path.c_str(), O_RDONLY);
+            if (fd_ < 0) throw std::runtime_error("Cannot open " + path);
+            owns_fd_ = true;
+        }
+        struct stat st;
+        if (::fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (data != MAP_FAILED) {
+                ::madvise(data, st.st_size, MADV_SEQUENTIAL);
+                mapped_ = static_cast<const char*>(data);
+                mapped_size_ = st.st_size;
+            }
+        }
+        if (!mapped_) {
+            buffer_.resize(CHUNK_SIZE);
+        }
+    }
+
+    ~LineReader() {
+        if (mapped_) ::munmap(const_cast<char*>(mapped_), mapped_size_);
+        if (owns_fd_) ::close(fd_);
+    }
+
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    // 读取下一行 (不含换行符)；输入结束时返回 false
+    bool next(std::string_view& line) {
+        for (;;) {
+            std::string_view data = mapped_ ? std::string_view(mapped_, mapped_size_)
+                                            : std::string_view(buffer_.data(), filled_);
+            if (pos_ < data.size()) {
+                size_t end = data.find('\n', pos_);
+                if (end != std::string_view::npos) {
+                    line = data.substr(pos_, end - pos_);
+                    pos_ = end + 1;
+                    return true;
+                }
+                if (mapped_ || eof_) {
+                    line = data.substr(pos_);
+                    pos_ = data.size();
+                    return true;
+                }
+            } else if (mapped_ || eof_) {
+                return false;
+            }
+            refill();
+        }
+    }
+
+private:
+    static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+    // 把未完成的行移到缓冲区开头，再读入新数据
+    void refill() {
+        size_t remaining = filled_ - pos_;
+        std::copy(buffer_.begin() + pos_, buffer_.begin() + filled_, buffer_.begin());
+        filled_ = remaining;
+        pos_ = 0;
+        if (filled_ == buffer_.size()) {
+            buffer_.resize(buffer_.size() * 2);
+        }
+        ssize_t n;
+        do {
+            n = ::read(fd_, buffer_.data() + filled_, buffer_.size() - filled_);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0) throw std::runtime_error("Failed to read input");
+        if (n == 0) eof_ = true;
+        filled_ += n;
+    }
+
+    int fd_ = -1;
+    bool owns_fd_ = false;
+    const char* mapped_ = nullptr;
+    size_t mapped_size_ = 0;
+    std::vector<char> buffer_;
+    size_t filled_ = 0;
+    size_t pos_ = 0;
+    bool eof_ = false;
+};
+
+// 去掉注释和首尾空白
+std::string_view trim_line(std::string_view line) {
+    line = line.substr(0, line.find('#'));
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) line.remove_suffix(1);
+    while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) line.remove_prefix(1);
+    return line;
+}
+
+void append_solution(std::string& out, const std::vector<Move>& solution) {
+    for (size_t i = 0; i < solution.size(); ++i) {
+        if (i > 0) out += ' ';
+        out += MOVE_STRINGS[static_cast<int>(solution[i])];
+    }
+}
+
+void format_batch(std::string& out, const Batch& batch, BatchFormat format) {
+    for (size_t i = 0; i < batch.items.size(); ++i) {
+        const auto& item = batch.items[i];
+        if (format == BatchFormat::Plain) {
+            if (item.error.empty()) {
+                append_solution(out, item.solution);
+            } else {
+                out += "ERROR: ";
+                out += item.error;
+            }
+        } else {
+            out += "{\"index\":";
+            out += std::to_string(batch.first_index + i);
+            out += ",\"input\":\"";
+            out += Json::escape(item.input);
+            out += '"';
+            if (item.error.empty()) {
+                out += ",\"solution\":\"";
+                append_solution(out, item.solution);
+                out += "\",\"length\":";
+                out += std::to_string(item.solution.size());
+                out += ",\"time_us\":";
+                out += std::to_string(item.solve_ns / 1000);
+            } else {
+                out += ",\"error\":\"";
+                out += Json::escape(item.error);
+                out += '"';
+            }
+            out += '}';
+        }
+        out += '\n';
+    }
+}
+
+} // namespace
+
+BatchSummary run_batch(const TableManager& tables, const BatchOptions& options, std::ostream& out) {
+    using Clock = std::chrono::steady_clock;
+    if (options.lockstep && options.interleave > 0) {
+        throw std::invalid_argument("Lockstep and interleaved solving cannot be combined");
+    }
+    if (options.lockstep && !LockstepSolver::supports(options.policy)) {
+        throw std::invalid_argument("Lockstep solving supports only the default search policy");
+    }
+    if (options.interleave > 0 && !InterleavedSolver::supports(options.policy)) {
+        throw std::invalid_argument("Interleaved solving supports only the default search policy");
+    }
+    if ((options.lockstep || options.interleave > 0) && options.cache != nullptr) {
+        throw std::invalid_argument("Lockstep and interleaved solving do not use the solution cache");
+    }
+    // Solver 只在默认策略下读写缓存，其他策略下缓存不会起作用
+    if (options.cache != nullptr && !(options.policy == SolveOptions{})) {
+        throw std::invalid_argument("The solution cache works only with the default search policy");
+    }
+    auto start = Clock::now();
+    const unsigned threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t batch_size = std::max<size_t>(1, options.batch_size);
+
+    LineReader reader(options.input_path);
+    BatchQueue parse_queue(options.queue_capacity);
+    BatchQueue solve_queue(options.queue_capacity);
+    BatchQueue emit_queue(options.queue_capacity);
+
+    // 有序输出时限制已读入但尚未输出的批次数，防止慢批次之后的结果无限堆积
+    const uint64_t window = parse_queue.capacity() + solve_queue.capacity() + emit_queue.capacity() + threads;
+    std::atomic<uint64_t> emitted_batches{0};
+    std::atomic<uint64_t> solved{0};
+    std::atomic<uint64_t> failed{0};
+
+    // 解析阶段：行 -> Cube，解析错误随批次传递到输出阶段
+    std::thread parser([&]() {
+        while (BatchPtr batch = parse_queue.pop()) {
+            for (auto& item : batch->items) {
+                try {
+                    item.cube = Cube::parse(item.input);
+                } catch (const std::exception& e) {
+                    item.error = e.what();
+                }
+            }
+            solve_queue.push(std::move(batch));
+        }
+        for (unsigned t = 0; t < threads; ++t) {
+            solve_queue.push(nullptr);
+        }
+    });
+
+    // 整个批次一起交给 LockstepSolver 或 InterleavedSolver，每项的耗时记为批次的平均值
+    auto solve_together = [&](auto& solver, Batch& batch) {
+        std::vector<Cube> cubes;
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < batch.items.size(); ++i) {
+            if (!batch.items[i].error.empty()) continue;
+            cubes.push_back(batch.items[i].cube);
+            indices.push_back(i);
+        }
+        if (cubes.empty()) return;
+        auto solve_start = Clock::now();
+        auto results = solver.solve(cubes);
+        uint64_t average_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - solve_start).count() / cubes.size();
+        for (size_t k = 0; k < indices.size(); ++k) {
+            auto& item = batch.items[indices[k]];
+            item.solution = std::move(results[k].solution);
+            item.error = std::move(results[k].error);
+            item.solve_ns = average_ns;
+        }
+    };
+
+    // 求解阶段：每个线程一个 Solver (或 LockstepSolver)
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            auto solve_batches = [&](auto& solver) {
+                while (BatchPtr batch = solve_queue.pop()) {
+                    solve_together(solver, *batch);
+                    emit_queue.push(std::move(batch));
+                }
+                emit_queue.push(nullptr);
+            };
+            if (options.lockstep) {
+                LockstepSolver solver(tables, options.policy.limits);
+                solve_batches(solver);
+                return;
+            }
+            if (options.interleave > 0) {
+                InterleavedSolver solver(tables, options.interleave, false, options.policy.limits);
+                solve_batches(solver);
+                return;
+            }
+            Solver solver(tables, false);
+            solver.set_cache(options.cache);
+            solver.set_options(options.policy);
+            while (BatchPtr batch = solve_queue.pop()) {
+                for (auto& item : batch->items) {
+                    if (!item.error.empty()) continue;
+                    auto solve_start = Clock::now();
+                    try {
+                        item.solution = solver.solve(item.cube);
+                    } catch (const std::exception& e) {
+                        item.error = e.what();
+                    }
+                    item.solve_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - solve_start).count();
+                }
+                emit_queue.push(std::move(batch));
+            }
+            emit_queue.push(nullptr);
+        });
+    }
+
+    // 输出阶段：格式化到缓冲区，攒满后整块写出
+    std::thread emitter([&]() {
+        constexpr size_t FLUSH_BYTES = 1 << 20;
+        std::string buffer;
+        buffer.reserve(FLUSH_BYTES * 2);
+        std::unordered_map<uint64_t, BatchPtr> pending;
+        uint64_t next_sequence = 0;
+        unsigned finished_workers = 0;
+
+        auto emit = [&](const Batch& batch) {
+            format_batch(buffer, batch, options.format);
+            for (const auto& item : batch.items) {
+                ++(item.error.empty() ? solved : failed);
+            }
+            emitted_batches.fetch_add(1, std::memory_order_release);
+            emitted_batches.notify_one();
+            if (buffer.size() >= FLUSH_BYTES) {
+                out.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        };
+
+        while (finished_workers < threads) {
+            BatchPtr batch = emit_queue.pop();
+            if (!batch) {
+                ++finished_workers;
+                continue;
+            }
+            if (!options.ordered) {
+                emit(*batch);
+                continue;
+            }
+            pending.emplace(batch->sequence, std::move(batch));
+            for (auto it = pending.find(next_sequence); it != pending.end(); it = pending.find(next_sequence)) {
+                emit(*it->second);
+                pending.erase(it);
+                ++next_sequence;
+            }
+        }
+        out.write(buffer.data(), buffer.size());
+        out.flush();
+    });
+
+    // 读取阶段 (当前线程)：按行切分并组成批次
+    uint64_t sequence = 0;
+    uint64_t total = 0;
+    auto make_batch = [&]() {
+        auto batch = std::make_unique<Batch>();
+        batch->sequence = sequence;
+        batch->first_index = total;
+        batch->items.reserve(batch_size);
+        return batch;
+    };
+    auto submit = [&](BatchPtr batch) {
+        if (options.ordered) {
+            // 输出阶段每输出一批都会唤醒这里，等待时不占用CPU
+            for (uint64_t done = emitted_batches.load(std::memory_order_acquire); sequence - done >= window;
+                 done = emitted_batches.load(std::memory_order_acquire)) {
+                emitted_batches.wait(done, std::memory_order_acquire);
+            }
+        }
+        parse_queue.push(std::move(batch));
+        ++sequence;
+    };
+
+    // 读取失败时仍然让下游阶段正常结束，再把异常抛给调用者
+    std::exception_ptr read_error;
+    try {
+        BatchPtr batch = make_batch();
+        std::string_view line;
+        while (reader.next(line)) {
+            line = trim_line(line);
+            if (line.empty()) continue;
+            batch->items.emplace_back().input.assign(line);
+            ++total;
+            if (batch->items.size() == batch_size) {
+                submit(std::move(batch));
+                batch = make_batch();
+            }
+        }
+        if (!batch->items.empty()) {
+            submit(std::move(batch));
+        }
+    } catch (...) {
+        read_error = std::current_exception();
+    }
+    parse_queue.push(nullptr);
+
+    parser.join();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    emitter.join();
+    if (read_error) {
+        std::rethrow_exception(read_error);
+    }
+
+    BatchSummary summary;
+    summary.total = total;
+    summary.solved = solved.load();
+    summary.failed = failed.load();
+    summary.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    return summary;
+}
+
+} // namespace RubiksSolver
@@ -0,0 +1,29 @@
+#include "compact_pruning_table.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace RubiksSolver {
+
+void CompactPruningTable::assign(const std::vector<uint8_t>& distances, bool packed, bool huge_pages) {
+    size_t bytes = packed ? (distances.size() + 1) / 2 : distances.size();
+    ResidentRegion region = ResidentRegion::allocate(bytes, huge_pages);
+    auto* out = static_cast<uint8_t*>(region.data());
+    if (packed) {
+        std::memset(out, 0, bytes);
+        for (size_t i = 0; i < distances.size(); ++i) {
+            if (distances[i] > 0x0F) {
+                throw std::out_of_range("Pruning distance does not fit in 4 bits");
+            }
+            out[i >> 1] |= static_cast<uint8_t>(distances[i] << ((i & 1) << 2));
+        }
+    } else {
+        std::memcpy(out, distances.data(), bytes);
+    }
+    region.publish();
+    region_ = std::move(region);
+    data_ = static_cast<const uint8_t*>(region_.data());
+    bytes_ = bytes;
+    packed_ = packed;
+}
+
+} // namespace RubiksSolver
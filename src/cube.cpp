@@ -1,129 +1,13 @@
 #include "cube.h"
 #include "coordinate.h" // 如果需要
+#include "packed_cube.h"
 #include <stdexcept>
 #include <algorithm>
+#include <bit>
 #include <ranges>
 
 namespace RubiksSolver {
 
-// 角块位置
-enum CornerPos : uint8_t { UFL, UBL, UBR, UFR, DFL, DBL, DBR, DFR };
-
-// 棱块位置
-enum EdgePos : uint8_t { UF, UL, UB, UR, DF, DL, DB, DR, FL, BL, BR, FR };
-
-
-// 例如 cycle(arr, {0, 1, 2, 3}) 会将 arr[0]<-arr[1]<-arr[1]<-arr[2]<-arr[3]<-arr[0]
-template<typename T, size_t ArraySize>
-void cycle_pieces(
-    std::array<T, ArraySize>& arr,
-    const std::array<uint8_t, 4>& affected_indices, // 受影响的槽位索引
-    const std::array<uint8_t, 4>& target_map   // 置换映射表
-) {
-    std::array<T, 4> temp_pieces;
-    for (size_t i = 0; i < 4; ++i) {
-        temp_pieces[i] = arr[affected_indices[i]];
-    }
-
-    for (size_t i = 0; i < 4; ++i) {
-        arr[target_map[i]] = temp_pieces[i];
-    }
-}
-
-
-struct MoveMap {
-    // 受影响的槽位索引
-    std::array<uint8_t, 4> affected_indices;
-
-    // 移动后的位置映射
-    std::array<uint8_t, 4> target_map;
-};
-
-// 描述一次转动效果的数据结构
-struct MoveDefinition {
-    // 角块置换
-    MoveMap corner_permutation;
-    // 棱块置换
-    MoveMap edge_permutation;
-    // 对应角块的朝向变化 (模3)
-    std::array<uint8_t, 4> corner_orientation_changes;
-    // 对应棱块的朝向变化 (模2)
-    std::array<uint8_t, 4> edge_orientation_changes;
-};
-
-const std::array<MoveDefinition, 18> ALL_MOVES_DATA = {{
-    // Move::U1
-    { {{UFL, UBL, UBR, UFR}, {UBL, UBR, UFR, UFL}}, {{UF, UL, UB, UR}, {UL, UB, UR, UF}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::U2
-    { {{UFL, UFR, UBR, UBL}, {UFR, UBR, UBL, UFL}}, {{UF, UR, UB, UL}, {UR, UB, UL, UF}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::U3
-    { {{UFL, UBR, UFR, UBL}, {UBR, UFL, UBL, UFR}}, {{UF, UB, UL, UR}, {UB, UF, UR, UL}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::D1
-    { {{DFL, DFR, DBR, DBL}, {DFR, DBR, DBL, DFL}}, {{DF, DR, DB, DL}, {DR, DB, DL, DF}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::D2
-    { {{DFL, DBL, DBR, DFR}, {DBL, DBR, DFR, DFL}}, {{DF, DL, DB, DR}, {DL, DB, DR, DF}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::D3
-    { {{DFL, DBR, DFR, DBL}, {DBR, DFL, DBL, DFR}}, {{DF, DB, DL, DR}, {DB, DF, DR, DL}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::F1
-    { {{UFL, UFR, DFR, DFL}, {UFR, DFR, DFL, UFL}}, {{UF, FR, DF, FL}, {FR, DF, FL, UF}}, {2,1,2,1}, {1,1,1,1} },
-    // Move::F2
-    { {{UFL, DFL, DFR, UFR}, {DFL, DFR, UFR, UFL}}, {{UF, FL, DF, FR}, {FL, DF, FR, UF}}, {2,1,2,1}, {1,1,1,1} },
-    // Move::F3
-    { {{UFL, DFR, UFR, DFL}, {DFR, UFL, DFL, UFR}}, {{UF, DF, FL, FR}, {DF, UF, FR, FL}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::B1
-    { {{UBL, DBL, DBR, UBR}, {DBL, DBR, UBR, UBL}}, {{UB, BL, DB, BR}, {BL, DB, BR, UB}}, {1,2,1,2}, {1,1,1,1} },
-    // Move::B2
-    { {{UBL, UBR, DBR, DBL}, {UBR, DBR, DBL, UBL}}, {{UB, BR, DB, BL}, {BR, DB, BL, UB}}, {1,2,1,2}, {1,1,1,1} },
-    // Move::B3
-    { {{UBL, DBR, UBR, DBL}, {DBR, UBL, DBL, UBR}}, {{UB, DB, BL, BR}, {DB, UB, BR, BL}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::L1
-    { {{UFL, DFL, DBL, UBL}, {DFL, DBL, UBL, UFL}}, {{UL, FL, DL, BL}, {FL, DL, BL, UL}}, {1,2,1,2}, {0,0,0,0} },
-    // Move::L2
-    { {{UFL, UBL, DBL, DFL}, {UBL, DBL, DFL, UFL}}, {{UL, BL, DL, FL}, {BL, DL, FL, UL}}, {1,2,1,2}, {0,0,0,0} },
-    // Move::L3
-    { {{UFL, DBL, UBL, DFL}, {DBL, UFL, DFL, UBL}}, {{UL, DL, FL, BL}, {DL, UL, BL, FL}}, {0,0,0,0}, {0,0,0,0} },
-    // Move::R1
-    { {{UFR, UBR, DBR, DFR}, {UBR, DBR, DFR, UFR}}, {{UR, BR, DR, FR}, {BR, DR, FR, UR}}, {2,1,2,1}, {0,0,0,0} },
-    // Move::R2
-    { {{UFR, DFR, DBR, UBR}, {DFR, DBR, UBR, UFR}}, {{UR, FR, DR, BR}, {FR, DR, BR, UR}}, {2,1,2,1}, {0,0,0,0} },
-    // Move::R3
-    { {{UFR, DBR, UBR, DFR}, {DBR, UFR, DFR, UBR}}, {{UR, DR, FR, BR}, {DR, UR, BR, FR}}, {0,0,0,0}, {0,0,0,0} },
-
-}};
-
-Cube::Cube() {
-    // 初始化角块
-    for (uint8_t i = 0; i < 8; ++i) {
-        corners[i].piece = i;
-        corners[i].orientation = 0;
-    }
-    // 初始化棱块
-    for (uint8_t i = 0; i < 12; ++i) {
-        edges[i].piece = i;
-        edges[i].orientation = 0;
-    }
-}
-
-void Cube::apply_move(Move m) {
-    if (m >= Move::COUNT)   
-        throw std::out_of_range("Invalid move");
-    // 1. 从数据表中获取当前转动的定义
-    const auto& move_def = ALL_MOVES_DATA[static_cast<int>(m)];
-
-    // 2. 应用置换
-    cycle_pieces(corners, move_def.corner_permutation.affected_indices, move_def.corner_permutation.target_map);
-    cycle_pieces(edges, move_def.edge_permutation.affected_indices, move_def.edge_permutation.target_map);
-
-    // 3. 应用朝向变化
-    for (int i = 0; i < 4; ++i) {
-        uint8_t c_idx = move_def.corner_permutation.affected_indices[i];
-        corners[c_idx].orientation = (corners[c_idx].orientation + move_def.corner_orientation_changes[i]) % 3;
-
-        uint8_t e_idx = move_def.edge_permutation.affected_indices[i];
-        edges[e_idx].orientation = (edges[e_idx].orientation + move_def.edge_orientation_changes[i]) % 2;
-    }
-}
-
 bool Cube::is_solved() const {
     for (int i = 0; i < 8; ++i) {
         if (corners[i].piece != i || corners[i].orientation != 0) {
@@ -300,8 +184,9 @@ std::string Cube::to_string() const {
     return result;
 }
 
+// 批量转动都在紧凑表示上完成，最后再转换回来
 Cube Cube::from_scramble(const std::string& scramble) {
-    Cube cube;
+    PackedCube cube;
     auto split_view = scramble | std::views::split(' ');
     for (const auto& split : split_view) {
         std::string move_str(split.begin(), split.end());
@@ -309,13 +194,220 @@ Cube Cube::from_scramble(const std::string& scramble) {
         Move move = string_to_move(move_str);
         cube.apply_move(move);
     }
-    return cube;
+    return cube.to_cube();
+}
+
+Cube Cube::parse(const std::string& text) {
+    bool is_facelets = text.size() == 54 && text.find(' ') == std::string::npos;
+    return is_facelets ? from_facelets(text) : from_scramble(text);
 }
 
 void Cube::apply_sequence(const std::vector<Move>& sequence) {
-    for (const Move& move : sequence) {
-        apply_move(move);
+    PackedCube cube(*this);
+    cube.apply_sequence(sequence);
+    *this = cube.to_cube();
+}
+
+namespace {
+
+// 色块字符串中各面的顺序 (U R F D L B) 以及对应的颜色
+constexpr std::array<Color, 6> FACELET_FACE_COLORS = {
+    Color::White, Color::Blue, Color::Red, Color::Yellow, Color::Green, Color::Orange
+};
+constexpr std::array<char, 6> FACELET_FACE_CHARS = {'U', 'R', 'F', 'D', 'L', 'B'};
+
+// 每个角块槽位的3个色块在字符串中的下标，按 sticker 编号排列 (与 get_face_colors 的布局一致)
+constexpr std::array<std::array<uint8_t, 3>, 8> CORNER_FACELETS = {{
+    {6, 18, 38},  // UFL
+    {0, 36, 47},  // UBL
+    {2, 45, 11},  // UBR
+    {8, 9, 20},   // UFR
+    {27, 44, 24}, // DFL
+    {33, 53, 42}, // DBL
+    {35, 17, 51}, // DBR
+    {29, 26, 15}  // DFR
+}};
+
+// 每个棱块槽位的2个色块在字符串中的下标
+constexpr std::array<std::array<uint8_t, 2>, 12> EDGE_FACELETS = {{
+    {7, 19},  // UF
+    {3, 37},  // UL
+    {1, 46},  // UB
+    {5, 10},  // UR
+    {28, 25}, // DF
+    {30, 43}, // DL
+    {34, 52}, // DB
+    {32, 16}, // DR
+    {21, 41}, // FL
+    {50, 39}, // BL
+    {48, 14}, // BR
+    {23, 12}  // FR
+}};
+
+} // namespace
+
+Cube Cube::from_facelets(std::string_view facelets) {
+    if (facelets.size() != 54) {
+        throw std::invalid_argument("Facelet string must contain exactly 54 characters");
+    }
+
+    // 由各面中心色块确定字符到颜色的映射
+    std::array<int8_t, 256> color_of{};
+    color_of.fill(-1);
+    for (int face = 0; face < 6; ++face) {
+        auto c = static_cast<unsigned char>(facelets[face * 9 + 4]);
+        if (color_of[c] != -1) {
+            throw std::invalid_argument("Facelet string has duplicate center colors");
+        }
+        color_of[c] = static_cast<int8_t>(FACELET_FACE_COLORS[face]);
+    }
+
+    std::array<Color, 54> colors;
+    std::array<int, 6> counts{};
+    for (size_t i = 0; i < 54; ++i) {
+        int8_t color = color_of[static_cast<unsigned char>(facelets[i])];
+        if (color < 0) {
+            throw std::invalid_argument("Facelet string contains an unknown color");
+        }
+        colors[i] = static_cast<Color>(color);
+        ++counts[color];
+    }
+    if (std::ranges::any_of(counts, [](int n) { return n != 9; })) {
+        throw std::invalid_argument("Each color must appear exactly 9 times");
+    }
+
+    auto is_ud = [](Color c) { return c == Color::White || c == Color::Yellow; };
+
+    Cube cube;
+    for (int pos = 0; pos < 8; ++pos) {
+        std::array<Color, 3> c;
+        for (int s = 0; s < 3; ++s) c[s] = colors[CORNER_FACELETS[pos][s]];
+
+        // U/D 颜色所在的 sticker 就是朝向
+        int ori = 0;
+        while (ori < 3 && !is_ud(c[ori])) ++ori;
+        if (ori == 3) {
+            throw std::invalid_argument("Invalid corner colors");
+        }
+
+        int piece = 0;
+        while (piece < 8 && !(CORNER_COLORS[piece][0] == c[ori] &&
+                              CORNER_COLORS[piece][1] == c[(ori + 1) % 3] &&
+                              CORNER_COLORS[piece][2] == c[(ori + 2) % 3])) {
+            ++piece;
+        }
+        if (piece == 8) {
+            throw std::invalid_argument("Invalid corner colors");
+        }
+        cube.corners[pos].piece = piece;
+        cube.corners[pos].orientation = ori;
+    }
+
+    for (int pos = 0; pos < 12; ++pos) {
+        Color c0 = colors[EDGE_FACELETS[pos][0]];
+        Color c1 = colors[EDGE_FACELETS[pos][1]];
+
+        int piece = 0, ori = -1;
+        for (; piece < 12; ++piece) {
+            if (EDGE_COLORS[piece][0] == c0 && EDGE_COLORS[piece][1] == c1) { ori = 0; break; }
+            if (EDGE_COLORS[piece][0] == c1 && EDGE_COLORS[piece][1] == c0) { ori = 1; break; }
+        }
+        if (ori < 0) {
+            throw std::invalid_argument("Invalid edge colors");
+        }
+        cube.edges[pos].piece = piece;
+        cube.edges[pos].orientation = ori;
+    }
+
+    cube.validate();
+    return cube;
+}
+
+Cube Cube::from_pieces(const std::array<uint8_t, 8>& corner_pieces,
+                       const std::array<uint8_t, 8>& corner_orientations,
+                       const std::array<uint8_t, 12>& edge_pieces,
+                       const std::array<uint8_t, 12>& edge_orientations) {
+    Cube cube;
+    // 先检查取值范围，避免写入位域时被截断
+    for (int i = 0; i < 8; ++i) {
+        if (corner_pieces[i] >= 8 || corner_orientations[i] >= 3) {
+            throw std::invalid_argument("Corner piece or orientation out of range");
+        }
+        cube.corners[i].piece = corner_pieces[i];
+        cube.corners[i].orientation = corner_orientations[i];
+    }
+    for (int i = 0; i < 12; ++i) {
+        if (edge_pieces[i] >= 12 || edge_orientations[i] >= 2) {
+            throw std::invalid_argument("Edge piece or orientation out of range");
+        }
+        cube.edges[i].piece = edge_pieces[i];
+        cube.edges[i].orientation = edge_orientations[i];
+    }
+
+    cube.validate();
+    return cube;
+}
+
+void Cube::validate() const {
+    // 逆序数按位掩码统计：已出现且编号更大的块数
+    uint32_t seen = 0;
+    int twist = 0, corner_parity = 0;
+    for (const auto& corner : corners) {
+        uint32_t bit = 1u << corner.piece;
+        if (seen & bit) {
+            throw std::invalid_argument("Duplicate corner piece");
+        }
+        corner_parity += std::popcount(seen & ~(bit | (bit - 1)));
+        seen |= bit;
+        twist += corner.orientation;
+    }
+
+    seen = 0;
+    int flip = 0, edge_parity = 0;
+    for (const auto& edge : edges) {
+        uint32_t bit = 1u << edge.piece;
+        if (seen & bit) {
+            throw std::invalid_argument("Duplicate edge piece");
+        }
+        edge_parity += std::popcount(seen & ~(bit | (bit - 1)));
+        seen |= bit;
+        flip += edge.orientation;
+    }
+
+    if (twist % 3 != 0) {
+        throw std::invalid_argument("Unsolvable state: corner twist");
+    }
+    if (flip % 2 != 0) {
+        throw std::invalid_argument("Unsolvable state: edge flip");
+    }
+    if ((corner_parity ^ edge_parity) & 1) {
+        throw std::invalid_argument("Unsolvable state: permutation parity");
+    }
+}
+
+std::string Cube::to_facelets() const {
+    std::string facelets(54, ' ');
+    for (int face = 0; face < 6; ++face) {
+        facelets[face * 9 + 4] = FACELET_FACE_CHARS[face];
+    }
+
+    auto face_char = [](Color c) {
+        for (int face = 0; face < 6; ++face) {
+            if (FACELET_FACE_COLORS[face] == c) return FACELET_FACE_CHARS[face];
+        }
+        return '?';
+    };
+    for (uint8_t pos = 0; pos < 8; ++pos) {
+        for (uint8_t s = 0; s < 3; ++s) {
+            facelets[CORNER_FACELETS[pos][s]] = face_char(get_corner_sticker_color(pos, s));
+        }
+    }
+    for (uint8_t pos = 0; pos < 12; ++pos) {
+        for (uint8_t s = 0; s < 2; ++s) {
+            facelets[EDGE_FACELETS[pos][s]] = face_char(get_edge_sticker_color(pos, s));
+        }
     }
+    return facelets;
 }
 
-} // namespace RubiksSolver
\ No newline at end of file
+} // namespace RubiksSolver
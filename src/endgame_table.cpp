@@ -0,0 +1,48 @@
+#include "endgame_table.h"
+#include <bit>
+#include <stdexcept>
+
+namespace RubiksSolver {
+
+size_t EndgameTable::capacity_for(size_t entries) {
+    return std::bit_ceil(std::max<size_t>(entries + entries / 3 + 1, 2));
+}
+
+size_t EndgameTable::bytes_for(size_t entries) {
+    return HEADER_SIZE + capacity_for(entries) * sizeof(Slot);
+}
+
+void EndgameTable::build(const std::unordered_map<uint64_t, std::vector<Move>>& db, void* memory) {
+    auto* header = static_cast<Header*>(memory);
+    auto* slots = reinterpret_cast<Slot*>(static_cast<char*>(memory) + HEADER_SIZE);
+    header->capacity = capacity_for(db.size());
+    header->entries = db.size();
+    for (size_t i = 0; i < header->capacity; ++i) {
+        slots[i].key = EMPTY_KEY;
+    }
+
+    EndgameTable view;
+    view.bind(memory);
+    for (const auto& [key, path] : db) {
+        if (path.size() > MAX_PATH_LENGTH) {
+            throw std::length_error("Endgame path longer than " + std::to_string(MAX_PATH_LENGTH) + " moves");
+        }
+        size_t i = view.slot_index(key);
+        while (slots[i].key != EMPTY_KEY) {
+            i = (i + 1) & view.mask_;
+        }
+        slots[i].key = key;
+        slots[i].length = static_cast<uint8_t>(path.size());
+        std::copy(path.begin(), path.end(), slots[i].moves.begin());
+    }
+}
+
+void EndgameTable::bind(const void* memory) {
+    const auto* header = static_cast<const Header*>(memory);
+    slots_ = reinterpret_cast<const Slot*>(static_cast<const char*>(memory) + HEADER_SIZE);
+    mask_ = header->capacity - 1;
+    shift_ = 64 - std::countr_zero(header->capacity);
+    entries_ = header->entries;
+}
+
+} // namespace RubiksSolver
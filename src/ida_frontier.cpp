@@ -0,0 +1,44 @@
+#include "ida_frontier.h"
+#include <algorithm>
+
+namespace RubiksSolver {
+
+bool IdaFrontier::next(Node& node, std::vector<Move>& path) {
+    if (next_index_ >= nodes_.size()) {
+        return false;
+    }
+    node = nodes_[next_index_];
+    // 与上一个起始节点有相同的父节点时，路径前缀及其编号都不变
+    if (next_index_ == 0 || node.path_id != last_parent_) {
+        valid_depth_ = 0;
+        uint32_t id = node.path_id;
+        for (int k = node.depth - 1; k >= 1; --k) {
+            path[k] = paths_[id].move;
+            id = paths_[id].parent;
+        }
+    } else {
+        valid_depth_ = std::min(valid_depth_, node.depth - 1);
+    }
+    last_parent_ = node.path_id;
+    ++next_index_;
+    return true;
+}
+
+void IdaFrontier::finish_iteration() {
+    if (full_) {
+        overflowed_ = true;
+        nodes_ = {};
+        paths_ = {};
+        next_nodes_ = {};
+        next_paths_ = {};
+        return;
+    }
+    nodes_.swap(next_nodes_);
+    paths_.swap(next_paths_);
+    next_nodes_.clear();
+    next_paths_.clear();
+    next_index_ = 0;
+    valid_depth_ = 0;
+}
+
+} // namespace RubiksSolver
@@ -0,0 +1,305 @@
+#include "interleaved_solver.h"
+#include "coordinate.h"
+#include "solver.h"
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace RubiksSolver {
+
+namespace {
+
+using TwoPhaseSearch::available_moves;
+using TwoPhaseSearch::is_valid_move;
+
+// 移动表的一行 (18个 uint16_t) 可能跨越两个缓存行
+inline void prefetch_row(const uint16_t* table, uint16_t coord) {
+    const uint16_t* row = table + coord * 18;
+    __builtin_prefetch(row);
+    __builtin_prefetch(row + 17);
+}
+
+inline void prefetch_entry(const uint8_t* table, bool packed, size_t index) {
+    __builtin_prefetch(table + (packed ? index / 2 : index));
+}
+
+} // namespace
+
+// 协程的返回类型：创建后先挂起；被 co_await 时直接转到该协程执行，结束时再转回等待者
+class InterleavedSolver::Task {
+public:
+    struct promise_type {
+        Status status = Status::Running;
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                auto continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_value(Status value) { status = value; }
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        handle_.promise().continuation = caller;
+        return handle_;
+    }
+    Status await_resume() const {
+        rethrow_if_failed();
+        return handle_.promise().status;
+    }
+
+    inline std::coroutine_handle<> handle() const { return handle_; }
+    void rethrow_if_failed() const {
+        if (handle_.promise().exception) std::rethrow_exception(handle_.promise().exception);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// 挂起当前协程，排到调度队列的末尾
+struct InterleavedSolver::Yield {
+    InterleavedSolver& solver;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        solver.ready_.push_back(handle);
+        ++solver.suspensions_;
+    }
+    void await_resume() const noexcept {}
+};
+
+InterleavedSolver::InterleavedSolver(const TableManager& tables, unsigned width, bool table_yields,
+                                     const SearchLimits& limits)
+    : tables_(tables), width_(std::max(1u, width)), table_yields_(table_yields), limits_(limits) {
+}
+
+std::vector<InterleavedSolver::Result> InterleavedSolver::solve(const std::vector<Cube>& cubes) {
+    // 所有表就绪后，组合剪枝表和终局数据库的可用性在整批求解中不变 (与 Solver 的结果一致的前提)
+    tables_.wait_until_all_ready();
+    raw_ = tables_.raw_tables();
+    probe_depth_[0] = std::min(limits_.p1_probe_depth, tables_.endgame_db_depth<1>());
+    probe_depth_[1] = std::min(limits_.p2_probe_depth, tables_.endgame_db_depth<2>());
+
+    std::vector<Result> results(cubes.size());
+    cubes_ = &cubes;
+    results_ = &results;
+    next_item_ = 0;
+
+    std::vector<Task> workers;
+    const size_t count = std::min<size_t>(width_, cubes.size());
+    workers.reserve(count);
+    for (size_t w = 0; w < count; ++w) {
+        workers.push_back(worker());
+        ready_.push_back(workers.back().handle());
+    }
+    // 轮转调度：先挂起的先恢复，两次恢复之间隔着其他协程的工作，预取有时间完成
+    while (!ready_.empty()) {
+        std::coroutine_handle<> handle = ready_.front();
+        ready_.pop_front();
+        handle.resume();
+    }
+
+    cubes_ = nullptr;
+    results_ = nullptr;
+    for (const auto& task : workers) {
+        task.rethrow_if_failed();
+    }
+    return results;
+}
+
+// 与 Solver::solve_with 的流程相同：第二阶段在预算内无解时先继续第一阶段，最后放宽预算
+InterleavedSolver::Task InterleavedSolver::worker() {
+    Search phase1, phase2;
+    while (next_item_ < cubes_->size()) {
+        const size_t item = next_item_++;
+        const Cube& cube = (*cubes_)[item];
+        Result& result = (*results_)[item];
+
+        Phase1Coord p1(cube);
+        const Phase2Tracking tracking(cube);
+        start_search<1>(phase1, p1.get_corner_orientation(), p1.get_edge_orientation(), p1.get_ud_slice_position(),
+                        limits_.phase1_max_depth, 0);
+        phase1.solved_at_start = p1.is_solved();
+        if (co_await ida<1>(phase1) != Status::Found) {
+            result.error = "Phase 1 solution not found within depth limit";
+            continue;
+        }
+
+        int resumes = 0;
+        for (;;) {
+            std::vector<Move> phase1_solution = phase1.path;
+            std::erase_if(phase1_solution, [](Move m) { return m == Move::COUNT; });
+            Phase2Coord p2 = tables_.track_phase2(tracking, phase1_solution.data(), phase1_solution.size());
+            const int budget = std::max(limits_.phase2_min, limits_.phase2_total - static_cast<int>(phase1_solution.size()));
+            start_search<2>(phase2, p2.get_corner_permutation(), p2.get_ud_edge_permutation(),
+                            p2.get_slice_edge_permutation(), budget, 0);
+            phase2.solved_at_start = p2.is_solved();
+
+            Status status = co_await ida<2>(phase2);
+            if (status != Status::Found && resumes < limits_.max_phase1_resumes) {
+                if (co_await ida<1>(phase1) == Status::Found) {
+                    ++resumes;
+                    continue;
+                }
+            }
+            if (status != Status::Found) {
+                start_search<2>(phase2, phase2.x1, phase2.x2, phase2.x3, Solver::PHASE2_MAX_DEPTH, budget + 1);
+                phase2.solved_at_start = phase2.x1 == 0 && phase2.x2 == 0 && phase2.x3 == 0;
+                status = co_await ida<2>(phase2);
+            }
+
+            if (status == Status::Found) {
+                result.solution = std::move(phase1_solution);
+                for (Move m : phase2.path) {
+                    if (m != Move::COUNT) result.solution.push_back(m);
+                }
+            } else {
+                result.error = "Phase 2 solution not found";
+            }
+            break;
+        }
+    }
+    co_return Status::Exhausted;
+}
+
+// 与 Solver::search_iterative 相同的节点处理，在每次查表之前预取并让出执行
+template<uint8_t PHASE>
+InterleavedSolver::Task InterleavedSolver::ida(Search& search) {
+    constexpr auto& MOVES = available_moves<PHASE>();
+    std::vector<Move> endgame_path;
+    std::array<Node, 18> children;
+    std::array<Node, 18> scored_moves;
+
+    Status status = search.resume();
+    while (status == Status::Running) {
+        if (search.stack.empty()) {
+            ++search.max_depth;
+            status = search.resume();
+            continue;
+        }
+        Node current = search.stack.back();
+        search.stack.pop_back();
+        ++nodes_expanded_;
+
+        search.path[current.depth] = current.last_move;
+        if (tables_.is_endgame_db_ready<PHASE>() && current.h <= probe_depth_[PHASE - 1]) {
+            tables_.prefetch_endgame_db<PHASE>(current.x1, current.x2, current.x3);
+            co_await Yield{*this};
+            if (tables_.search_endgame_db<PHASE>(current.x1, current.x2, current.x3, endgame_path)) {
+                search.path.resize(current.depth + 1);
+                search.path.insert(search.path.end(), endgame_path.begin(), endgame_path.end());
+                co_return Status::Found;
+            }
+        }
+        if (current.x1 == 0 && current.x2 == 0 && current.x3 == 0) {
+            search.path.resize(current.depth + 1);
+            co_return Status::Found;
+        }
+
+        // 表都在缓存中时，查表前让出的开销大于等待的时间，默认只在查询终局数据库前让出
+        prefetch_moves<PHASE>(current);
+        if (table_yields_) co_await Yield{*this};
+        int child_count = 0;
+        for (size_t i = 0; i < MOVES.size(); ++i) {
+            if (!is_valid_move(MOVES[i], current.last_move)) {
+                continue;
+            }
+            Node& child = children[child_count++];
+            if constexpr (PHASE == 1) {
+                tables_.get_phase1_moves(current.x1, current.x2, current.x3, MOVES[i], child.x1, child.x2, child.x3);
+            } else {
+                tables_.get_phase2_moves(current.x1, current.x2, current.x3, MOVES[i], child.x1, child.x2, child.x3);
+            }
+            child.last_move = MOVES[i];
+            child.depth = current.depth + 1;
+            prefetch_pruning<PHASE>(child.x1, child.x2, child.x3);
+        }
+
+        if (table_yields_) co_await Yield{*this};
+        int valid_moves = 0;
+        for (int i = 0; i < child_count; ++i) {
+            Node& child = children[i];
+            child.h = pruning<PHASE>(child.x1, child.x2, child.x3);
+            if (child.depth + child.h <= search.max_depth) {
+                scored_moves[valid_moves++] = child;
+            }
+        }
+        std::sort(scored_moves.begin(), scored_moves.begin() + valid_moves,
+                  [](const auto& a, const auto& b) { return a.h < b.h; });
+        for (int i = valid_moves - 1; i >= 0; --i) {
+            search.stack.push_back(scored_moves[i]);
+        }
+    }
+    co_return status;
+}
+
+template<uint8_t PHASE>
+void InterleavedSolver::start_search(Search& search, uint16_t x1, uint16_t x2, uint16_t x3, int limit, int first_depth) {
+    const bool combined = (PHASE == 1 ? raw_.co_uds_pruning : raw_.cp_sep_pruning) != nullptr;
+    search.start<PHASE>(tables_, combined, x1, x2, x3, limit, first_depth);
+}
+
+template<uint8_t PHASE>
+void InterleavedSolver::prefetch_moves(const Node& node) const {
+    if constexpr (PHASE == 1) {
+        prefetch_row(raw_.co_move, node.x1);
+        prefetch_row(raw_.eo_move, node.x2);
+        prefetch_row(raw_.uds_move, node.x3);
+    } else {
+        prefetch_row(raw_.cp_move, node.x1);
+        prefetch_row(raw_.udep_move, node.x2);
+        prefetch_row(raw_.sep_move, node.x3);
+    }
+}
+
+template<uint8_t PHASE>
+void InterleavedSolver::prefetch_pruning(uint16_t x1, uint16_t x2, uint16_t x3) const {
+    if constexpr (PHASE == 1) {
+        if (raw_.co_uds_pruning != nullptr) {
+            prefetch_entry(raw_.co_uds_pruning, raw_.combined_packed, size_t{x1} * 495 + x3);
+            prefetch_entry(raw_.eo_uds_pruning, raw_.combined_packed, size_t{x2} * 495 + x3);
+        } else {
+            prefetch_entry(raw_.co_pruning, false, x1);
+            prefetch_entry(raw_.eo_pruning, false, x2);
+            prefetch_entry(raw_.uds_pruning, false, x3);
+        }
+    } else {
+        if (raw_.cp_sep_pruning != nullptr) {
+            prefetch_entry(raw_.cp_sep_pruning, raw_.combined_packed, size_t{x1} * 24 + x3);
+            prefetch_entry(raw_.udep_sep_pruning, raw_.combined_packed, size_t{x2} * 24 + x3);
+        } else {
+            prefetch_entry(raw_.cp_pruning, false, x1);
+            prefetch_entry(raw_.udep_pruning, false, x2);
+            prefetch_entry(raw_.sep_pruning, false, x3);
+        }
+    }
+}
+
+template<uint8_t PHASE>
+uint8_t InterleavedSolver::pruning(uint16_t x1, uint16_t x2, uint16_t x3) const {
+    const bool combined = (PHASE == 1 ? raw_.co_uds_pruning : raw_.cp_sep_pruning) != nullptr;
+    return TwoPhaseSearch::pruning<PHASE>(tables_, combined, x1, x2, x3);
+}
+
+} // namespace RubiksSolver
@@ -0,0 +1,339 @@
+#include "lockstep_solver.h"
+#include "coordinate.h"
+#include "solver.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+#ifdef RUBIKS_LOCKSTEP_AVX2
+#include <immintrin.h>
+#endif
+
+namespace RubiksSolver {
+
+namespace {
+
+using TwoPhaseSearch::available_moves;
+using TwoPhaseSearch::is_valid_move;
+
+#ifdef RUBIKS_LOCKSTEP_AVX2
+// 以下 gather 只读取表内的字节：从目标项之前开始读取4字节，再移位取出目标项
+// (直接从目标项开始读取时，最后几项会越过表尾)
+
+__attribute__((target("avx2"))) inline __m256i gather_u16(const uint16_t* table, __m256i index) {
+    __m256i start = _mm256_max_epi32(_mm256_sub_epi32(index, _mm256_set1_epi32(1)), _mm256_setzero_si256());
+    __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), start, 2);
+    __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(index, start), 4);
+    return _mm256_and_si256(_mm256_srlv_epi32(words, shift), _mm256_set1_epi32(0xFFFF));
+}
+
+__attribute__((target("avx2"))) inline __m256i gather_u8(const uint8_t* table, __m256i index) {
+    __m256i start = _mm256_max_epi32(_mm256_sub_epi32(index, _mm256_set1_epi32(3)), _mm256_setzero_si256());
+    __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), start, 1);
+    __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(index, start), 3);
+    return _mm256_and_si256(_mm256_srlv_epi32(words, shift), _mm256_set1_epi32(0xFF));
+}
+
+// CompactPruningTable：packed 时每字节两项，低4位在前
+__attribute__((target("avx2"))) inline __m256i gather_pruning(const uint8_t* table, bool packed, __m256i index) {
+    if (!packed) {
+        return gather_u8(table, index);
+    }
+    __m256i byte = gather_u8(table, _mm256_srli_epi32(index, 1));
+    __m256i shift = _mm256_slli_epi32(_mm256_and_si256(index, _mm256_set1_epi32(1)), 2);
+    return _mm256_and_si256(_mm256_srlv_epi32(byte, shift), _mm256_set1_epi32(0x0F));
+}
+
+__attribute__((target("avx2"))) inline __m256i load_coords(const std::array<uint16_t, LockstepSolver::LANES>& coords) {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(coords.data())));
+}
+#endif
+
+} // namespace
+
+LockstepSolver::LockstepSolver(const TableManager& tables, const SearchLimits& limits)
+    : tables_(tables), limits_(limits), avx2_(uses_avx2()) {
+}
+
+bool LockstepSolver::uses_avx2() {
+#ifdef RUBIKS_LOCKSTEP_AVX2
+    // RUBIKS_LOCKSTEP_SCALAR=1 强制使用标量查询 (用于比较)
+    const char* scalar = std::getenv("RUBIKS_LOCKSTEP_SCALAR");
+    return __builtin_cpu_supports("avx2") && !(scalar != nullptr && std::string(scalar) == "1");
+#else
+    return false;
+#endif
+}
+
+std::vector<LockstepSolver::Result> LockstepSolver::solve(const std::vector<Cube>& cubes) {
+    // 所有表就绪后，组合剪枝表和终局数据库的可用性在整批求解中不变 (与 Solver 的结果一致的前提)
+    tables_.wait_until_all_ready();
+    raw_ = tables_.raw_tables();
+    probe_depth_[0] = std::min(limits_.p1_probe_depth, tables_.endgame_db_depth<1>());
+    probe_depth_[1] = std::min(limits_.p2_probe_depth, tables_.endgame_db_depth<2>());
+
+    std::vector<Result> results(cubes.size());
+    cubes_ = &cubes;
+    results_ = &results;
+    next_item_ = 0;
+    for (auto& lane : lanes_) {
+        advance(lane, refill(lane));
+    }
+
+    for (;;) {
+        Expansion phase1, phase2;
+        std::array<bool, LANES> found{};
+        bool active = false;
+        for (int l = 0; l < LANES; ++l) {
+            Lane& lane = lanes_[l];
+            if (lane.stage == Stage::Idle) continue;
+            active = true;
+            found[l] = lane.stage == Stage::Phase1 ? visit<1>(l, lane.phase1, phase1)
+                                                   : visit<2>(l, lane.phase2, phase2);
+        }
+        if (!active) break;
+
+        ++steps_;
+        lane_steps_ += std::popcount(phase1.mask) + std::popcount(phase2.mask);
+        expand<1>(phase1);
+        expand<2>(phase2);
+
+        // 找到解，或者栈已空 (本轮迭代结束) 的通道推进状态机
+        for (int l = 0; l < LANES; ++l) {
+            Lane& lane = lanes_[l];
+            if (found[l]) {
+                advance(lane, Status::Found);
+            } else if (lane.stage != Stage::Idle && current_search(lane).stack.empty()) {
+                Search& search = current_search(lane);
+                ++search.max_depth;
+                advance(lane, search.resume());
+            }
+        }
+    }
+
+    cubes_ = nullptr;
+    results_ = nullptr;
+    return results;
+}
+
+LockstepSolver::Status LockstepSolver::refill(Lane& lane) {
+    if (next_item_ >= cubes_->size()) {
+        lane.stage = Stage::Idle;
+        return Status::Running;
+    }
+    lane.item = next_item_++;
+    lane.resumes = 0;
+    lane.resuming = false;
+    lane.stage = Stage::Phase1;
+    Phase1Coord p1((*cubes_)[lane.item]);
+    start_search<1>(lane.phase1, p1.get_corner_orientation(), p1.get_edge_orientation(), p1.get_ud_slice_position(),
+                    limits_.phase1_max_depth, 0);
+    lane.phase1.solved_at_start = p1.is_solved();
+    return lane.phase1.resume();
+}
+
+template<uint8_t PHASE>
+void LockstepSolver::start_search(Search& search, uint16_t x1, uint16_t x2, uint16_t x3, int limit, int first_depth) {
+    const bool combined = (PHASE == 1 ? raw_.co_uds_pruning : raw_.cp_sep_pruning) != nullptr;
+    search.start<PHASE>(tables_, combined, x1, x2, x3, limit, first_depth);
+}
+
+LockstepSolver::Status LockstepSolver::begin_phase2(Lane& lane) {
+    std::erase_if(lane.phase1_solution, [](Move m) { return m == Move::COUNT; });
+    Phase2Coord p2 = tables_.track_phase2(Phase2Tracking((*cubes_)[lane.item]), lane.phase1_solution.data(),
+                                          lane.phase1_solution.size());
+    lane.budget = std::max(limits_.phase2_min, limits_.phase2_total - static_cast<int>(lane.phase1_solution.size()));
+    start_search<2>(lane.phase2, p2.get_corner_permutation(), p2.get_ud_edge_permutation(),
+                    p2.get_slice_edge_permutation(), lane.budget, 0);
+    lane.phase2.solved_at_start = p2.is_solved();
+    lane.stage = Stage::Phase2;
+    return lane.phase2.resume();
+}
+
+LockstepSolver::Status LockstepSolver::widen(Lane& lane) {
+    Search& search = lane.phase2;
+    start_search<2>(search, search.x1, search.x2, search.x3, Solver::PHASE2_MAX_DEPTH, lane.budget + 1);
+    search.solved_at_start = search.x1 == 0 && search.x2 == 0 && search.x3 == 0;
+    lane.stage = Stage::Widened;
+    return search.resume();
+}
+
+// 与 Solver::solve_with 的流程相同：第二阶段在预算内无解时先继续第一阶段，最后放宽预算
+void LockstepSolver::advance(Lane& lane, Status status) {
+    auto finish = [&](std::vector<Move> solution, std::string error) {
+        Result& result = (*results_)[lane.item];
+        result.solution = std::move(solution);
+        result.error = std::move(error);
+        return refill(lane);
+    };
+    while (status != Status::Running) {
+        switch (lane.stage) {
+            case Stage::Idle:
+                return;
+            case Stage::Phase1:
+                if (status == Status::Found) {
+                    if (lane.resuming) ++lane.resumes;
+                    lane.phase1_solution = lane.phase1.path;
+                    status = begin_phase2(lane);
+                } else if (!lane.resuming) {
+                    status = finish({}, "Phase 1 solution not found within depth limit");
+                } else {
+                    status = widen(lane);
+                }
+                break;
+            case Stage::Phase2:
+            case Stage::Widened:
+                if (status == Status::Found) {
+                    std::vector<Move> solution = lane.phase1_solution;
+                    for (Move m : lane.phase2.path) {
+                        if (m != Move::COUNT) solution.push_back(m);
+                    }
+                    status = finish(std::move(solution), "");
+                } else if (lane.stage == Stage::Widened) {
+                    status = finish({}, "Phase 2 solution not found");
+                } else if (lane.resumes < limits_.max_phase1_resumes) {
+                    lane.stage = Stage::Phase1;
+                    lane.resuming = true;
+                    status = lane.phase1.resume();
+                } else {
+                    status = widen(lane);
+                }
+                break;
+        }
+    }
+}
+
+// 与 Solver::search_iterative 循环体的前半部分相同
+template<uint8_t PHASE>
+bool LockstepSolver::visit(int lane_index, Search& search, Expansion& expansion) {
+    Node current = search.stack.back();
+    search.stack.pop_back();
+    ++nodes_expanded_;
+
+    search.path[current.depth] = current.last_move;
+    if (tables_.is_endgame_db_ready<PHASE>() && current.h <= probe_depth_[PHASE - 1]) {
+        if (tables_.search_endgame_db<PHASE>(current.x1, current.x2, current.x3, endgame_path_)) {
+            search.path.resize(current.depth + 1);
+            search.path.insert(search.path.end(), endgame_path_.begin(), endgame_path_.end());
+            return true;
+        }
+    }
+    if (current.x1 == 0 && current.x2 == 0 && current.x3 == 0) {
+        search.path.resize(current.depth + 1);
+        return true;
+    }
+
+    expansion.mask |= 1u << lane_index;
+    expansion.x1[lane_index] = current.x1;
+    expansion.x2[lane_index] = current.x2;
+    expansion.x3[lane_index] = current.x3;
+    expansion.depth[lane_index] = current.depth;
+    expansion.h[lane_index] = current.h;
+    expansion.bound[lane_index] = search.max_depth;
+    expansion.last_move[lane_index] = current.last_move;
+    return false;
+}
+
+// 与 Solver::search_iterative 循环体的后半部分相同 (子节点按启发值排序后逆序压栈)
+template<uint8_t PHASE>
+void LockstepSolver::expand(const Expansion& expansion) {
+    if (expansion.mask == 0) return;
+    constexpr auto& MOVES = available_moves<PHASE>();
+
+    Children children;
+#ifdef RUBIKS_LOCKSTEP_AVX2
+    if (avx2_) {
+        children_avx2<PHASE>(expansion, children);
+    } else {
+        children_scalar<PHASE>(expansion, children);
+    }
+#else
+    children_scalar<PHASE>(expansion, children);
+#endif
+
+    for (int l = 0; l < LANES; ++l) {
+        if (!(expansion.mask & (1u << l))) continue;
+        Search& search = current_search(lanes_[l]);
+        std::array<Node, 18> scored_moves;
+        int valid_moves = 0;
+        for (size_t i = 0; i < MOVES.size(); ++i) {
+            if (!is_valid_move(MOVES[i], expansion.last_move[l])) {
+                continue;
+            }
+            int next_h = static_cast<int>(children.h[i][l]);
+            if (expansion.depth[l] + 1 + next_h <= expansion.bound[l]) {
+                scored_moves[valid_moves++] = {static_cast<uint16_t>(children.x1[i][l]), static_cast<uint16_t>(children.x2[i][l]),
+                                               static_cast<uint16_t>(children.x3[i][l]), MOVES[i], expansion.depth[l] + 1, next_h};
+            }
+        }
+        std::sort(scored_moves.begin(), scored_moves.begin() + valid_moves,
+                  [](const auto& a, const auto& b) { return a.h < b.h; });
+        for (int i = valid_moves - 1; i >= 0; --i) {
+            search.stack.push_back(scored_moves[i]);
+        }
+    }
+}
+
+template<uint8_t PHASE>
+void LockstepSolver::children_scalar(const Expansion& expansion, Children& children) const {
+    constexpr auto& MOVES = available_moves<PHASE>();
+    const bool combined = (PHASE == 1 ? raw_.co_uds_pruning : raw_.cp_sep_pruning) != nullptr;
+    for (size_t i = 0; i < MOVES.size(); ++i) {
+        for (int l = 0; l < LANES; ++l) {
+            if (!(expansion.mask & (1u << l))) continue;
+            uint16_t x1, x2, x3;
+            if constexpr (PHASE == 1) {
+                tables_.get_phase1_moves(expansion.x1[l], expansion.x2[l], expansion.x3[l], MOVES[i], x1, x2, x3);
+            } else {
+                tables_.get_phase2_moves(expansion.x1[l], expansion.x2[l], expansion.x3[l], MOVES[i], x1, x2, x3);
+            }
+            children.x1[i][l] = x1;
+            children.x2[i][l] = x2;
+            children.x3[i][l] = x3;
+            children.h[i][l] = TwoPhaseSearch::pruning<PHASE>(tables_, combined, x1, x2, x3);
+        }
+    }
+}
+
+#ifdef RUBIKS_LOCKSTEP_AVX2
+// 每个转动：3 条 gather 取子节点坐标，2 至 3 条 gather 取剪枝值，覆盖所有通道
+// 不需要展开的通道坐标为0，照常计算，结果不使用
+template<uint8_t PHASE>
+__attribute__((target("avx2"))) void LockstepSolver::children_avx2(const Expansion& expansion, Children& children) const {
+    constexpr auto& MOVES = available_moves<PHASE>();
+    const uint16_t* move1 = PHASE == 1 ? raw_.co_move : raw_.cp_move;
+    const uint16_t* move2 = PHASE == 1 ? raw_.eo_move : raw_.udep_move;
+    const uint16_t* move3 = PHASE == 1 ? raw_.uds_move : raw_.sep_move;
+    const uint8_t* combined1 = PHASE == 1 ? raw_.co_uds_pruning : raw_.cp_sep_pruning;
+    const uint8_t* combined2 = PHASE == 1 ? raw_.eo_uds_pruning : raw_.udep_sep_pruning;
+    const __m256i combined_stride = _mm256_set1_epi32(PHASE == 1 ? 495 : 24);
+    const __m256i row = _mm256_set1_epi32(18);
+
+    const __m256i x1 = _mm256_mullo_epi32(load_coords(expansion.x1), row);
+    const __m256i x2 = _mm256_mullo_epi32(load_coords(expansion.x2), row);
+    const __m256i x3 = _mm256_mullo_epi32(load_coords(expansion.x3), row);
+    for (size_t i = 0; i < MOVES.size(); ++i) {
+        const __m256i move = _mm256_set1_epi32(static_cast<int>(MOVES[i]));
+        __m256i n1 = gather_u16(move1, _mm256_add_epi32(x1, move));
+        __m256i n2 = gather_u16(move2, _mm256_add_epi32(x2, move));
+        __m256i n3 = gather_u16(move3, _mm256_add_epi32(x3, move));
+        __m256i h;
+        if (combined1 != nullptr) {
+            h = _mm256_max_epu32(
+                gather_pruning(combined1, raw_.combined_packed, _mm256_add_epi32(_mm256_mullo_epi32(n1, combined_stride), n3)),
+                gather_pruning(combined2, raw_.combined_packed, _mm256_add_epi32(_mm256_mullo_epi32(n2, combined_stride), n3)));
+        } else {
+            const uint8_t* pruning1 = PHASE == 1 ? raw_.co_pruning : raw_.cp_pruning;
+            const uint8_t* pruning2 = PHASE == 1 ? raw_.eo_pruning : raw_.udep_pruning;
+            const uint8_t* pruning3 = PHASE == 1 ? raw_.uds_pruning : raw_.sep_pruning;
+            h = _mm256_max_epu32(_mm256_max_epu32(gather_u8(pruning1, n1), gather_u8(pruning2, n2)), gather_u8(pruning3, n3));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(children.x1[i].data()), n1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(children.x2[i].data()), n2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(children.x3[i].data()), n3);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(children.h[i].data()), h);
+    }
+}
+#endif
+
+} // namespace RubiksSolver
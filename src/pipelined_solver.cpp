@@ -0,0 +1,270 @@
+#include "pipelined_solver.h"
+#include "bounded_queue.h"
+#include "coordinate.h"
+#include "two_phase_search.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace RubiksSolver {
+
+namespace {
+
+using TwoPhaseSearch::is_valid_move;
+
+// 以第二阶段转动结尾的第一阶段路径，去掉最后一步仍在 G1 中，得到的解与更短的终点重复
+inline bool is_phase2_move(Move move) {
+    return std::find(Phase2Coord::AVAILABLE_MOVES.begin(), Phase2Coord::AVAILABLE_MOVES.end(), move)
+           != Phase2Coord::AVAILABLE_MOVES.end();
+}
+
+// 每展开 STOP_CHECK_MASK + 1 个节点检查一次时间预算
+constexpr uint64_t STOP_CHECK_MASK = 1023;
+
+} // namespace
+
+PipelinedSolver::PipelinedSolver(const TableManager& tables, const Options& options)
+    : tables_(tables), options_(options) {
+    // 第一阶段最长 MAX_PHASE1_LENGTH 步，第二阶段最长18步 (G1 的直径)
+    if (options_.max_length < 1 || options_.max_length > MAX_PHASE1_LENGTH + 18) {
+        throw std::invalid_argument("Pipelined solver max_length out of range: " + std::to_string(options_.max_length));
+    }
+}
+
+std::vector<Move> PipelinedSolver::solve(const Cube& cube) {
+    tables_.wait_until_all_ready();
+    // 终局数据库不可用时不查询
+    probe_depth_[0] = tables_.is_endgame_db_ready<1>() ? std::min(options_.limits.p1_probe_depth, tables_.endgame_db_depth<1>()) : -1;
+    probe_depth_[1] = tables_.is_endgame_db_ready<2>() ? std::min(options_.limits.p2_probe_depth, tables_.endgame_db_depth<2>()) : -1;
+    stats_ = Stats{};
+    cube_ = &cube;
+    start_ = std::chrono::steady_clock::now();
+    deadline_ = start_ + std::chrono::microseconds(options_.budget_us);
+    best_length_.store(options_.max_length + 1);
+    stop_.store(false);
+    best_solution_.clear();
+
+    std::vector<Worker> workers;
+    if (options_.serial) {
+        workers.resize(1);
+        Worker& worker = workers[0];
+        enumerate_phase1(0, 1, worker, [&](const std::array<Move, MAX_PHASE1_LENGTH>& path, int length) {
+            Endpoint endpoint;
+            if (make_endpoint(path, length, worker, endpoint)) {
+                ++worker.endpoints;
+                search_phase2(endpoint, worker);
+            }
+            return !stop_.load(std::memory_order_relaxed);
+        });
+    } else {
+        // 首步只有18种，更多的第一阶段线程没有工作
+        const unsigned producers = std::clamp(options_.phase1_threads, 1u, 18u);
+        const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        const unsigned consumers = options_.phase2_threads > 0 ? options_.phase2_threads
+                                                               : std::max(1u, hardware > producers ? hardware - producers : 1u);
+        workers.resize(producers + consumers);
+        BoundedQueue<Endpoint> queue(options_.queue_capacity);
+
+        std::vector<std::thread> phase2_threads;
+        for (unsigned c = 0; c < consumers; ++c) {
+            phase2_threads.emplace_back([&, c]() {
+                Worker& worker = workers[producers + c];
+                for (;;) {
+                    Endpoint endpoint = queue.pop();
+                    if (endpoint.length == END_OF_STREAM) break;
+                    // 停止后只取出剩余的终点，直到结束标记
+                    if (!stop_.load(std::memory_order_relaxed)) {
+                        search_phase2(endpoint, worker);
+                    }
+                }
+            });
+        }
+        std::vector<std::thread> phase1_threads;
+        for (unsigned p = 0; p < producers; ++p) {
+            phase1_threads.emplace_back([&, p]() {
+                Worker& worker = workers[p];
+                enumerate_phase1(p, producers, worker, [&](const std::array<Move, MAX_PHASE1_LENGTH>& path, int length) {
+                    Endpoint endpoint;
+                    if (!make_endpoint(path, length, worker, endpoint)) {
+                        return true;
+                    }
+                    ++worker.endpoints;
+                    for (unsigned spins = 0; !queue.try_push(endpoint); ++spins) {
+                        if (stop_.load(std::memory_order_relaxed)) return false;
+                        if (spins >= 32) std::this_thread::yield();
+                    }
+                    return true;
+                });
+            });
+        }
+        for (auto& thread : phase1_threads) {
+            thread.join();
+        }
+        Endpoint end_of_stream{};
+        end_of_stream.length = END_OF_STREAM;
+        for (unsigned c = 0; c < consumers; ++c) {
+            queue.push(end_of_stream);
+        }
+        for (auto& thread : phase2_threads) {
+            thread.join();
+        }
+    }
+
+    for (const auto& worker : workers) {
+        stats_.endpoints += worker.endpoints;
+        stats_.endpoints_searched += worker.endpoints_searched;
+        stats_.phase1_nodes += worker.phase1_nodes;
+        stats_.phase2_nodes += worker.phase2_nodes;
+    }
+    cube_ = nullptr;
+    if (best_length_.load() > options_.max_length) {
+        throw std::runtime_error("No solution found within " + std::to_string(options_.max_length) + " moves");
+    }
+    return best_solution_;
+}
+
+template<typename Emit>
+void PipelinedSolver::enumerate_phase1(unsigned index, unsigned count, Worker& worker, Emit&& emit) {
+    Phase1Coord p1(*cube_);
+    const uint16_t co = p1.get_corner_orientation();
+    const uint16_t eo = p1.get_edge_orientation();
+    const uint16_t uds = p1.get_ud_slice_position();
+    const int max_depth = std::min(options_.limits.phase1_max_depth, MAX_PHASE1_LENGTH);
+    std::array<Move, MAX_PHASE1_LENGTH> path{};
+    worker.tracked[0] = Phase2Tracking(*cube_);
+    worker.tracked_depth = 0;
+    // 第一阶段长度不小于当前最优长度时，不可能得到更短的解
+    for (int bound = TwoPhaseSearch::pruning<1>(tables_, co, eo, uds); bound <= max_depth; ++bound) {
+        if (bound >= best_length_.load(std::memory_order_relaxed)) break;
+        if (!phase1_dfs(co, eo, uds, Move::COUNT, 0, bound, index, count, path, worker, emit)) break;
+    }
+}
+
+// 返回 false 表示停止枚举 (已停止，或者 bound 已不可能得到更短的解)
+template<typename Emit>
+bool PipelinedSolver::phase1_dfs(uint16_t co, uint16_t eo, uint16_t uds, Move last, int depth, int bound, unsigned index,
+                                 unsigned count, std::array<Move, MAX_PHASE1_LENGTH>& path, Worker& worker, Emit& emit) {
+    if (should_stop(++worker.phase1_nodes)) return false;
+    const int h = TwoPhaseSearch::pruning<1>(tables_, co, eo, uds);
+    if (depth + h > bound) return true;
+    // 终局数据库给出到 G1 的准确距离，只用来剪枝：距离更短时仍要枚举恰好 bound 步的其他路径
+    if (h <= probe_depth_[0]) {
+        if (tables_.search_endgame_db<1>(co, eo, uds, worker.endgame_path)) {
+            if (depth + static_cast<int>(worker.endgame_path.size()) > bound) return true;
+        } else if (depth + tables_.endgame_db_depth<1>() + 1 > bound) {
+            return true;
+        }
+    }
+    if (depth == bound) {
+        if (co == 0 && eo == 0 && uds == 0 && (depth == 0 || !is_phase2_move(last))) {
+            return emit(path, depth);
+        }
+        return true;
+    }
+    if (bound >= best_length_.load(std::memory_order_relaxed)) return false;
+
+    for (size_t i = 0; i < Phase1Coord::AVAILABLE_MOVES.size(); ++i) {
+        const Move move = Phase1Coord::AVAILABLE_MOVES[i];
+        if (depth == 0 && i % count != index) continue;
+        if (!is_valid_move(move, last)) continue;
+        uint16_t next_co, next_eo, next_uds;
+        tables_.get_phase1_moves(co, eo, uds, move, next_co, next_eo, next_uds);
+        path[depth] = move;
+        worker.tracked_depth = std::min(worker.tracked_depth, depth);
+        if (!phase1_dfs(next_co, next_eo, next_uds, move, depth + 1, bound, index, count, path, worker, emit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PipelinedSolver::make_endpoint(const std::array<Move, MAX_PHASE1_LENGTH>& path, int length, Worker& worker,
+                                    Endpoint& endpoint) const {
+    for (int i = worker.tracked_depth; i < length; ++i) {
+        worker.tracked[i + 1] = tables_.get_tracking_move(worker.tracked[i], path[i]);
+    }
+    worker.tracked_depth = length;
+    Phase2Coord p2 = worker.tracked[length].to_phase2();
+    endpoint.cp = p2.get_corner_permutation();
+    endpoint.udep = p2.get_ud_edge_permutation();
+    endpoint.sep = p2.get_slice_edge_permutation();
+    endpoint.length = static_cast<uint8_t>(length);
+    endpoint.path = path;
+    return length + TwoPhaseSearch::pruning<2>(tables_, endpoint.cp, endpoint.udep, endpoint.sep)
+           < best_length_.load(std::memory_order_relaxed);
+}
+
+void PipelinedSolver::search_phase2(const Endpoint& endpoint, Worker& worker) {
+    ++worker.endpoints_searched;
+    const Move last = endpoint.length > 0 ? endpoint.path[endpoint.length - 1] : Move::COUNT;
+    std::vector<Move> path;
+    // 每轮迭代前重新读取最优长度：其他线程 (或本终点) 找到更短的解后，深度上限随之收紧
+    // 终局数据库给出的解可能长于本轮的 bound；找到后以新的上限重做本轮，直到本轮无解再加深
+    int bound = TwoPhaseSearch::pruning<2>(tables_, endpoint.cp, endpoint.udep, endpoint.sep);
+    for (;;) {
+        const int limit = best_length_.load(std::memory_order_relaxed) - 1 - endpoint.length;
+        if (bound > limit || stop_.load(std::memory_order_relaxed)) return;
+        path.clear();
+        if (phase2_dfs(endpoint.cp, endpoint.udep, endpoint.sep, last, 0, bound, limit, path, worker)) {
+            offer(endpoint, path);
+        } else {
+            ++bound;
+        }
+    }
+}
+
+// bound 为本轮的深度上限 (启发值剪枝)；终局数据库的解只要不超过 limit 就接受
+bool PipelinedSolver::phase2_dfs(uint16_t cp, uint16_t udep, uint16_t sep, Move last, int depth, int bound, int limit,
+                                 std::vector<Move>& path, Worker& worker) {
+    if (should_stop(++worker.phase2_nodes)) return false;
+    if (cp == 0 && udep == 0 && sep == 0) return true;
+    const int h = TwoPhaseSearch::pruning<2>(tables_, cp, udep, sep);
+    if (depth + h > bound) return false;
+    if (h <= probe_depth_[1]) {
+        // 数据库中的路径是最短路径；不在数据库中的状态距离大于数据库深度
+        if (tables_.search_endgame_db<2>(cp, udep, sep, worker.endgame_path)) {
+            if (depth + static_cast<int>(worker.endgame_path.size()) > limit) return false;
+            path.insert(path.end(), worker.endgame_path.begin(), worker.endgame_path.end());
+            return true;
+        }
+        if (depth + tables_.endgame_db_depth<2>() + 1 > limit) return false;
+    }
+
+    for (Move move : Phase2Coord::AVAILABLE_MOVES) {
+        if (!is_valid_move(move, last)) continue;
+        uint16_t next_cp, next_udep, next_sep;
+        tables_.get_phase2_moves(cp, udep, sep, move, next_cp, next_udep, next_sep);
+        path.push_back(move);
+        if (phase2_dfs(next_cp, next_udep, next_sep, move, depth + 1, bound, limit, path, worker)) return true;
+        path.pop_back();
+    }
+    return false;
+}
+
+void PipelinedSolver::offer(const Endpoint& endpoint, const std::vector<Move>& phase2_path) {
+    const int length = endpoint.length + static_cast<int>(phase2_path.size());
+    std::lock_guard<std::mutex> lock(best_mutex_);
+    if (length >= best_length_.load(std::memory_order_relaxed)) return;
+    best_solution_.assign(endpoint.path.begin(), endpoint.path.begin() + endpoint.length);
+    best_solution_.insert(best_solution_.end(), phase2_path.begin(), phase2_path.end());
+    best_length_.store(length, std::memory_order_relaxed);
+
+    const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+    if (stats_.improvements++ == 0) stats_.first_solution_ns = ns;
+    stats_.best_solution_ns = ns;
+    if (length <= options_.target_length) {
+        stop_.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool PipelinedSolver::should_stop(uint64_t nodes) {
+    if ((nodes & STOP_CHECK_MASK) == 0 && !stop_.load(std::memory_order_relaxed)
+        && best_length_.load(std::memory_order_relaxed) <= options_.max_length
+        && std::chrono::steady_clock::now() >= deadline_) {
+        stop_.store(true, std::memory_order_relaxed);
+    }
+    return stop_.load(std::memory_order_relaxed);
+}
+
+} // namespace RubiksSolver
@@ -0,0 +1,147 @@
+#include "racing_solver.h"
+#include "packed_cube.h"
+#include "symmetry.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace RubiksSolver {
+
+namespace {
+
+// 倒序并逐步取逆 (U <-> U'，U2 不变)
+std::vector<Move> inverse_sequence(const std::vector<Move>& moves) {
+    std::vector<Move> result;
+    result.reserve(moves.size());
+    for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+        result.push_back(invert_move(*it));
+    }
+    return result;
+}
+
+// 找到一个把指定面变换到 U 面的旋转 (非镜像) 对称
+uint8_t rotation_to_up(int face) {
+    const auto& table = symmetries();
+    for (int s = 0; s < SYMMETRY_COUNT; ++s) {
+        if (!table[s].reflection && table[s].face_map[face] == 0) return static_cast<uint8_t>(s);
+    }
+    throw std::logic_error("No rotation maps the face to U");
+}
+
+} // namespace
+
+RacingSolver::RacingSolver(const TableManager& tables, const Options& options)
+    : options_(options),
+      axis_symmetry_{0, rotation_to_up(1), rotation_to_up(2)} {
+    unsigned threads = std::max(1u, std::min<unsigned>(options.threads, VARIANT_COUNT));
+    for (unsigned t = 0; t < threads; ++t) {
+        solvers_.push_back(std::make_unique<Solver>(tables, false));
+        solvers_.back()->set_cancel_flag(&cancel_);
+        solvers_.back()->set_options(options.solve);
+    }
+    for (unsigned t = 0; t < threads; ++t) {
+        workers_.emplace_back([this, t]() {
+            Solver& solver = *solvers_[t];
+            std::unique_lock lock(mutex_);
+            for (;;) {
+                work_ready_.wait(lock, [this]() { return shutdown_ || next_variant_ < VARIANT_COUNT; });
+                if (shutdown_) return;
+                int v = next_variant_++;
+                Cube cube = variants_[v].cube;
+                lock.unlock();
+
+                std::vector<Move> solution;
+                bool success = false;
+                try {
+                    solution = solver.solve(cube);
+                    success = true;
+                } catch (const std::exception&) {
+                    // 取消或搜索失败都只是这个变体没有结果
+                }
+
+                lock.lock();
+                variants_[v].solution = std::move(solution);
+                variants_[v].success = success;
+                variants_[v].done = true;
+                ++finished_;
+                if (success && last_race_.winner < 0) {
+                    last_race_.winner = v;
+                }
+                variant_done_.notify_all();
+            }
+        });
+    }
+}
+
+RacingSolver::~RacingSolver() {
+    {
+        std::lock_guard lock(mutex_);
+        shutdown_ = true;
+        cancel_ = true;
+    }
+    work_ready_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+bool RacingSolver::race_finished() const {
+    if (finished_ == VARIANT_COUNT) return true;
+    // 没有预算或预算已用完时，有一个解就结束
+    return (options_.budget_us == 0 || deadline_passed_) && last_race_.winner >= 0;
+}
+
+std::vector<Move> RacingSolver::solve(const Cube& cube) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(options_.budget_us);
+    const auto& table = symmetries();
+    const Cube inverse = PackedCube(cube).inverse().to_cube();
+
+    std::unique_lock lock(mutex_);
+    for (int v = 0; v < VARIANT_COUNT; ++v) {
+        const Cube& base = (v & 1) ? inverse : cube;
+        int axis = v / 2;
+        variants_[v].cube = axis == 0 ? base : conjugate(base, table[axis_symmetry_[axis]]);
+        variants_[v].solution.clear();
+        variants_[v].done = false;
+        variants_[v].success = false;
+    }
+    last_race_ = RaceStats{};
+    cancel_ = false;
+    deadline_passed_ = false;
+    finished_ = 0;
+    next_variant_ = 0;
+    work_ready_.notify_all();
+
+    if (options_.budget_us > 0) {
+        variant_done_.wait_until(lock, deadline, [this]() { return finished_ == VARIANT_COUNT; });
+        deadline_passed_ = true;
+    }
+    variant_done_.wait(lock, [this]() { return race_finished(); });
+
+    // 取消其余搜索，并等待它们退出后才能复用各变体和 Solver
+    cancel_ = true;
+    variant_done_.wait(lock, [this]() { return finished_ == VARIANT_COUNT; });
+
+    int best = last_race_.winner;
+    for (int v = 0; v < VARIANT_COUNT; ++v) {
+        const Variant& variant = variants_[v];
+        last_race_.lengths[v] = variant.success ? static_cast<int>(variant.solution.size()) : -1;
+        if (options_.budget_us > 0 && variant.success && variant.solution.size() < variants_[best].solution.size()) {
+            best = v;
+        }
+    }
+    if (best < 0) {
+        throw std::runtime_error("No variant found a solution");
+    }
+    last_race_.winner = best;
+
+    // 变换回原坐标系：先撤销轴的共轭，再处理取逆
+    std::vector<Move> solution = variants_[best].solution;
+    int axis = best / 2;
+    if (axis != 0) {
+        solution = map_moves(table[table[axis_symmetry_[axis]].inverse], solution);
+    }
+    if (best & 1) {
+        solution = inverse_sequence(solution);
+    }
+    return solution;
+}
+
+} // namespace RubiksSolver
@@ -0,0 +1,66 @@
+#include "random_state.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace RubiksSolver {
+
+namespace {
+
+// 洗牌并返回排列的奇偶性 (交换次数的奇偶)
+template<size_t N>
+int shuffle_with_parity(std::array<uint8_t, N>& pieces, std::mt19937_64& rng) {
+    std::iota(pieces.begin(), pieces.end(), 0);
+    int parity = 0;
+    for (size_t i = N - 1; i > 0; --i) {
+        std::uniform_int_distribution<size_t> dist(0, i);
+        size_t j = dist(rng);
+        if (j != i) {
+            std::swap(pieces[i], pieces[j]);
+            parity ^= 1;
+        }
+    }
+    return parity;
+}
+
+} // namespace
+
+Cube RandomStateGenerator::next() {
+    std::array<uint8_t, 8> corner_pieces, corner_orientations{};
+    std::array<uint8_t, 12> edge_pieces, edge_orientations{};
+
+    int corner_parity = shuffle_with_parity(corner_pieces, rng_);
+    int edge_parity = shuffle_with_parity(edge_pieces, rng_);
+    if (corner_parity != edge_parity) {
+        std::swap(edge_pieces[10], edge_pieces[11]);
+    }
+
+    std::uniform_int_distribution<int> twist(0, 2);
+    int twist_sum = 0;
+    for (int i = 0; i < 7; ++i) {
+        corner_orientations[i] = twist(rng_);
+        twist_sum += corner_orientations[i];
+    }
+    corner_orientations[7] = (3 - twist_sum % 3) % 3;
+
+    std::uniform_int_distribution<int> flip(0, 1);
+    int flip_sum = 0;
+    for (int i = 0; i < 11; ++i) {
+        edge_orientations[i] = flip(rng_);
+        flip_sum += edge_orientations[i];
+    }
+    edge_orientations[11] = flip_sum & 1;
+
+    return Cube::from_pieces(corner_pieces, corner_orientations, edge_pieces, edge_orientations);
+}
+
+std::vector<Cube> RandomStateGenerator::generate(size_t count) {
+    std::vector<Cube> cubes;
+    cubes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        cubes.push_back(next());
+    }
+    return cubes;
+}
+
+} // namespace RubiksSolver
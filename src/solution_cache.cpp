@@ -0,0 +1,225 @@
+#include "solution_cache.h"
+#include "symmetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RubiksSolver {
+
+namespace {
+
+// 快照文件头，补齐到一个缓存项的大小
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;
+    uint64_t count;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(SnapshotHeader) == 64);
+
+constexpr char SNAPSHOT_MAGIC[8] = {'R', 'B', 'K', 'C', 'A', 'C', 'H', 'E'};
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+// 非中心色块在144位键中的位置：按色块顺序从最高位开始，每个字占16个色块
+constexpr std::array<uint8_t, 54> build_key_ordinals() {
+    std::array<uint8_t, 54> ordinals{};
+    for (int i = 0; i < 54; ++i) {
+        int within = i % 9;
+        ordinals[i] = static_cast<uint8_t>((i / 9) * 8 + (within < 4 ? within : within - 1));
+    }
+    return ordinals;
+}
+constexpr std::array<uint8_t, 54> KEY_ORDINALS = build_key_ordinals();
+
+} // namespace
+
+SolutionCache::SolutionCache(size_t capacity)
+    : capacity_per_shard_(std::max<size_t>(1, (capacity + SHARD_COUNT - 1) / SHARD_COUNT)),
+      shards_(std::make_unique<Shard[]>(SHARD_COUNT)) {
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        shards_[i].slots.reserve(capacity_per_shard_);
+        shards_[i].referenced.reserve(capacity_per_shard_);
+        shards_[i].index.reserve(capacity_per_shard_);
+    }
+    symmetries(); // 预先构造对称表，避免计入第一次查找的时间
+}
+
+SolutionCache::CanonicalForm SolutionCache::canonicalize(const Cube& cube) {
+    const FaceletFaces faces = facelet_faces(cube);
+    const auto& table = symmetries();
+    CanonicalForm best;
+    for (int s = 0; s < SYMMETRY_COUNT; ++s) {
+        const Symmetry& symmetry = table[s];
+        Key key{};
+        for (int i = 0; i < 54; ++i) {
+            if (i % 9 == 4) continue; // 中心色块不变
+            uint8_t ordinal = KEY_ORDINALS[symmetry.facelet_target[i]];
+            key[ordinal / 16] |= static_cast<uint64_t>(symmetry.face_map[faces[i]]) << ((15 - ordinal % 16) * 3);
+        }
+        if (s == 0 || key < best.key) {
+            best.key = key;
+            best.symmetry = static_cast<uint8_t>(s);
+        }
+    }
+    return best;
+}
+
+bool SolutionCache::lookup(const Cube& cube, std::vector<Move>& solution, CanonicalForm& form) {
+    auto start = std::chrono::steady_clock::now();
+    form = canonicalize(cube);
+    bool hit = false;
+    {
+        Shard& shard = shard_for(form.key);
+        std::lock_guard lock(shard.mutex);
+        auto it = shard.index.find(form.key);
+        if (it != shard.index.end()) {
+            const Entry& entry = shard.slots[it->second];
+            shard.referenced[it->second] = 1;
+            ++shard.hits;
+            // 缓存中是代表元坐标系下的解，用逆对称变换回来
+            const Symmetry& back = symmetries()[symmetries()[form.symmetry].inverse];
+            solution.resize(entry.length);
+            for (uint8_t i = 0; i < entry.length; ++i) {
+                solution[i] = back.move_map[entry.moves[i]];
+            }
+            hit = true;
+        } else {
+            ++shard.misses;
+        }
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    lookup_ns_.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    return hit;
+}
+
+void SolutionCache::insert(const CanonicalForm& form, const std::vector<Move>& solution) {
+    if (solution.size() > MAX_SOLUTION_LENGTH) return;
+    const Symmetry& symmetry = symmetries()[form.symmetry];
+    std::array<uint8_t, MAX_SOLUTION_LENGTH> moves{};
+    for (size_t i = 0; i < solution.size(); ++i) {
+        moves[i] = static_cast<uint8_t>(symmetry.move_map[static_cast<int>(solution[i])]);
+    }
+    insert_canonical(form.key, moves.data(), static_cast<uint8_t>(solution.size()));
+}
+
+void SolutionCache::insert_canonical(const Key& key, const uint8_t* moves, uint8_t length) {
+    Shard& shard = shard_for(key);
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.index.find(key);
+    uint32_t slot;
+    if (it != shard.index.end()) {
+        slot = it->second; // 并发求解同一状态，保留后写入的解
+    } else if (shard.slots.size() < capacity_per_shard_) {
+        slot = static_cast<uint32_t>(shard.slots.size());
+        shard.slots.emplace_back();
+        shard.referenced.push_back(0);
+        shard.index.emplace(key, slot);
+    } else {
+        // CLOCK：跳过并清除访问位为1的项，淘汰第一个访问位为0的项
+        while (shard.referenced[shard.hand]) {
+            shard.referenced[shard.hand] = 0;
+            shard.hand = (shard.hand + 1) % shard.slots.size();
+        }
+        slot = static_cast<uint32_t>(shard.hand);
+        shard.hand = (shard.hand + 1) % shard.slots.size();
+        shard.index.erase(shard.slots[slot].key);
+        shard.index.emplace(key, slot);
+        ++shard.evictions;
+    }
+    Entry& entry = shard.slots[slot];
+    entry.key = key;
+    entry.length = length;
+    std::memcpy(entry.moves.data(), moves, length);
+    // 新项的访问位为0：只被访问一次的状态会先被淘汰
+    shard.referenced[slot] = 0;
+    ++shard.insertions;
+}
+
+SolutionCache::Stats SolutionCache::stats() const {
+    Stats stats;
+    stats.capacity = capacity_per_shard_ * SHARD_COUNT;
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        const Shard& shard = shards_[i];
+        std::lock_guard lock(shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.insertions += shard.insertions;
+        stats.evictions += shard.evictions;
+        stats.entries += shard.slots.size();
+        // 哈希表：桶数组 + 每个节点 (键、值、next 指针和缓存的哈希值)
+        stats.memory_bytes += shard.slots.capacity() * sizeof(Entry) + shard.referenced.capacity()
+                            + shard.index.bucket_count() * sizeof(void*)
+                            + shard.index.size() * (sizeof(Key) + sizeof(uint32_t) + 2 * sizeof(void*));
+    }
+    uint64_t lookups = lookups_.load(std::memory_order_relaxed);
+    stats.mean_lookup_ns = lookups > 0 ? static_cast<double>(lookup_ns_.load(std::memory_order_relaxed)) / lookups : 0.0;
+    return stats;
+}
+
+void SolutionCache::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot write cache snapshot " + path);
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.entry_size = sizeof(Entry);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        const Shard& shard = shards_[i];
+        std::lock_guard lock(shard.mutex);
+        out.write(reinterpret_cast<const char*>(shard.slots.data()), shard.slots.size() * sizeof(Entry));
+        header.count += shard.slots.size();
+    }
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) throw std::runtime_error("Failed to write cache snapshot " + path);
+}
+
+size_t SolutionCache::load(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open cache snapshot " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Invalid cache snapshot " + path);
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) throw std::runtime_error("Cannot map cache snapshot " + path);
+
+    const auto* header = static_cast<const SnapshotHeader*>(data);
+    bool valid = std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0
+              && header->version == SNAPSHOT_VERSION && header->entry_size == sizeof(Entry)
+              && (size - sizeof(SnapshotHeader)) % sizeof(Entry) == 0
+              && (size - sizeof(SnapshotHeader)) / sizeof(Entry) == header->count;
+    if (!valid) {
+        ::munmap(data, size);
+        throw std::runtime_error("Invalid cache snapshot " + path);
+    }
+    // 损坏或来源不明的快照：跳过长度或转动编号越界的条目 (lookup 会用转动编号直接索引映射表)
+    const auto* entries = reinterpret_cast<const Entry*>(header + 1);
+    size_t restored = 0;
+    for (uint64_t i = 0; i < header->count; ++i) {
+        const Entry& entry = entries[i];
+        if (entry.length > MAX_SOLUTION_LENGTH) continue;
+        if (std::any_of(entry.moves.begin(), entry.moves.begin() + entry.length,
+                        [](uint8_t m) { return m >= static_cast<uint8_t>(Move::COUNT); })) {
+            continue;
+        }
+        insert_canonical(entry.key, entry.moves.data(), entry.length);
+        ++restored;
+    }
+    ::munmap(data, size);
+    return restored;
+}
+
+} // namespace RubiksSolver
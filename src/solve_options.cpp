@@ -0,0 +1,171 @@
+#include "solve_options.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace RubiksSolver {
+
+namespace {
+
+// 每个字段的取值范围 (超出范围的配置没有意义，或会让搜索永远无解)
+struct LimitField {
+    int SearchLimits::* member;
+    int min, max;
+};
+
+const LimitField& limit_field(const std::string& key) {
+    static const LimitField FIELDS[] = {
+        {&SearchLimits::phase1_max_depth, 12, 20}, // 第一阶段直径为 12，更小的上限会让部分状态无解
+        {&SearchLimits::phase2_total, 10, 40},
+        {&SearchLimits::phase2_min, 1, 18},
+        {&SearchLimits::p1_probe_depth, 0, 12},
+        {&SearchLimits::p2_probe_depth, 0, 18},
+        {&SearchLimits::max_phase1_resumes, 0, 1000},
+    };
+    static_assert(std::size(FIELDS) == std::size(SearchLimits::KEYS));
+    for (size_t i = 0; i < std::size(FIELDS); ++i) {
+        if (key == SearchLimits::KEYS[i]) return FIELDS[i];
+    }
+    throw std::invalid_argument("Unknown search limit: " + key);
+}
+
+struct TunedLimits {
+    SearchLimits limits;
+    std::string source;
+};
+
+const TunedLimits& tuned_limits() {
+    static const TunedLimits tuned = [] {
+        TunedLimits result;
+        const char* env = std::getenv("RUBIKS_TUNING_FILE");
+        std::string path = env != nullptr ? env : "tuning.conf";
+        if (path.empty() || (env == nullptr && !std::ifstream(path).is_open())) {
+            return result;
+        }
+        try {
+            result.limits = SearchLimits::load(path);
+            result.source = path;
+        } catch (const std::exception& e) {
+            std::cerr << "Ignoring search tuning file: " << e.what() << std::endl;
+        }
+        return result;
+    }();
+    return tuned;
+}
+
+} // namespace
+
+void SearchLimits::set(const std::string& key, int value) {
+    const LimitField& field = limit_field(key);
+    if (value < field.min || value > field.max) {
+        throw std::invalid_argument("Search limit " + key + " out of range [" + std::to_string(field.min) + ", "
+                                    + std::to_string(field.max) + "]: " + std::to_string(value));
+    }
+    this->*field.member = value;
+}
+
+int SearchLimits::get(const std::string& key) const {
+    return this->*limit_field(key).member;
+}
+
+SearchLimits SearchLimits::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    SearchLimits limits;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        std::erase_if(line, [](char c) { return c == ' ' || c == '\t' || c == '\r'; });
+        if (line.empty()) continue;
+        size_t eq = line.find('=');
+        try {
+            if (eq == std::string::npos) {
+                throw std::invalid_argument("expected key=value");
+            }
+            size_t pos = 0;
+            std::string text = line.substr(eq + 1);
+            int value = std::stoi(text, &pos);
+            if (pos != text.size()) {
+                throw std::invalid_argument("invalid number " + text);
+            }
+            limits.set(line.substr(0, eq), value);
+        } catch (const std::exception& e) {
+            throw std::runtime_error(path + ":" + std::to_string(line_number) + ": " + e.what());
+        }
+    }
+    return limits;
+}
+
+void SearchLimits::save(const std::string& path, const std::string& comment) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+    std::stringstream lines(comment);
+    std::string line;
+    while (std::getline(lines, line)) {
+        out << "# " << line << '\n';
+    }
+    for (const char* key : KEYS) {
+        out << key << '=' << get(key) << '\n';
+    }
+}
+
+const SearchLimits& SearchLimits::tuned() {
+    return tuned_limits().limits;
+}
+
+const std::string& SearchLimits::tuned_source() {
+    return tuned_limits().source;
+}
+
+std::string SearchLimits::describe() const {
+    return "phase 1 depth " + std::to_string(phase1_max_depth)
+         + ", phase 2 budget max(" + std::to_string(phase2_min) + ", " + std::to_string(phase2_total) + " - p1)"
+         + ", endgame probe " + std::to_string(p1_probe_depth) + "/" + std::to_string(p2_probe_depth)
+         + ", resumes " + std::to_string(max_phase1_resumes);
+}
+
+SolveOptions SolveOptions::parse(const std::string& text) {
+    SolveOptions options;
+    std::stringstream stream(text);
+    std::string token;
+    while (std::getline(stream, token, ',')) {
+        if (token == "fast") {
+            options = fast();
+        } else if (token == "short") {
+            options = shortest();
+        } else if (token == "pathmax") {
+            options.parent_heuristic = true;
+        } else if (token == "clamp") {
+            options.endgame_clamp = true;
+        } else if (token == "natural") {
+            options.ordering = MoveOrdering::Natural;
+        } else if (token == "sorted") {
+            options.ordering = MoveOrdering::Heuristic;
+        } else if (token == "frontier") {
+            options.reuse_frontier = true;
+        } else if (token == "restart") {
+            options.reuse_frontier = false;
+        } else {
+            throw std::invalid_argument("Unknown search policy: " + token);
+        }
+    }
+    return options;
+}
+
+std::string SolveOptions::describe() const {
+    std::string text = parent_heuristic ? "pathmax" : "plain";
+    text += endgame_clamp ? ",clamp" : ",noclamp";
+    text += ordering == MoveOrdering::Heuristic ? ",sorted" : ",natural";
+    text += reuse_frontier ? ",frontier" : ",restart";
+    return text;
+}
+
+} // namespace RubiksSolver
@@ -0,0 +1,521 @@
+#include "solve_server.h"
+#include "bounded_queue.h"
+#include "cube.h"
+#include "json_util.h"
+#include "solver.h"
+#include <atomic>
+#include <charconv>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <semaphore>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace RubiksSolver {
+
+namespace {
+
+enum class Protocol : uint8_t { Unknown, Json, Binary };
+
+struct Job {
+    uint64_t connection = 0;
+    uint64_t request_id = 0;
+    Protocol protocol = Protocol::Json;
+    std::string input;
+    SolveOptions policy;
+    std::vector<Move> solution;
+    std::string error;
+};
+
+using JobPtr = std::unique_ptr<Job>;
+
+struct Connection {
+    int fd = -1;
+    Protocol protocol = Protocol::Unknown;
+    std::string in;
+    std::string out;
+    size_t in_flight = 0;
+    bool read_closed = false;
+    uint32_t events = EPOLLIN;  // 当前在 epoll 中注册的事件，0 表示已移出
+};
+
+// 每个连接缓冲的上限：尚未解析完的请求 (最长的二进制请求为 6 + 65535 字节) 和客户端尚未读走的回复
+// 超出时断开连接，防止只发送不换行的数据、或者从不读取回复的客户端让内存无限增长
+constexpr size_t MAX_BUFFERED_INPUT = size_t(1) << 20;
+constexpr size_t MAX_BUFFERED_OUTPUT = size_t(16) << 20;
+
+// 信号处理函数只写 eventfd 唤醒事件循环
+std::atomic<bool> g_stop{false};
+int g_wake_fd = -1;
+
+void handle_signal(int) {
+    g_stop.store(true);
+    uint64_t one = 1;
+    [[maybe_unused]] auto n = ::write(g_wake_fd, &one, sizeof(one));
+}
+
+void set_nonblocking(int fd) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+void check(int result, const char* what) {
+    if (result < 0) {
+        throw std::runtime_error(std::string(what) + ": " + std::strerror(errno));
+    }
+}
+
+int listen_unix(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    check(fd, "socket");
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        throw std::invalid_argument("Socket path too long: " + path);
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    ::unlink(path.c_str());
+    check(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), "bind");
+    check(::listen(fd, SOMAXCONN), "listen");
+    set_nonblocking(fd);
+    return fd;
+}
+
+// 只监听回环地址
+int listen_tcp(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    check(fd, "socket");
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    check(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), "bind");
+    check(::listen(fd, SOMAXCONN), "listen");
+    set_nonblocking(fd);
+    return fd;
+}
+
+// 请求编号按原文解析为整数 (经过 double 时大于 2^53 的编号会失真)，负数、小数和超出 uint64_t 的编号无效
+bool parse_request_id(const Json::FlatValue& value, uint64_t& id) {
+    if (value.type != Json::FlatValue::Type::Number) return false;
+    const char* end = value.text.data() + value.text.size();
+    auto [ptr, ec] = std::from_chars(value.text.data(), end, id);
+    return ec == std::errc() && ptr == end;
+}
+
+void append_u32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+void append_response(std::string& out, const Job& job) {
+    if (job.protocol == Protocol::Binary) {
+        append_u32(out, static_cast<uint32_t>(job.request_id));
+        if (job.error.empty()) {
+            out += static_cast<char>(0);
+            out += static_cast<char>(job.solution.size());
+            for (Move m : job.solution) out += static_cast<char>(m);
+        } else {
+            std::string_view message = std::string_view(job.error).substr(0, 255);
+            out += static_cast<char>(1);
+            out += static_cast<char>(message.size());
+            out += message;
+        }
+        return;
+    }
+    out += "{\"id\":";
+    out += std::to_string(job.request_id);
+    if (job.error.empty()) {
+        out += ",\"solution\":\"";
+        for (size_t i = 0; i < job.solution.size(); ++i) {
+            if (i > 0) out += ' ';
+            out += MOVE_STRINGS[static_cast<int>(job.solution[i])];
+        }
+        out += "\",\"length\":";
+        out += std::to_string(job.solution.size());
+    } else {
+        out += ",\"error\":\"";
+        out += Json::escape(job.error);
+        out += '"';
+    }
+    out += "}\n";
+}
+
+class Server {
+public:
+    Server(const TableManager& tables, const ServerOptions& options)
+        : tables_(tables),
+          options_(options),
+          threads_(options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency())),
+          jobs_(options.max_in_flight),
+          // 请求总数受 max_in_flight 限制，完成队列不会被填满
+          completions_(options.max_in_flight + threads_ * options.max_batch) {}
+
+    void run() {
+        epoll_fd_ = ::epoll_create1(0);
+        check(epoll_fd_, "epoll_create1");
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK);
+        check(wake_fd_, "eventfd");
+        add_fd(wake_fd_, EPOLLIN);
+        if (!options_.socket_path.empty()) {
+            listeners_.push_back(listen_unix(options_.socket_path));
+            std::cout << "Listening on unix:" << options_.socket_path << std::endl;
+        }
+        if (options_.tcp_port > 0) {
+            listeners_.push_back(listen_tcp(options_.tcp_port));
+            std::cout << "Listening on tcp:127.0.0.1:" << options_.tcp_port << std::endl;
+        }
+        if (listeners_.empty()) {
+            throw std::invalid_argument("No socket path or TCP port given");
+        }
+        for (int fd : listeners_) add_fd(fd, EPOLLIN);
+
+        g_wake_fd = wake_fd_;
+        std::signal(SIGINT, handle_signal);
+        std::signal(SIGTERM, handle_signal);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        for (unsigned t = 0; t < threads_; ++t) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+        std::cout << "Serving with " << threads_ << " solver threads" << std::endl;
+
+        event_loop();
+
+        // 停止工作线程：先取消正在进行的求解并让工作线程丢弃队列中剩余的请求 (回复已无法发出)，
+        // 再给每个线程一个空任务
+        cancel_.store(true);
+        for (unsigned t = 0; t < threads_; ++t) {
+            jobs_.push(nullptr);
+            pending_jobs_.release();
+        }
+        for (auto& worker : workers_) worker.join();
+        for (auto& [id, conn] : connections_) ::close(conn.fd);
+        for (int fd : listeners_) ::close(fd);
+        if (!options_.socket_path.empty()) ::unlink(options_.socket_path.c_str());
+        ::close(wake_fd_);
+        ::close(epoll_fd_);
+        std::cout << "Server stopped after " << served_ << " requests" << std::endl;
+    }
+
+private:
+    // 一次取出最多 max_batch 个请求求解，求解完成后统一唤醒事件循环
+    void worker_loop() {
+        Solver solver(tables_, false);
+        solver.set_cache(options_.cache);
+        solver.set_cancel_flag(&cancel_);
+        std::vector<JobPtr> batch;
+        for (;;) {
+            pending_jobs_.acquire();
+            batch.push_back(jobs_.pop());
+            // 取到停止标记后不再多取，保证每个线程恰好收到一个
+            while (batch.back() && batch.size() < options_.max_batch && pending_jobs_.try_acquire()) {
+                batch.push_back(jobs_.pop());
+            }
+            bool stop = false;
+            for (auto& job : batch) {
+                if (!job) {
+                    stop = true;
+                    continue;
+                }
+                if (cancel_.load(std::memory_order_relaxed)) continue;
+                try {
+                    job->solution = solver.solve(Cube::parse(job->input), job->policy);
+                } catch (const SolveCancelled&) {
+                    continue;
+                } catch (const std::exception& e) {
+                    job->error = e.what();
+                }
+                completions_.push(std::move(job));
+            }
+            batch.clear();
+            uint64_t one = 1;
+            [[maybe_unused]] auto n = ::write(wake_fd_, &one, sizeof(one));
+            if (stop) return;
+        }
+    }
+
+    void event_loop() {
+        std::vector<epoll_event> events(256);
+        while (!g_stop.load()) {
+            int n = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                check(n, "epoll_wait");
+            }
+            for (int i = 0; i < n; ++i) {
+                uint64_t key = events[i].data.u64;
+                if (key == static_cast<uint64_t>(wake_fd_)) {
+                    uint64_t value;
+                    [[maybe_unused]] auto r = ::read(wake_fd_, &value, sizeof(value));
+                    drain_completions();
+                } else if (key < CONNECTION_BASE) {
+                    accept_all(static_cast<int>(key));
+                } else {
+                    handle_connection(key, events[i].events);
+                }
+            }
+        }
+    }
+
+    void add_fd(int fd, uint32_t events, uint64_t key = 0) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u64 = key == 0 ? static_cast<uint64_t>(fd) : key;
+        check(::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev), "epoll_ctl");
+    }
+
+    void accept_all(int listener) {
+        for (;;) {
+            int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) return;
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            uint64_t id = next_connection_++;
+            connections_[id].fd = fd;
+            add_fd(fd, EPOLLIN, id);
+        }
+    }
+
+    void handle_connection(uint64_t id, uint32_t events) {
+        auto it = connections_.find(id);
+        if (it == connections_.end()) return;
+        Connection& conn = it->second;
+        if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            char buffer[65536];
+            for (;;) {
+                ssize_t n = ::read(conn.fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    conn.in.append(buffer, n);
+                    // 先解析已读到的请求，剩余的数据由水平触发的 EPOLLIN 再次报告
+                    if (conn.in.size() > MAX_BUFFERED_INPUT) break;
+                    continue;
+                }
+                if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    conn.read_closed = true;
+                }
+                if (n == 0 || errno != EINTR) break;
+            }
+            parse_requests(id, conn);
+        }
+        flush(id, conn);
+    }
+
+    // 解析缓冲区中所有完整的请求；不完整的部分留到下次读取
+    void parse_requests(uint64_t id, Connection& conn) {
+        size_t pos = 0;
+        if (conn.protocol == Protocol::Unknown && !conn.in.empty()) {
+            if (static_cast<uint8_t>(conn.in[0]) == BINARY_MAGIC) {
+                conn.protocol = Protocol::Binary;
+                pos = 1;
+            } else {
+                conn.protocol = Protocol::Json;
+            }
+        }
+        if (conn.protocol == Protocol::Binary) {
+            while (conn.in.size() - pos >= 6) {
+                const auto* p = reinterpret_cast<const uint8_t*>(conn.in.data() + pos);
+                uint32_t request_id = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+                size_t length = p[4] | (p[5] << 8);
+                if (conn.in.size() - pos - 6 < length) break;
+                submit(id, conn, request_id, conn.in.substr(pos + 6, length), options_.policy);
+                pos += 6 + length;
+            }
+        } else if (conn.protocol == Protocol::Json) {
+            auto reject = [&](uint64_t request_id, std::string error) {
+                Job job;
+                job.request_id = request_id;
+                job.error = std::move(error);
+                append_response(conn.out, job);
+            };
+            for (size_t end = conn.in.find('\n', pos); end != std::string::npos; end = conn.in.find('\n', pos)) {
+                std::string_view line(conn.in.data() + pos, end - pos);
+                pos = end + 1;
+                if (line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+                auto request = Json::parse_flat_object(line);
+                if (!request) {
+                    reject(0, "Malformed JSON request");
+                    continue;
+                }
+                uint64_t request_id = 0;
+                if (auto it = request->find("id"); it != request->end() && !parse_request_id(it->second, request_id)) {
+                    reject(0, "Request id must be a non-negative integer");
+                    continue;
+                }
+                if (auto it = request->find("stats"); it != request->end() && it->second.is_true()) {
+                    append_stats(conn.out, request_id);
+                    continue;
+                }
+                auto cube = request->find("cube");
+                if (cube == request->end() || cube->second.type != Json::FlatValue::Type::String) {
+                    reject(request_id, "Request must contain \"cube\"");
+                    continue;
+                }
+                SolveOptions policy = options_.policy;
+                if (auto name = request->find("policy"); name != request->end()) {
+                    try {
+                        if (name->second.type != Json::FlatValue::Type::String) {
+                            throw std::invalid_argument("Request policy must be a string");
+                        }
+                        policy = SolveOptions::parse(name->second.text);
+                    } catch (const std::exception& e) {
+                        reject(request_id, e.what());
+                        continue;
+                    }
+                }
+                submit(id, conn, request_id, std::move(cube->second.text), policy);
+            }
+        }
+        conn.in.erase(0, pos);
+    }
+
+    void append_stats(std::string& out, uint64_t request_id) {
+        std::ostringstream os;
+        Json::Writer w(os);
+        w.begin_object();
+        w.field("id", request_id);
+        w.key("cache");
+        if (options_.cache) {
+            auto stats = options_.cache->stats();
+            w.begin_object();
+            w.field("hits", stats.hits);
+            w.field("misses", stats.misses);
+            w.field("hit_rate", stats.hit_rate());
+            w.field("insertions", stats.insertions);
+            w.field("evictions", stats.evictions);
+            w.field("entries", static_cast<uint64_t>(stats.entries));
+            w.field("capacity", static_cast<uint64_t>(stats.capacity));
+            w.field("memory_bytes", static_cast<uint64_t>(stats.memory_bytes));
+            w.field("mean_lookup_ns", stats.mean_lookup_ns);
+            w.end_object();
+        } else {
+            w.null();
+        }
+        w.end_object();
+        out += os.str();
+        out += '\n';
+    }
+
+    void submit(uint64_t id, Connection& conn, uint64_t request_id, std::string input, const SolveOptions& policy) {
+        auto job = std::make_unique<Job>();
+        job->connection = id;
+        job->request_id = request_id;
+        job->protocol = conn.protocol;
+        job->input = std::move(input);
+        job->policy = policy;
+        if (in_flight_ >= options_.max_in_flight) {
+            job->error = "Server busy";
+            append_response(conn.out, *job);
+            return;
+        }
+        ++in_flight_;
+        ++conn.in_flight;
+        jobs_.push(std::move(job));
+        pending_jobs_.release();
+    }
+
+    void drain_completions() {
+        JobPtr job;
+        while (completions_.try_pop(job)) {
+            --in_flight_;
+            ++served_;
+            auto it = connections_.find(job->connection);
+            if (it == connections_.end()) continue; // 连接已关闭
+            --it->second.in_flight;
+            append_response(it->second.out, *job);
+            touched_.push_back(job->connection);
+        }
+        for (uint64_t id : touched_) {
+            auto it = connections_.find(id);
+            if (it != connections_.end()) flush(id, it->second);
+        }
+        touched_.clear();
+    }
+
+    // 写出尚未发送的回复；写不完时等待 EPOLLOUT。读端关闭且没有待处理请求时关闭连接
+    void flush(uint64_t id, Connection& conn) {
+        while (!conn.out.empty()) {
+            ssize_t n = ::write(conn.fd, conn.out.data(), conn.out.size());
+            if (n > 0) {
+                conn.out.erase(0, n);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && errno == EAGAIN) {
+                break;
+            } else {
+                conn.read_closed = true;
+                conn.out.clear();
+                conn.in_flight = 0;
+            }
+        }
+        const bool overflow = conn.in.size() > MAX_BUFFERED_INPUT || conn.out.size() > MAX_BUFFERED_OUTPUT;
+        if (overflow || (conn.read_closed && conn.out.empty() && conn.in_flight == 0)) {
+            // 关闭后仍在求解的请求在 drain_completions 中被丢弃
+            ::close(conn.fd);
+            connections_.erase(id);
+            return;
+        }
+        // 读端关闭后不再关注 EPOLLIN (否则水平触发会一直报告)；没有任何事件时从 epoll 移出，
+        // 剩余的回复由 drain_completions 写出
+        uint32_t events = (conn.read_closed ? 0 : static_cast<uint32_t>(EPOLLIN))
+                        | (conn.out.empty() ? 0 : static_cast<uint32_t>(EPOLLOUT));
+        if (events != conn.events) {
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.u64 = id;
+            int op = events == 0 ? EPOLL_CTL_DEL : (conn.events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+            ::epoll_ctl(epoll_fd_, op, conn.fd, &ev);
+            conn.events = events;
+        }
+    }
+
+    // 连接的事件键从这里开始，小于它的键是监听套接字和 eventfd 的文件描述符
+    static constexpr uint64_t CONNECTION_BASE = uint64_t(1) << 32;
+
+    const TableManager& tables_;
+    const ServerOptions options_;
+    const unsigned threads_;
+    BoundedQueue<JobPtr> jobs_;
+    BoundedQueue<JobPtr> completions_;
+    std::counting_semaphore<> pending_jobs_{0};
+    std::vector<std::thread> workers_;
+    std::atomic<bool> cancel_{false}; // 服务器停止时置位
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::vector<int> listeners_;
+    std::unordered_map<uint64_t, Connection> connections_;
+    std::vector<uint64_t> touched_;
+    uint64_t next_connection_ = CONNECTION_BASE;
+    size_t in_flight_ = 0;
+    uint64_t served_ = 0;
+};
+
+} // namespace
+
+void run_server(const TableManager& tables, const ServerOptions& options) {
+    // Solver 只在默认策略下读写缓存；请求中指定的其他策略照常绕过缓存
+    if (options.cache != nullptr && !(options.policy == SolveOptions{})) {
+        throw std::invalid_argument("The solution cache works only with the default search policy");
+    }
+    Server server(tables, options);
+    server.run();
+}
+
+} // namespace RubiksSolver
@@ -7,42 +7,129 @@
 
 namespace RubiksSolver {
 
-Solver::Solver(const TableManager& tables) : tables_(tables) {
+Solver::Solver(const TableManager& tables, bool verbose) : tables_(tables), verbose_(verbose) {
+    // 不经过 solve() 直接调用搜索内核时 (微基准测试) 使用默认上限
+    probe_depth_[0] = std::min(options_.limits.p1_probe_depth, tables_.endgame_db_depth<1>());
+    probe_depth_[1] = std::min(options_.limits.p2_probe_depth, tables_.endgame_db_depth<2>());
 }
 
 std::vector<Move> Solver::solve(const Cube& scrambled_cube) {
+    return solve(scrambled_cube, options_);
+}
+
+std::vector<Move> Solver::solve(const Cube& scrambled_cube, const SolveOptions& options) {
+    using namespace SearchPolicy;
+    // 缓存中的解与策略有关，只有默认策略的求解读写缓存
+    const bool use_cache = cache_ != nullptr && options == SolveOptions{};
+    auto with_frontier = [&]<typename H, typename E, typename O>() {
+        if (options.reuse_frontier) {
+            return solve_with<SearchPolicies<H, E, O, ReuseFrontier>>(scrambled_cube, options.limits, use_cache);
+        }
+        return solve_with<SearchPolicies<H, E, O, RestartFromRoot>>(scrambled_cube, options.limits, use_cache);
+    };
+    auto with_ordering = [&]<typename H, typename E>() {
+        if (options.ordering == MoveOrdering::Heuristic) {
+            return with_frontier.template operator()<H, E, SortByHeuristic>();
+        }
+        return with_frontier.template operator()<H, E, NaturalOrder>();
+    };
+    auto with_endgame = [&]<typename H>() {
+        if (options.endgame_clamp) {
+            return with_ordering.template operator()<H, EndgameClamp>();
+        }
+        return with_ordering.template operator()<H, NoEndgameClamp>();
+    };
+    if (options.parent_heuristic) {
+        return with_endgame.template operator()<ParentHeuristic>();
+    }
+    return with_endgame.template operator()<PlainHeuristic>();
+}
+
+template<typename P>
+std::vector<Move> Solver::solve_with(const Cube& scrambled_cube, const SearchLimits& limits, bool use_cache) {
     auto start = std::chrono::high_resolution_clock::now();
     std::vector<Move> phase1_solution;
     std::vector<Move> phase2_solution;
+    stats_ = SearchStats{};
+
+    SolutionCache::CanonicalForm canonical;
+    if (use_cache) {
+        std::vector<Move> cached;
+        if (cache_->lookup(scrambled_cube, cached, canonical)) {
+            if (verbose_) {
+                std::cout << "Solution found in cache (" << cached.size() << " moves)" << std::endl;
+            }
+            return cached;
+        }
+    }
     
+    ++fallbacks_.solves;
+
     // 第一阶段：使用IDA*搜索到达G1子群
+    tables_.wait_until_ready(TableGroup::Phase1);
+    combined_phase1_ = tables_.has_combined_pruning<1>();
+    combined_phase2_ = tables_.has_combined_pruning<2>();
+    probe_depth_[0] = std::min(limits.p1_probe_depth, tables_.endgame_db_depth<1>());
+    probe_depth_[1] = std::min(limits.p2_probe_depth, tables_.endgame_db_depth<2>());
     Phase1Coord p1_coord(scrambled_cube);
-    if (!ida_star<1>(p1_coord, phase1_solution, 12)) {
+    // 第二阶段的起始坐标沿第一阶段的解查表追踪得到
+    const Phase2Tracking tracking(scrambled_cube);
+    IdaSearch phase1 = start_ida<1>(p1_coord, limits.phase1_max_depth);
+    if (!ida_next<1, P, Phase1Coord>(phase1, phase1_solution)) {
         throw std::runtime_error("Phase 1 solution not found within depth limit");
     }
     auto end1 = std::chrono::high_resolution_clock::now();
-    auto duration1 = std::chrono::duration_cast<std::chrono::milliseconds>(end1 - start);
-    // 打印第一阶段的解
-    std::erase_if(phase1_solution,
-                  [this](Move m) { return m == Move::COUNT; });
-    std::cout << "Phase 1 completed with " << phase1_solution.size() << " moves in " << duration1.count() << " ms" << std::endl;
-    std::cout << "Phase 1 Solution: ";
-    for (const auto& move : phase1_solution) {
-        std::cout << move << " ";
-    }
-    std::cout << std::endl;
 
-    // 应用第一阶段的解，得到G1状态的魔方
-    Cube intermediate_cube = scrambled_cube;
-    intermediate_cube.apply_sequence(phase1_solution);
-    
-    
-    // 第二阶段：在G1子群内搜索到复原状态
-    Phase2Coord p2_coord(intermediate_cube);
-    int max_phase2_moves = std::max(8, 25 - static_cast<int>(phase1_solution.size()));
+    for (;;) {
+        auto duration1 = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+        // 打印第一阶段的解
+        std::erase_if(phase1_solution,
+                      [this](Move m) { return m == Move::COUNT; });
+        stats_.phases[0].solution_length = static_cast<int>(phase1_solution.size());
+        if (verbose_) {
+            std::cout << "Phase 1 completed with " << phase1_solution.size() << " moves in " << duration1.count() << " ms" << std::endl;
+            std::cout << "Phase 1 Solution: ";
+            for (const auto& move : phase1_solution) {
+                std::cout << move << " ";
+            }
+            std::cout << std::endl;
+        }
+
+        // 第二阶段：在G1子群内搜索到复原状态
+        tables_.wait_until_ready(TableGroup::Phase2);
+        end1 = std::chrono::high_resolution_clock::now();
+        Phase2Coord p2_coord = tables_.track_phase2(tracking, phase1_solution.data(), phase1_solution.size());
+        int max_phase2_moves = std::max(limits.phase2_min, limits.phase2_total - static_cast<int>(phase1_solution.size()));
 
-    if (!ida_star<2>(p2_coord, phase2_solution, max_phase2_moves)) {
-        throw std::runtime_error("Phase 2 solution not found");
+        if (ida_star<2, P>(p2_coord, phase2_solution, max_phase2_moves)) {
+            break;
+        }
+
+        // 第二阶段在预算内无解：先从中断处继续第一阶段搜索，换一个第一阶段的解 (通常很快就能找到)
+        std::vector<Move> next_phase1;
+        if (stats_.phase1_resumes < limits.max_phase1_resumes && ida_next<1, P, Phase1Coord>(phase1, next_phase1)) {
+            ++stats_.phase1_resumes;
+            ++fallbacks_.phase1_resumes;
+            if (verbose_) {
+                std::cout << "Phase 2 found no solution within " << max_phase2_moves << " moves, resuming phase 1" << std::endl;
+            }
+            phase1_solution = std::move(next_phase1);
+            continue;
+        }
+
+        // 最后放宽当前第一阶段解的第二阶段预算，从已搜索过的深度之后继续迭代；G1 的直径保证一定有解
+        stats_.phase2_widened = true;
+        ++fallbacks_.phase2_widenings;
+        if (verbose_) {
+            std::cout << "Widening phase 2 depth budget to " << PHASE2_MAX_DEPTH << " moves" << std::endl;
+        }
+        if (!ida_star<2, P>(p2_coord, phase2_solution, PHASE2_MAX_DEPTH, max_phase2_moves + 1)) {
+            throw std::runtime_error("Phase 2 solution not found");
+        }
+        break;
+    }
+    if (stats_.phase1_resumes > 0) {
+        ++fallbacks_.resumed_solves;
     }
 
     auto end2 = std::chrono::high_resolution_clock::now();
@@ -50,58 +137,28 @@ std::vector<Move> Solver::solve(const Cube& scrambled_cube) {
     // 打印第二阶段的解
     std::erase_if(phase2_solution,
                   [this](Move m) { return m == Move::COUNT; });
-    std::cout << "Phase 2 completed with " << phase2_solution.size() << " moves in " << duration2.count() << " ms" << std::endl;
-    std::cout << "Phase 2 Solution: ";
-    for (const auto& move : phase2_solution) {
-        std::cout << move << " ";
+    stats_.phases[1].solution_length = static_cast<int>(phase2_solution.size());
+    if (verbose_) {
+        std::cout << "Phase 2 completed with " << phase2_solution.size() << " moves in " << duration2.count() << " ms" << std::endl;
+        std::cout << "Phase 2 Solution: ";
+        for (const auto& move : phase2_solution) {
+            std::cout << move << " ";
+        }
+        std::cout << std::endl;
     }
-    std::cout << std::endl;
     
     // 合并两个阶段的解
     phase1_solution.insert(phase1_solution.end(), 
                           phase2_solution.begin(), phase2_solution.end());
+    if (use_cache) {
+        cache_->insert(canonical, phase1_solution);
+    }
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end2 - start);
-    std::cout << "Total solving time: " << duration.count() << " ms" << std::endl;
-
-    return phase1_solution;
-}
-
-inline uint8_t Solver::heuristic_phase1(const Phase1Coord& coord) const {
-    return tables_.get_phase1_pruning(coord);
-}
-
-inline uint8_t Solver::heuristic_phase2(const Phase2Coord& coord) const {
-    return tables_.get_phase2_pruning(coord);
-}
-
-inline uint8_t Solver::heuristic_phase1(uint16_t x1, uint16_t x2, uint16_t x3) const {
-    uint8_t h1 = tables_.get_co_pruning(x1);
-    uint8_t h2 = tables_.get_eo_pruning(x2);
-    uint8_t h3 = tables_.get_uds_pruning(x3);
-    
-    return std::max({h1, h2, h3});
-}
-
-inline uint8_t Solver::heuristic_phase2(uint16_t x1, uint16_t x2, uint16_t x3) const {
-    uint8_t h1 = tables_.get_cp_pruning(x1);
-    uint8_t h2 = tables_.get_udep_pruning(x2);
-    uint8_t h3 = tables_.get_sep_pruning(x3);
-    
-    return std::max({h1, h2, h3});
-}
-
-inline bool Solver::is_valid_move(Move current, Move last) const {
-    if (last == Move::COUNT) return true; // 第一步
-    
-    uint8_t current_face = static_cast<uint8_t>(get_face(current));
-    uint8_t last_face = static_cast<uint8_t>(get_face(last));
-    
-    // 同一面的连续转动可以合并为一次转动
-    if (current_face == last_face) {
-        return false;
+    if (verbose_) {
+        std::cout << "Total solving time: " << duration.count() << " ms" << std::endl;
     }
 
-    return true;
+    return phase1_solution;
 }
 
 } // namespace RubiksSolver
@@ -0,0 +1,77 @@
+#include "static_tables.h"
+
+namespace RubiksSolver::StaticTables {
+
+// 只在这个翻译单元中进行编译期计算，其他翻译单元通过 extern 声明访问
+
+constexpr MoveTable<2187> CO_MOVE_TABLE = make_move_table<Phase1Coord, 2187>(corner_orientation_move);
+constexpr MoveTable<2048> EO_MOVE_TABLE = make_move_table<Phase1Coord, 2048>(edge_orientation_move);
+constexpr MoveTable<495> UDS_MOVE_TABLE = make_move_table<Phase1Coord, 495>(ud_slice_position_move);
+constexpr MoveTable<24> SEP_MOVE_TABLE = make_move_table<Phase2Coord, 24>(slice_edge_permutation_move);
+constexpr MoveTable<Phase2Tracking::CORNER_POSITIONS> CORNER_POSITIONS_MOVE_TABLE =
+    make_move_table<Phase1Coord, Phase2Tracking::CORNER_POSITIONS>(corner_positions_move);
+constexpr MoveTable<Phase2Tracking::EDGE_POSITIONS> EDGE_POSITIONS_MOVE_TABLE =
+    make_move_table<Phase1Coord, Phase2Tracking::EDGE_POSITIONS>(edge_positions_move);
+
+constexpr PruningTable<2187> CO_PRUNING_TABLE = make_pruning_table<Phase1Coord>(CO_MOVE_TABLE);
+constexpr PruningTable<2048> EO_PRUNING_TABLE = make_pruning_table<Phase1Coord>(EO_MOVE_TABLE);
+constexpr PruningTable<495> UDS_PRUNING_TABLE = make_pruning_table<Phase1Coord>(UDS_MOVE_TABLE);
+constexpr PruningTable<24> SEP_PRUNING_TABLE = make_pruning_table<Phase2Coord>(SEP_MOVE_TABLE);
+
+// 已知的剪枝表深度：角块朝向最多6步，棱块朝向最多7步，UDSlice位置最多5步
+static_assert(std::ranges::max(CO_PRUNING_TABLE) == 6);
+static_assert(std::ranges::max(EO_PRUNING_TABLE) == 7);
+static_assert(std::ranges::max(UDS_PRUNING_TABLE) == 5);
+static_assert(std::ranges::max(SEP_PRUNING_TABLE) < 0xFF);
+
+// 与完整的魔方编码路径交叉校验：对打乱后的魔方逐步应用转动，坐标必须与查表结果一致
+constexpr bool verify_against_cube() {
+    constexpr std::array<Move, 8> scramble = {
+        Move::R1, Move::U2, Move::F1, Move::L3, Move::D2, Move::B1, Move::R3, Move::F2
+    };
+    Cube cube;
+    for (auto m : scramble) {
+        Phase1Coord before(cube);
+        cube.apply_move(m);
+        Phase1Coord after(cube);
+        if (CO_MOVE_TABLE[before.get_corner_orientation()][static_cast<int>(m)] != after.get_corner_orientation() ||
+            EO_MOVE_TABLE[before.get_edge_orientation()][static_cast<int>(m)] != after.get_edge_orientation() ||
+            UDS_MOVE_TABLE[before.get_ud_slice_position()][static_cast<int>(m)] != after.get_ud_slice_position()) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(verify_against_cube());
+
+// 第二阶段坐标追踪：路径先离开G1再回到G1，查表追踪的结果必须与魔方编码一致，回到G1后与 Phase2Coord 一致
+constexpr bool verify_tracking() {
+    constexpr std::array<Move, 10> path = {
+        Move::R3, Move::U1, Move::D2, Move::F3, Move::R1, Move::F1, Move::L1, Move::L2, Move::F2, Move::R2
+    };
+    auto corner_next = [](Coord c, Move m) { return CORNER_POSITIONS_MOVE_TABLE[c][static_cast<int>(m)]; };
+    auto edge_next = [](Coord c, Move m) { return EDGE_POSITIONS_MOVE_TABLE[c][static_cast<int>(m)]; };
+    Cube cube;
+    Phase2Tracking tracking;
+    for (size_t i = 0; i < path.size(); ++i) {
+        cube.apply_move(path[i]);
+        tracking = tracking.after(path[i], corner_next, edge_next);
+        if (!(tracking == Phase2Tracking(cube))) {
+            return false;
+        }
+        const bool in_g1 = i < 4 || i == path.size() - 1;
+        if (in_g1) {
+            Phase2Coord expected(cube);
+            Phase2Coord tracked = tracking.to_phase2();
+            if (tracked.get_corner_permutation() != expected.get_corner_permutation() ||
+                tracked.get_ud_edge_permutation() != expected.get_ud_edge_permutation() ||
+                tracked.get_slice_edge_permutation() != expected.get_slice_edge_permutation()) {
+                return false;
+            }
+        }
+    }
+    return Phase2Tracking().to_phase2().is_solved();
+}
+static_assert(verify_tracking());
+
+} // namespace RubiksSolver::StaticTables
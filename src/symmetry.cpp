@@ -0,0 +1,155 @@
+#include "symmetry.h"
+#include <stdexcept>
+#include <string>
+
+namespace RubiksSolver {
+
+namespace {
+
+using Vec3 = std::array<int, 3>;
+
+// 各面的法向量，顺序为 U R F D L B
+constexpr std::array<Vec3, 6> FACE_NORMALS = {{
+    {0, 1, 0}, {1, 0, 0}, {0, 0, 1}, {0, -1, 0}, {-1, 0, 0}, {0, 0, -1}
+}};
+
+constexpr char FACE_CHARS[6] = {'U', 'R', 'F', 'D', 'L', 'B'};
+
+// 色块 (面, 行, 列) 所在块的空间位置，与 Cube::to_facelets 的布局一致：
+// U 面第0行靠 B，D 面第0行靠 F，侧面第0行靠 U；R 面第0列靠 F，L 面第0列靠 B，B 面第0列靠 R
+Vec3 facelet_position(int face, int row, int col) {
+    int a = col - 1, b = 1 - row;
+    switch (face) {
+        case 0: return {a, 1, row - 1};   // U
+        case 1: return {1, b, 1 - col};   // R
+        case 2: return {a, b, 1};         // F
+        case 3: return {a, -1, 1 - row};  // D
+        case 4: return {-1, b, col - 1};  // L
+        default: return {1 - col, b, -1}; // B
+    }
+}
+
+Vec3 multiply(const std::array<std::array<int8_t, 3>, 3>& m, const Vec3& v) {
+    Vec3 result{};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) result[i] += m[i][j] * v[j];
+    }
+    return result;
+}
+
+int face_of_normal(const Vec3& normal) {
+    for (int f = 0; f < 6; ++f) {
+        if (FACE_NORMALS[f] == normal) return f;
+    }
+    throw std::logic_error("Invalid face normal");
+}
+
+int facelet_index(int face, const Vec3& position) {
+    for (int i = 0; i < 9; ++i) {
+        if (facelet_position(face, i / 3, i % 3) == position) return face * 9 + i;
+    }
+    throw std::logic_error("Invalid facelet position");
+}
+
+std::array<Symmetry, SYMMETRY_COUNT> build_symmetries() {
+    std::array<Symmetry, SYMMETRY_COUNT> result{};
+    // 坐标轴的6种排列 × 8种符号，第一个是恒等矩阵
+    constexpr int PERMUTATIONS[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+    int index = 0;
+    for (const auto& perm : PERMUTATIONS) {
+        for (int signs = 0; signs < 8; ++signs) {
+            Symmetry& s = result[index++];
+            for (int i = 0; i < 3; ++i) {
+                s.matrix[i] = {0, 0, 0};
+                s.matrix[i][perm[i]] = static_cast<int8_t>((signs >> i) & 1 ? -1 : 1);
+            }
+            const auto& m = s.matrix;
+            int det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                    - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                    + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+            s.reflection = det < 0;
+
+            for (int f = 0; f < 6; ++f) {
+                s.face_map[f] = static_cast<uint8_t>(face_of_normal(multiply(m, FACE_NORMALS[f])));
+            }
+            for (int i = 0; i < 54; ++i) {
+                int face = i / 9;
+                Vec3 position = multiply(m, facelet_position(face, (i % 9) / 3, i % 3));
+                s.facelet_target[i] = static_cast<uint8_t>(facelet_index(s.face_map[face], position));
+            }
+        }
+    }
+
+    // 逆对称：矩阵互为转置
+    for (auto& s : result) {
+        for (int j = 0; j < SYMMETRY_COUNT; ++j) {
+            bool transposed = true;
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 3; ++c) transposed &= result[j].matrix[c][r] == s.matrix[r][c];
+            }
+            if (transposed) s.inverse = static_cast<uint8_t>(j);
+        }
+    }
+
+    // 转动的映射：变换单步转动后的状态，找到与之相同的单步转动 (镜像会改变转动方向)
+    std::array<FaceletFaces, 18> move_states;
+    for (int m = 0; m < 18; ++m) {
+        Cube cube;
+        cube.apply_move(static_cast<Move>(m));
+        move_states[m] = facelet_faces(cube);
+    }
+    for (auto& s : result) {
+        for (int m = 0; m < 18; ++m) {
+            FaceletFaces mapped = apply_symmetry(s, move_states[m]);
+            int target = 0;
+            while (target < 18 && move_states[target] != mapped) ++target;
+            if (target == 18) throw std::logic_error("Symmetry does not map a move to a move");
+            s.move_map[m] = static_cast<Move>(target);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+const std::array<Symmetry, SYMMETRY_COUNT>& symmetries() {
+    static const std::array<Symmetry, SYMMETRY_COUNT> table = build_symmetries();
+    return table;
+}
+
+FaceletFaces facelet_faces(const Cube& cube) {
+    std::string facelets = cube.to_facelets();
+    FaceletFaces faces;
+    for (int i = 0; i < 54; ++i) {
+        int f = 0;
+        while (FACE_CHARS[f] != facelets[i]) ++f;
+        faces[i] = static_cast<uint8_t>(f);
+    }
+    return faces;
+}
+
+FaceletFaces apply_symmetry(const Symmetry& symmetry, const FaceletFaces& faces) {
+    FaceletFaces result;
+    for (int i = 0; i < 54; ++i) {
+        result[symmetry.facelet_target[i]] = symmetry.face_map[faces[i]];
+    }
+    return result;
+}
+
+Cube conjugate(const Cube& cube, const Symmetry& symmetry) {
+    FaceletFaces faces = apply_symmetry(symmetry, facelet_faces(cube));
+    std::string facelets(54, ' ');
+    for (int i = 0; i < 54; ++i) facelets[i] = FACE_CHARS[faces[i]];
+    return Cube::from_facelets(facelets);
+}
+
+std::vector<Move> map_moves(const Symmetry& symmetry, const std::vector<Move>& moves) {
+    std::vector<Move> result;
+    result.reserve(moves.size());
+    for (Move m : moves) {
+        result.push_back(symmetry.move_map[static_cast<int>(m)]);
+    }
+    return result;
+}
+
+} // namespace RubiksSolver
@@ -1,139 +1,423 @@
 #include "table_manager.h"
+#include "embedded_tables.h"
+#include "solve_options.h"
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
 
 namespace RubiksSolver {
 
+namespace {
+
+// configure() 指定的档位；单例创建后不能再修改
+std::optional<TableTiers> configured_tiers;
+std::atomic<bool> instance_created{false};
+
+} // namespace
+
 const TableManager& TableManager::get_instance() {
-    static TableManager instance;
+    static TableManager instance([] {
+        instance_created = true;
+        return configured_tiers ? *configured_tiers : TableTiers::from_environment();
+    }());
     return instance;
 }
 
+void TableManager::configure(const TableTiers& tiers) {
+    if (instance_created) {
+        throw std::logic_error("TableManager::configure must be called before get_instance()");
+    }
+    configured_tiers = tiers;
+}
+
 // 构造函数，初始化所有表格
-TableManager::TableManager() {
+TableManager::TableManager(const TableTiers& tiers) : TableManager(Deferred{}) {
+    tiers_ = tiers;
     initialize();
 }
 
+TableManager::TableManager(Deferred) {
+    for (size_t i = 0; i < TABLE_GROUP_COUNT; ++i) {
+        ready_futures_[i] = ready_promises_[i].get_future().share();
+    }
+}
+
+TableManager::~TableManager() {
+    if (loader_.joinable()) {
+        loader_.join();
+    }
+}
+
+namespace {
+
+// 运行时开关：设置 RUBIKS_EXTERNAL_TABLES=1 时忽略内嵌表，从 data/ 目录加载或生成
+bool external_tables_requested() {
+    const char* env = std::getenv("RUBIKS_EXTERNAL_TABLES");
+    return env != nullptr && std::string_view(env) != "0";
+}
+
+#ifdef RUBIKS_EMBEDDED_TABLES
+template<typename T>
+bool bind_embedded(TableStorage<T>& storage, const EmbeddedTable& table, const char* name) {
+    if (table.size() != sizeof(T)) {
+        std::cerr << "Embedded table " << name << " has unexpected size " << table.size()
+                  << " (expected " << sizeof(T) << ")" << std::endl;
+        return false;
+    }
+    storage.bind(reinterpret_cast<const T*>(table.begin));
+    return true;
+}
+#endif
+
+} // namespace
+
+void TableManager::generate_core_tables(const std::string& dir) {
+    TableManager tables{Deferred{}};
+    create_directory(dir);
+    tables.generate_phase2_tables();
+    tables.save_phase2_tables(dir);
+}
+
+TableManager::RawTables TableManager::raw_tables() const {
+    using namespace StaticTables;
+    auto combined = [](const CompactPruningTable& table, bool enabled) {
+        return enabled && table.is_bound() ? table.data() : nullptr;
+    };
+    return {
+        CO_MOVE_TABLE[0].data(), EO_MOVE_TABLE[0].data(), UDS_MOVE_TABLE[0].data(),
+        (*cp_move_table)[0].data(), (*udep_move_table)[0].data(), SEP_MOVE_TABLE[0].data(),
+        CO_PRUNING_TABLE.data(), EO_PRUNING_TABLE.data(), UDS_PRUNING_TABLE.data(),
+        cp_pruning_table->data(), udep_pruning_table->data(), SEP_PRUNING_TABLE.data(),
+        combined(co_uds_pruning_table, has_combined_pruning<1>()),
+        combined(eo_uds_pruning_table, has_combined_pruning<1>()),
+        combined(cp_sep_pruning_table, has_combined_pruning<2>()),
+        combined(udep_sep_pruning_table, has_combined_pruning<2>()),
+        tiers_.packed,
+    };
+}
+
 void TableManager::initialize() {
     std::cout << "Initializing tables..." << std::endl;
-    std::cout << "Loading or generating move tables..." << std::endl;
-    if (load_array_binary(co_move_table, "data/co_move_table.bin") &&
-        load_array_binary(eo_move_table, "data/eo_move_table.bin") &&
-        load_array_binary(uds_move_table, "data/uds_move_table.bin") &&
-        load_array_binary(cp_move_table, "data/cp_move_table.bin") &&
-        load_array_binary(udep_move_table, "data/udep_move_table.bin") &&
-        load_array_binary(sep_move_table, "data/sep_move_table.bin")) {
-        std::cout << "All move tables loaded successfully." << std::endl;
-    } else {
-        create_directory("data");
-        std::cout << "Generating move tables..." << std::endl;
-        generate_co_move_table();
-        generate_eo_move_table();
-        generate_uds_move_table();
-        generate_cp_move_table();
-        generate_udep_move_table();
-        generate_sep_move_table();
-        
-        std::cout << "Saving move tables..." << std::endl;
-        
-        save_array_binary(co_move_table, "data/co_move_table.bin");
-        save_array_binary(eo_move_table, "data/eo_move_table.bin");
-        save_array_binary(uds_move_table, "data/uds_move_table.bin");
-        save_array_binary(cp_move_table, "data/cp_move_table.bin");
-        save_array_binary(udep_move_table, "data/udep_move_table.bin");
-        save_array_binary(sep_move_table, "data/sep_move_table.bin");
-        std::cout << "Move tables generated and saved." << std::endl;
-    }
-
-    std::cout << "Loading or generating pruning tables..." << std::endl;
-    if (load_array_binary(co_pruning_table, "data/co_pruning_table.bin") &&
-        load_array_binary(eo_pruning_table, "data/eo_pruning_table.bin") &&
-        load_array_binary(uds_pruning_table, "data/uds_pruning_table.bin") &&
-        load_array_binary(cp_pruning_table, "data/cp_pruning_table.bin") &&
-        load_array_binary(udep_pruning_table, "data/udep_pruning_table.bin") &&
-        load_array_binary(sep_pruning_table, "data/sep_pruning_table.bin")) {
-        std::cout << "All pruning tables loaded successfully." << std::endl;
+    std::cout << "Table tiers: " << tiers_.describe() << " (" << tiers_.total_bytes() << " bytes)" << std::endl;
+    std::cout << "Search limits: " << SearchLimits::tuned().describe();
+    if (!SearchLimits::tuned_source().empty()) {
+        std::cout << " (from " << SearchLimits::tuned_source() << ")";
+    }
+    std::cout << std::endl;
+    residency_config_ = ResidencyConfig::from_environment();
+    // 第一阶段的表在编译期生成，无需加载
+    footprint_.push_back({"phase1_tables",
+        sizeof(StaticTables::CO_MOVE_TABLE) + sizeof(StaticTables::EO_MOVE_TABLE) + sizeof(StaticTables::UDS_MOVE_TABLE)
+        + sizeof(StaticTables::CO_PRUNING_TABLE) + sizeof(StaticTables::EO_PRUNING_TABLE)
+        + sizeof(StaticTables::UDS_PRUNING_TABLE) + sizeof(StaticTables::SEP_MOVE_TABLE)
+        + sizeof(StaticTables::SEP_PRUNING_TABLE) + sizeof(StaticTables::CORNER_POSITIONS_MOVE_TABLE)
+        + sizeof(StaticTables::EDGE_POSITIONS_MOVE_TABLE),
+        Residency::Embedded});
+    mark_ready(TableGroup::Phase1);
+
+    bool embedded = !external_tables_requested() && bind_embedded_tables();
+    if (embedded) {
+        std::cout << "Phase 2 move and pruning tables bound from embedded data." << std::endl;
+        place_phase2_tables(Residency::Embedded);
+        mark_ready(TableGroup::Phase2);
+    }
+
+    // 第二阶段的表和终局数据库在后台加载，求解在所需的表就绪后即可开始
+    std::cout << "Phase 1 tables ready, loading remaining tables in background..." << std::endl;
+    loader_ = std::thread([this, embedded] { load_in_background(!embedded); });
+}
+
+void TableManager::load_in_background(bool load_phase2_tables) {
+    try {
+        if (load_phase2_tables) {
+            load_or_generate_phase2_tables("data");
+            place_phase2_tables(Residency::Heap);
+            mark_ready(TableGroup::Phase2);
+        }
+        generate_combined_pruning_tables();
+        mark_ready(TableGroup::Combined);
+        load_or_generate_endgame_db<1>("data");
+        mark_ready(TableGroup::Phase1Endgame);
+        load_or_generate_endgame_db<2>("data");
+        mark_ready(TableGroup::Phase2Endgame);
+        std::cout << "All tables initialized." << std::endl;
+        print_footprint(std::cout);
+    } catch (...) {
+        std::cerr << "Background table loading failed." << std::endl;
+        auto error = std::current_exception();
+        for (size_t i = 0; i < TABLE_GROUP_COUNT; ++i) {
+            if (!ready_flags_[i].load(std::memory_order_acquire)) {
+                ready_promises_[i].set_exception(error);
+            }
+        }
+    }
+}
+
+void TableManager::mark_ready(TableGroup group) {
+    auto index = static_cast<size_t>(group);
+    ready_flags_[index].store(true, std::memory_order_release);
+    ready_promises_[index].set_value();
+}
+
+void TableManager::wait_until_ready(TableGroup group) const {
+    if (!is_ready(group)) {
+        ready_futures_[static_cast<size_t>(group)].get();
+    }
+}
+
+void TableManager::wait_until_all_ready() const {
+    for (size_t i = 0; i < TABLE_GROUP_COUNT; ++i) {
+        wait_until_ready(static_cast<TableGroup>(i));
+    }
+}
+
+bool TableManager::bind_embedded_tables() {
+#ifdef RUBIKS_EMBEDDED_TABLES
+#define RUBIKS_BIND_EMBEDDED(name) bind_embedded(name, RUBIKS_EMBEDDED_TABLE(name), #name)
+    return RUBIKS_BIND_EMBEDDED(cp_move_table) &&
+           RUBIKS_BIND_EMBEDDED(udep_move_table) &&
+           RUBIKS_BIND_EMBEDDED(cp_pruning_table) &&
+           RUBIKS_BIND_EMBEDDED(udep_pruning_table);
+#undef RUBIKS_BIND_EMBEDDED
+#else
+    return false;
+#endif
+}
+
+void TableManager::load_or_generate_phase2_tables(const std::string& dir) {
+    std::cout << "Loading or generating phase 2 tables..." << std::endl;
+    if (load_array_binary(cp_move_table.allocate(), dir + "/cp_move_table.bin") &&
+        load_array_binary(udep_move_table.allocate(), dir + "/udep_move_table.bin") &&
+        load_array_binary(cp_pruning_table.allocate(), dir + "/cp_pruning_table.bin") &&
+        load_array_binary(udep_pruning_table.allocate(), dir + "/udep_pruning_table.bin")) {
+        std::cout << "Phase 2 tables loaded successfully." << std::endl;
     } else {
-        std::cout << "Generating pruning tables..." << std::endl;
-        generate_pruning_table<Phase1Coord>("Corner Orientation Pruning", co_pruning_table,
-            [&](uint16_t coord, Move m) { return get_co_move(coord, m); });
-        generate_pruning_table<Phase1Coord>("Edge Orientation Pruning", eo_pruning_table,
-            [&](uint16_t coord, Move m) { return get_eo_move(coord, m); });
-        generate_pruning_table<Phase1Coord>("UDSlice Edge Position Pruning", uds_pruning_table,
-            [&](uint16_t coord, Move m) { return get_uds_move(coord, m); });
-        generate_pruning_table<Phase2Coord>("Corner Permutation Pruning", cp_pruning_table,
-            [&](uint16_t coord, Move m) { return get_cp_move(coord, m); });
-        generate_pruning_table<Phase2Coord>("UD Edge Permutation Pruning", udep_pruning_table,
-            [&](uint16_t coord, Move m) { return get_udep_move(coord, m); });
-        generate_pruning_table<Phase2Coord>("Slice Edge Permutation Pruning", sep_pruning_table,
-            [&](uint16_t coord, Move m) { return get_sep_move(coord, m); });
-
-        std::cout << "Saving pruning tables..." << std::endl;
-
-        save_array_binary(co_pruning_table, "data/co_pruning_table.bin");
-        save_array_binary(eo_pruning_table, "data/eo_pruning_table.bin");
-        save_array_binary(uds_pruning_table, "data/uds_pruning_table.bin");
-        save_array_binary(cp_pruning_table, "data/cp_pruning_table.bin");
-        save_array_binary(udep_pruning_table, "data/udep_pruning_table.bin");
-        save_array_binary(sep_pruning_table, "data/sep_pruning_table.bin");
-        std::cout << "Pruning tables generated and saved." << std::endl;
-    }
-    
-    std::cout << "Loading or generating endgame databases..." << std::endl;
-    if (load_map_binary(p1_endgame_db, "data/p1_endgame_db.bin") &&
-        load_map_binary(p2_endgame_db, "data/p2_endgame_db.bin")) {
-        std::cout << "Endgame databases loaded successfully." << std::endl;
+        create_directory(dir);
+        generate_phase2_tables();
+        save_phase2_tables(dir);
+        std::cout << "Phase 2 tables generated and saved." << std::endl;
+    }
+}
+
+void TableManager::place_phase2_tables(Residency source) {
+    constexpr size_t MOVE_BYTES = sizeof(MoveTable<40320>);
+    constexpr size_t PRUNING_BYTES = sizeof(PruningTable<40320>);
+    constexpr size_t TOTAL_BYTES = 2 * MOVE_BYTES + 2 * PRUNING_BYTES;
+
+    const std::string shared = shared_name("phase2_tables");
+    ResidentRegion region;
+    if (!shared.empty()) {
+        // 等待超时 (Unusable) 时直接使用私有内存，不再创建或附加
+        auto status = ResidentRegion::AttachStatus::Missing;
+        region = ResidentRegion::attach_shared(shared, status);
+        if (status == ResidentRegion::AttachStatus::Missing) {
+            region = ResidentRegion::create_shared(shared, TOTAL_BYTES, residency_config_.huge_pages);
+            if (!region) {
+                region = ResidentRegion::attach_shared(shared, status); // 另一个进程抢先创建
+            }
+        }
+        if (region && region.size() != TOTAL_BYTES) {
+            std::cerr << "Shared memory " << shared << " has unexpected size, using private tables." << std::endl;
+            region = ResidentRegion();
+        }
+    }
+    if (!region && residency_config_.huge_pages) {
+        region = ResidentRegion::allocate(TOTAL_BYTES, true);
+    }
+
+    if (region) {
+        // 四张表依次存放，大小都是缓存行的整数倍
+        auto* base = static_cast<char*>(region.data());
+        if (region.residency() != Residency::SharedAttached) {
+            std::memcpy(base, cp_move_table->data(), MOVE_BYTES);
+            std::memcpy(base + MOVE_BYTES, udep_move_table->data(), MOVE_BYTES);
+            std::memcpy(base + 2 * MOVE_BYTES, cp_pruning_table->data(), PRUNING_BYTES);
+            std::memcpy(base + 2 * MOVE_BYTES + PRUNING_BYTES, udep_pruning_table->data(), PRUNING_BYTES);
+            region.publish();
+        }
+        cp_move_table.bind(reinterpret_cast<const MoveTable<40320>*>(base));
+        udep_move_table.bind(reinterpret_cast<const MoveTable<40320>*>(base + MOVE_BYTES));
+        cp_pruning_table.bind(reinterpret_cast<const PruningTable<40320>*>(base + 2 * MOVE_BYTES));
+        udep_pruning_table.bind(reinterpret_cast<const PruningTable<40320>*>(base + 2 * MOVE_BYTES + PRUNING_BYTES));
+        source = region.residency();
+        phase2_region_ = std::move(region);
+    }
+    footprint_.push_back({"cp_move_table", MOVE_BYTES, source});
+    footprint_.push_back({"udep_move_table", MOVE_BYTES, source});
+    footprint_.push_back({"cp_pruning_table", PRUNING_BYTES, source});
+    footprint_.push_back({"udep_pruning_table", PRUNING_BYTES, source});
+}
+
+std::string TableManager::shared_name(const std::string& table) const {
+    return residency_config_.shm_name.empty() ? std::string() : residency_config_.shm_name + "-" + table;
+}
+
+template<uint8_t PHASE>
+void TableManager::load_or_generate_endgame_db(const std::string& dir) {
+    const std::string name = "p" + std::to_string(PHASE) + "_endgame_db";
+    const std::string path = dir + "/" + name + ".bin";
+    const int depth = endgame_db_depth<PHASE>();
+    const std::string shared = shared_name(name + "_d" + std::to_string(depth));
+
+    ResidentRegion region;
+    auto status = ResidentRegion::AttachStatus::Missing;
+    if (!shared.empty()) {
+        region = ResidentRegion::attach_shared(shared, status);
+    }
+    if (region) {
+        std::cout << "Phase " << int(PHASE) << " endgame database attached from shared memory." << std::endl;
     } else {
-        std::cout << "Generating endgame databases..." << std::endl;
-        generate_endgame_db<1, Phase1Coord>();
-        generate_endgame_db<2, Phase2Coord>();
-        
-        std::cout << "Saving endgame databases..." << std::endl;
-        save_map_binary(p1_endgame_db, "data/p1_endgame_db.bin");
-        save_map_binary(p2_endgame_db, "data/p2_endgame_db.bin");
-        std::cout << "Endgame databases generated and saved." << std::endl;
+        // 先加载或生成到哈希表中，再转成扁平存储
+        EndgameDB endgame_db;
+        std::cout << "Loading or generating phase " << int(PHASE) << " endgame database..." << std::endl;
+        if (load_map_binary(endgame_db, path, static_cast<uint64_t>(depth))) {
+            std::cout << "Endgame database loaded successfully." << std::endl;
+        } else {
+            endgame_db.clear();
+            create_directory(dir);
+            if constexpr (PHASE == 1) {
+                generate_endgame_db<1, Phase1Coord>(endgame_db);
+            } else {
+                generate_endgame_db<2, Phase2Coord>(endgame_db);
+            }
+            save_map_binary(endgame_db, path);
+            std::cout << "Endgame database generated and saved." << std::endl;
+        }
+        // 文件中总是完整深度的数据库，按档位只保留较短的路径 (BFS 路径最短，截断后仍然完整)；
+        // 加载时已经跳过，这里处理刚生成的情况
+        std::erase_if(endgame_db, [depth](const auto& entry) { return static_cast<int>(entry.second.size()) > depth; });
+
+        size_t bytes = EndgameTable::bytes_for(endgame_db.size());
+        // 等待超时 (Unusable) 时直接使用私有内存，不再创建或附加
+        if (!shared.empty() && status == ResidentRegion::AttachStatus::Missing) {
+            region = ResidentRegion::create_shared(shared, bytes, residency_config_.huge_pages);
+            if (!region) {
+                region = ResidentRegion::attach_shared(shared, status); // 另一个进程抢先创建
+            }
+        }
+        if (!region) {
+            region = ResidentRegion::allocate(bytes, residency_config_.huge_pages);
+        }
+        if (region.residency() != Residency::SharedAttached) {
+            EndgameTable::build(endgame_db, region.data());
+            region.publish();
+        }
     }
-    std::cout << "All tables initialized." << std::endl;
-    std::cout << "Initialization complete." << std::endl;
-    
+
+    auto& endgame_db = get_endgame_db<PHASE>();
+    endgame_db.bind(region.data());
+    footprint_.push_back({name, endgame_db.bytes(), region.residency()});
+    endgame_regions_[PHASE - 1] = std::move(region);
 }
 
-void TableManager::generate_co_move_table() {
-    generate_move_table<Phase1Coord>("Corner Orientation", co_move_table,
-        [&](Phase1Coord& coord, uint16_t i) { coord.set_corner_orientation(i); },
-        [&](Phase1Coord& coord) -> uint16_t { return coord.get_corner_orientation(); });
+const std::vector<TableFootprint>& TableManager::footprint() const {
+    wait_until_all_ready();
+    return footprint_;
 }
 
-void TableManager::generate_eo_move_table() {
-    generate_move_table<Phase1Coord>("Edge Orientation", eo_move_table,
-        [&](Phase1Coord& coord, uint16_t i) { coord.set_edge_orientation(i); },
-        [&](Phase1Coord& coord) -> uint16_t { return coord.get_edge_orientation(); });
+void TableManager::print_footprint(std::ostream& out) const {
+    wait_until_all_ready();
+    size_t total = 0;
+    out << "Table footprint (" << tiers_.describe() << "):" << std::endl;
+    for (const auto& table : footprint_) {
+        out << "  " << std::left << std::setw(22) << table.name << std::right
+            << std::setw(10) << table.bytes << " bytes  " << residency_name(table.residency) << std::endl;
+        total += table.bytes;
+    }
+    out << "  " << std::left << std::setw(22) << "total" << std::right
+        << std::setw(10) << total << " bytes" << std::endl;
 }
 
-void TableManager::generate_uds_move_table() {
-    generate_move_table<Phase1Coord>("UDSlice Edge Position", uds_move_table,
-        [&](Phase1Coord& coord, uint16_t i) { coord.set_ud_slice_edges(i); },
-        [&](Phase1Coord& coord) -> uint16_t { return coord.get_ud_slice_position(); });
+namespace {
+
+// 两个坐标乘积空间上的 BFS，索引为 a * size_b + b，目标状态的两个坐标都是0
+template<typename C, typename NextA, typename NextB>
+std::vector<uint8_t> generate_combined_pruning(const std::string& name, size_t size_a, size_t size_b,
+                                               NextA&& next_a, NextB&& next_b) {
+    std::cout << "Generating Pruning Table: " << name << "..." << std::endl;
+    std::vector<uint8_t> table(size_a * size_b, 0xFF);
+    std::vector<uint32_t> frontier{0};
+    std::vector<uint32_t> next;
+    table[0] = 0;
+    uint8_t depth = 0;
+    while (!frontier.empty()) {
+        next.clear();
+        for (uint32_t index : frontier) {
+            auto a = static_cast<uint16_t>(index / size_b);
+            auto b = static_cast<uint16_t>(index % size_b);
+            for (auto move : C::AVAILABLE_MOVES) {
+                auto n = static_cast<uint32_t>(next_a(a, move) * size_b + next_b(b, move));
+                if (table[n] == 0xFF) {
+                    table[n] = depth + 1;
+                    next.push_back(n);
+                }
+            }
+        }
+        frontier.swap(next);
+        ++depth;
+    }
+    std::cout << name << " generated. Max depth: " << int(depth - 1) << "." << std::endl;
+    return table;
 }
 
-void TableManager::generate_cp_move_table() {
-    generate_move_table<Phase2Coord>("Corner Permutation", cp_move_table,
-        [&](Phase2Coord& coord, uint16_t i) { coord.set_corner_permutation(i); },
-        [&](Phase2Coord& coord) -> uint16_t { return coord.get_corner_permutation(); });
+} // namespace
+
+void TableManager::generate_combined_pruning_tables() {
+    const bool huge = residency_config_.huge_pages;
+    if (tiers_.phase1_combined) {
+        co_uds_pruning_table.assign(generate_combined_pruning<Phase1Coord>("CO x UD-Slice", 2187, 495,
+            [](uint16_t c, Move m) { return StaticTables::CO_MOVE_TABLE[c][static_cast<uint8_t>(m)]; },
+            [](uint16_t c, Move m) { return StaticTables::UDS_MOVE_TABLE[c][static_cast<uint8_t>(m)]; }),
+            tiers_.packed, huge);
+        eo_uds_pruning_table.assign(generate_combined_pruning<Phase1Coord>("EO x UD-Slice", 2048, 495,
+            [](uint16_t c, Move m) { return StaticTables::EO_MOVE_TABLE[c][static_cast<uint8_t>(m)]; },
+            [](uint16_t c, Move m) { return StaticTables::UDS_MOVE_TABLE[c][static_cast<uint8_t>(m)]; }),
+            tiers_.packed, huge);
+        footprint_.push_back({"co_uds_pruning_table", co_uds_pruning_table.bytes(), co_uds_pruning_table.residency()});
+        footprint_.push_back({"eo_uds_pruning_table", eo_uds_pruning_table.bytes(), eo_uds_pruning_table.residency()});
+    }
+    if (tiers_.phase2_combined) {
+        auto sep_move = [](uint16_t c, Move m) { return StaticTables::SEP_MOVE_TABLE[c][static_cast<uint8_t>(m)]; };
+        cp_sep_pruning_table.assign(generate_combined_pruning<Phase2Coord>("CP x Slice Permutation", 40320, 24,
+            [this](uint16_t c, Move m) { return get_cp_move(c, m); }, sep_move), tiers_.packed, huge);
+        udep_sep_pruning_table.assign(generate_combined_pruning<Phase2Coord>("UDEP x Slice Permutation", 40320, 24,
+            [this](uint16_t c, Move m) { return get_udep_move(c, m); }, sep_move), tiers_.packed, huge);
+        footprint_.push_back({"cp_sep_pruning_table", cp_sep_pruning_table.bytes(), cp_sep_pruning_table.residency()});
+        footprint_.push_back({"udep_sep_pruning_table", udep_sep_pruning_table.bytes(), udep_sep_pruning_table.residency()});
+    }
 }
 
-void TableManager::generate_udep_move_table() {
-    generate_move_table<Phase2Coord>("UD Edge Permutation", udep_move_table,
-        [&](Phase2Coord& coord, uint16_t i) { coord.set_ud_edge_permutation(i); },
-        [&](Phase2Coord& coord) -> uint16_t { return coord.get_ud_edge_permutation(); });
+void TableManager::generate_phase2_tables() {
+    std::cout << "Generating phase 2 tables..." << std::endl;
+    generate_cp_move_table();
+    generate_udep_move_table();
+    generate_pruning_table<Phase2Coord>("Corner Permutation Pruning", cp_pruning_table.allocate(),
+        [&](uint16_t coord, Move m) { return get_cp_move(coord, m); });
+    generate_pruning_table<Phase2Coord>("UD Edge Permutation Pruning", udep_pruning_table.allocate(),
+        [&](uint16_t coord, Move m) { return get_udep_move(coord, m); });
 }
 
-void TableManager::generate_sep_move_table() {
-    generate_move_table<Phase2Coord>("Slice Edge Permutation", sep_move_table,
-        [&](Phase2Coord& coord, uint16_t i) { coord.set_slice_edge_permutation(i); },
-        [&](Phase2Coord& coord) -> uint16_t { return coord.get_slice_edge_permutation(); });
+void TableManager::save_phase2_tables(const std::string& dir) const {
+    std::cout << "Saving phase 2 tables..." << std::endl;
+    save_array_binary(*cp_move_table, dir + "/cp_move_table.bin");
+    save_array_binary(*udep_move_table, dir + "/udep_move_table.bin");
+    save_array_binary(*cp_pruning_table, dir + "/cp_pruning_table.bin");
+    save_array_binary(*udep_pruning_table, dir + "/udep_pruning_table.bin");
 }
 
+void TableManager::generate_cp_move_table() {
+    generate_move_table<Phase2Coord>("Corner Permutation", cp_move_table.allocate(),
+        corner_permutation_move);
+}
 
+void TableManager::generate_udep_move_table() {
+    generate_move_table<Phase2Coord>("UD Edge Permutation", udep_move_table.allocate(),
+        ud_edge_permutation_move);
+}
 
 uint8_t TableManager::get_phase1_pruning(const Phase1Coord& coord) const {
     return std::max({
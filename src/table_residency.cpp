@@ -0,0 +1,282 @@
+#include "table_residency.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace RubiksSolver {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+constexpr size_t SHARED_HEADER_SIZE = 4096; // 数据从页边界开始
+
+constexpr uint64_t SHARED_MAGIC = 0x5242'4B54'4142'4C45; // "RBKTABLE"
+constexpr uint32_t SHARED_VERSION = 1;
+
+// 新建的段全为0，创建者写完头和数据后才把 state 置为 SHARED_READY
+constexpr uint32_t SHARED_READY = 1;
+
+struct SharedHeader {
+    uint64_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> state;
+    uint64_t bytes;
+};
+static_assert(sizeof(SharedHeader) <= SHARED_HEADER_SIZE);
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared header needs a lock-free atomic");
+
+// 创建者仍在加载或生成表时附加方的最长等待时间
+constexpr auto ATTACH_TIMEOUT = std::chrono::seconds(120);
+// 连续这么多次检查都没有进程持有锁、段也未发布时，认为创建者已退出
+// (创建者在 shm_open 之后立即加锁，两次检查间隔 10 ms，不会误判刚创建的段)
+constexpr int STALE_CHECKS = 2;
+
+// 是否有进程 (创建者) 持有段的排他锁
+bool creator_holds_lock(int fd) {
+    if (::flock(fd, LOCK_SH | LOCK_NB) == 0) {
+        ::flock(fd, LOCK_UN);
+        return false;
+    }
+    return errno == EWOULDBLOCK;
+}
+
+inline size_t round_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string shm_path(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+} // namespace
+
+const char* residency_name(Residency residency) {
+    switch (residency) {
+        case Residency::Embedded: return "embedded";
+        case Residency::Heap: return "heap (4 KB pages)";
+        case Residency::HugePages: return "huge pages (MAP_HUGETLB)";
+        case Residency::TransparentHuge: return "transparent huge pages";
+        case Residency::SharedCreated: return "shared memory (published)";
+        case Residency::SharedAttached: return "shared memory (attached)";
+    }
+    return "unknown";
+}
+
+ResidencyConfig ResidencyConfig::from_environment() {
+    ResidencyConfig config;
+    const char* huge = std::getenv("RUBIKS_HUGE_PAGES");
+    config.huge_pages = huge != nullptr && std::string_view(huge) != "0";
+    if (const char* name = std::getenv("RUBIKS_SHM_NAME")) {
+        config.shm_name = name;
+    }
+    return config;
+}
+
+ResidentRegion::~ResidentRegion() {
+    release();
+}
+
+ResidentRegion::ResidentRegion(ResidentRegion&& other) noexcept {
+    *this = std::move(other);
+}
+
+ResidentRegion& ResidentRegion::operator=(ResidentRegion&& other) noexcept {
+    if (this != &other) {
+        release();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        residency_ = other.residency_;
+        unlink_name_ = std::move(other.unlink_name_);
+        other.unlink_name_.clear();
+        lock_fd_ = std::exchange(other.lock_fd_, -1);
+    }
+    return *this;
+}
+
+void ResidentRegion::release() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    if (!unlink_name_.empty()) {
+        ::shm_unlink(unlink_name_.c_str());
+    }
+    if (lock_fd_ >= 0) {
+        ::close(lock_fd_);
+    }
+    lock_fd_ = -1;
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+    unlink_name_.clear();
+}
+
+ResidentRegion ResidentRegion::allocate(size_t bytes, bool huge_pages) {
+    ResidentRegion region;
+    region.size_ = bytes;
+    if (huge_pages) {
+        // 预留的大页 (vm.nr_hugepages) 不足时 MAP_HUGETLB 失败，退回透明大页
+        size_t rounded = round_up(bytes, HUGE_PAGE_SIZE);
+        void* p = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            region.mapping_ = region.data_ = p;
+            region.mapping_size_ = rounded;
+            region.residency_ = Residency::HugePages;
+            return region;
+        }
+        // 多映射一个大页再裁掉首尾，使起始地址按 2 MB 对齐，内核才能用大页填充
+        p = ::mmap(nullptr, rounded + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        auto base = reinterpret_cast<uintptr_t>(p);
+        uintptr_t aligned = round_up(base, HUGE_PAGE_SIZE);
+        if (aligned > base) ::munmap(p, aligned - base);
+        size_t tail = base + rounded + HUGE_PAGE_SIZE - (aligned + rounded);
+        if (tail > 0) ::munmap(reinterpret_cast<void*>(aligned + rounded), tail);
+        region.mapping_ = region.data_ = reinterpret_cast<void*>(aligned);
+        region.mapping_size_ = rounded;
+        region.residency_ = ::madvise(region.mapping_, rounded, MADV_HUGEPAGE) == 0
+                          ? Residency::TransparentHuge : Residency::Heap;
+        return region;
+    }
+    size_t rounded = round_up(std::max<size_t>(bytes, 1), static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+    void* p = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    region.mapping_ = region.data_ = p;
+    region.mapping_size_ = rounded;
+    region.residency_ = Residency::Heap;
+    return region;
+}
+
+ResidentRegion ResidentRegion::create_shared(const std::string& name, size_t bytes, bool huge_pages) {
+    const std::string path = shm_path(name);
+    int fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        if (errno == EEXIST) return {};
+        throw std::runtime_error("Cannot create shared memory " + path + ": " + std::strerror(errno));
+    }
+    ResidentRegion region;
+    region.unlink_name_ = path; // 从这里开始，发布前失败都会删除该段
+    region.lock_fd_ = fd;       // 持有到发布为止
+    ::flock(fd, LOCK_EX);
+    size_t total = SHARED_HEADER_SIZE + bytes;
+    if (::ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        throw std::runtime_error("Cannot size shared memory " + path + ": " + std::strerror(errno));
+    }
+    void* p = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error("Cannot map shared memory " + path + ": " + std::strerror(errno));
+    }
+    region.mapping_ = p;
+    region.mapping_size_ = total;
+    region.data_ = static_cast<char*>(p) + SHARED_HEADER_SIZE;
+    region.size_ = bytes;
+    region.residency_ = Residency::SharedCreated;
+    if (huge_pages) {
+        // 只有 shmem_enabled 为 advise/always 时 tmpfs 才会使用大页，失败不影响正确性
+        ::madvise(p, total, MADV_HUGEPAGE);
+    }
+
+    auto* header = new (p) SharedHeader{};
+    header->magic = SHARED_MAGIC;
+    header->version = SHARED_VERSION;
+    header->bytes = bytes;
+    return region;
+}
+
+ResidentRegion ResidentRegion::attach_shared(const std::string& name, AttachStatus& status) {
+    const std::string path = shm_path(name);
+    status = AttachStatus::Missing;
+    int fd = ::shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) return {};
+
+    // 等待创建者设置大小并发布；超时返回 Unusable，创建者已退出时删除残留的段并返回 Missing
+    auto deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+    int unlocked_checks = 0;
+    auto wait = [&](bool published) {
+        if (published || creator_holds_lock(fd)) {
+            unlocked_checks = 0;
+        } else if (++unlocked_checks >= STALE_CHECKS) {
+            // 只删除仍是这个段的名字 (其他附加方可能已经删除并由新的创建者重建)
+            struct stat ours, current;
+            if (::fstat(fd, &ours) == 0 && ::stat(("/dev/shm" + path).c_str(), &current) == 0
+                && ours.st_ino == current.st_ino) {
+                ::shm_unlink(path.c_str());
+            }
+            return false;
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+            status = AttachStatus::Unusable;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return true;
+    };
+
+    // 创建者可能还没有设置段的大小
+    struct stat st;
+    while (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) < SHARED_HEADER_SIZE) {
+        if (!wait(false)) {
+            ::close(fd);
+            return {};
+        }
+    }
+    size_t total = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, total, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        ::close(fd);
+        status = AttachStatus::Unusable;
+        return {};
+    }
+
+    ResidentRegion region;
+    region.mapping_ = p;
+    region.mapping_size_ = total;
+    const auto* header = static_cast<const SharedHeader*>(p);
+    // 创建者先发布再释放锁，所以发现锁已释放时要再读一次状态
+    while (header->state.load(std::memory_order_acquire) != SHARED_READY) {
+        if (!wait(header->state.load(std::memory_order_acquire) == SHARED_READY)) {
+            ::close(fd);
+            return {};
+        }
+    }
+    ::close(fd);
+    status = AttachStatus::Unusable;
+    if (header->magic != SHARED_MAGIC || header->version != SHARED_VERSION
+        || header->bytes + SHARED_HEADER_SIZE != total) {
+        return {};
+    }
+    region.data_ = static_cast<char*>(p) + SHARED_HEADER_SIZE;
+    region.size_ = header->bytes;
+    region.residency_ = Residency::SharedAttached;
+    status = AttachStatus::Attached;
+    return region;
+}
+
+void ResidentRegion::publish() {
+    if (residency_ == Residency::SharedCreated) {
+        static_cast<SharedHeader*>(mapping_)->state.store(SHARED_READY, std::memory_order_release);
+        unlink_name_.clear();
+        ::close(lock_fd_); // 释放锁
+        lock_fd_ = -1;
+    }
+    // 表只读：之后的意外写入会立即出错
+    ::mprotect(mapping_, mapping_size_, PROT_READ);
+}
+
+} // namespace RubiksSolver
@@ -0,0 +1,132 @@
+#include "table_tiers.h"
+#include "endgame_table.h"
+#include "static_tables.h"
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace RubiksSolver {
+
+namespace {
+
+// 终局数据库中路径长度不超过 d 的状态数 (由 BFS 确定，与生成方式无关)
+constexpr std::array<size_t, TableTiers::MAX_P1_ENDGAME_DEPTH + 1> P1_ENDGAME_STATES = {
+    1, 5, 55, 647, 7803, 95039, 1138856};
+constexpr std::array<size_t, TableTiers::MAX_P2_ENDGAME_DEPTH + 1> P2_ENDGAME_STATES = {
+    1, 11, 78, 534, 3613, 23561, 146635, 883485};
+
+inline size_t combined_bytes(size_t entries, bool packed) {
+    return packed ? (entries + 1) / 2 : entries;
+}
+
+} // namespace
+
+size_t TableTiers::required_bytes() {
+    using namespace StaticTables;
+    return sizeof(CO_MOVE_TABLE) + sizeof(EO_MOVE_TABLE) + sizeof(UDS_MOVE_TABLE)
+         + sizeof(CO_PRUNING_TABLE) + sizeof(EO_PRUNING_TABLE) + sizeof(UDS_PRUNING_TABLE)
+         + sizeof(SEP_MOVE_TABLE) + sizeof(SEP_PRUNING_TABLE)
+         + sizeof(CORNER_POSITIONS_MOVE_TABLE) + sizeof(EDGE_POSITIONS_MOVE_TABLE)
+         + 2 * sizeof(MoveTable<40320>) + 2 * sizeof(PruningTable<40320>);
+}
+
+size_t TableTiers::endgame_bytes(int phase, int depth) {
+    size_t states = phase == 1 ? P1_ENDGAME_STATES.at(depth) : P2_ENDGAME_STATES.at(depth);
+    return EndgameTable::bytes_for(states);
+}
+
+size_t TableTiers::phase1_combined_bytes() const {
+    return phase1_combined ? combined_bytes(CO_UDS_ENTRIES, packed) + combined_bytes(EO_UDS_ENTRIES, packed) : 0;
+}
+
+size_t TableTiers::phase2_combined_bytes() const {
+    return phase2_combined ? combined_bytes(CP_SEP_ENTRIES, packed) + combined_bytes(UDEP_SEP_ENTRIES, packed) : 0;
+}
+
+size_t TableTiers::total_bytes() const {
+    return required_bytes() + endgame_bytes(1, p1_endgame_depth) + endgame_bytes(2, p2_endgame_depth)
+         + phase1_combined_bytes() + phase2_combined_bytes();
+}
+
+TableTiers TableTiers::for_budget(size_t budget) {
+    TableTiers tiers;
+    tiers.p1_endgame_depth = 0;
+    tiers.p2_endgame_depth = 0;
+    tiers.phase1_combined = false;
+    tiers.phase2_combined = false;
+    tiers.packed = true;
+    tiers.budget = budget;
+
+    // 按每字节带来的加速从高到低依次升级，放不下的一步跳过 (后面更小的升级仍然可能放得下)
+    std::vector<std::function<void(TableTiers&)>> upgrades;
+    for (int d = 1; d <= 4; ++d) {
+        upgrades.push_back([d](TableTiers& t) { t.p1_endgame_depth = d; });
+    }
+    for (int d = 1; d <= 5; ++d) {
+        upgrades.push_back([d](TableTiers& t) { t.p2_endgame_depth = d; });
+    }
+    upgrades.push_back([](TableTiers& t) { t.phase1_combined = true; });
+    upgrades.push_back([](TableTiers& t) { t.phase2_combined = true; });
+    upgrades.push_back([](TableTiers& t) { t.p1_endgame_depth = std::max(t.p1_endgame_depth, 5); });
+    upgrades.push_back([](TableTiers& t) { t.p2_endgame_depth = std::max(t.p2_endgame_depth, 6); });
+    upgrades.push_back([](TableTiers& t) { t.packed = false; });
+    upgrades.push_back([](TableTiers& t) { t.p1_endgame_depth = std::max(t.p1_endgame_depth, 6); });
+    upgrades.push_back([](TableTiers& t) { t.p2_endgame_depth = std::max(t.p2_endgame_depth, 7); });
+
+    for (const auto& upgrade : upgrades) {
+        TableTiers candidate = tiers;
+        upgrade(candidate);
+        if (candidate.total_bytes() <= budget) {
+            tiers = candidate;
+        }
+    }
+    return tiers;
+}
+
+TableTiers TableTiers::from_environment() {
+    const char* env = std::getenv("RUBIKS_TABLE_BUDGET");
+    if (env == nullptr || *env == '\0') {
+        return TableTiers{};
+    }
+    return for_budget(parse_size(env));
+}
+
+size_t TableTiers::parse_size(const std::string& text) {
+    size_t pos = 0;
+    unsigned long long value = 0;
+    try {
+        value = std::stoull(text, &pos);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("Invalid size: " + text);
+    }
+    std::string suffix = text.substr(pos);
+    if (!suffix.empty() && (suffix.back() == 'B' || suffix.back() == 'b')) suffix.pop_back();
+    if (suffix.empty()) return value;
+    if (suffix.size() == 1) {
+        switch (std::toupper(static_cast<unsigned char>(suffix[0]))) {
+            case 'K': return value << 10;
+            case 'M': return value << 20;
+            case 'G': return value << 30;
+        }
+    }
+    throw std::invalid_argument("Invalid size: " + text);
+}
+
+std::string TableTiers::describe() const {
+    std::string text = "p1 endgame depth " + std::to_string(p1_endgame_depth)
+                     + ", p2 endgame depth " + std::to_string(p2_endgame_depth);
+    if (phase1_combined || phase2_combined) {
+        text += ", combined pruning";
+        text += phase1_combined && phase2_combined ? " (phase 1+2" : phase1_combined ? " (phase 1" : " (phase 2";
+        text += packed ? ", 4-bit)" : ", 8-bit)";
+    } else {
+        text += ", no combined pruning";
+    }
+    text += budget > 0 ? ", budget " + std::to_string(budget >> 20) + " MiB" : ", no budget";
+    return text;
+}
+
+} // namespace RubiksSolver
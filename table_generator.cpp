@@ -0,0 +1,19 @@
+#include "table_manager.h"
+#include <iostream>
+
+// 构建时运行：生成移动表和剪枝表，供 CMake 内嵌到 rubiks_solver 和 benchmark 中
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <output_dir>" << std::endl;
+        return 1;
+    }
+
+    try {
+        RubiksSolver::TableManager::generate_core_tables(argv[1]);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
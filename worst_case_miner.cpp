@@ -0,0 +1,256 @@
+#include "cube.h"
+#include "table_manager.h"
+#include "solver.h"
+#include "random_state.h"
+#include "bench_common.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using RubiksSolver::Bench::Clock;
+using RubiksSolver::Bench::elapsed_ns;
+
+// 最坏情况挖掘：在状态空间中搜索让 Solver::solve 最慢 (展开节点最多) 的状态
+// 每次重启从一个均匀随机状态出发做爬山：随机施加 1~2 步转动 (转动集合包含所有逆转动，
+// 因此也覆盖了撤销之前的转动)，保留更难的一个。爬山过程中评估过的所有状态都参与排名，
+// 每个线程保留自己的前 N 个，最后合并写出全局最难的 N 个 (去除重复状态)，
+// 输出文件可以直接用 benchmark --scrambles 加载
+namespace {
+
+enum class Metric { Nodes, Time };
+
+struct Options {
+    size_t restarts = 64;
+    size_t steps = 200;
+    size_t top = 32;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = 1;
+    Metric metric = Metric::Nodes;
+    std::string output_path = "worst_cases.txt";
+};
+
+struct Evaluation {
+    bool failed = false;
+    uint64_t nodes = 0;
+    uint64_t ns = 0;
+    int length = 0;
+
+    // 求解失败的状态排在最前面
+    inline double score(Metric metric) const {
+        if (failed) return std::numeric_limits<double>::infinity();
+        return metric == Metric::Nodes ? static_cast<double>(nodes) : static_cast<double>(ns);
+    }
+};
+
+struct Candidate {
+    RubiksSolver::Cube cube;
+    Evaluation eval;
+    size_t restart = 0;
+    std::string facelets;
+};
+
+// 按难度保留前 capacity 个不同的状态
+// 难度相同时按重启编号和色块字符串排序，节点数度量下结果与线程数无关
+class TopStates {
+public:
+    TopStates(size_t capacity, Metric metric) : capacity_(capacity), metric_(metric) {}
+
+    void offer(const Candidate& c) {
+        if (seen_.count(c.facelets)) return;
+        if (heap_.size() >= capacity_) {
+            // 堆顶是当前保留的状态中最容易的一个
+            if (!ranks_before(c, heap_.front())) return;
+            std::pop_heap(heap_.begin(), heap_.end(), comparator());
+            seen_.erase(heap_.back().facelets);
+            heap_.pop_back();
+        }
+        seen_.insert(c.facelets);
+        heap_.push_back(c);
+        std::push_heap(heap_.begin(), heap_.end(), comparator());
+    }
+
+    void merge(const TopStates& other) {
+        for (const auto& c : other.heap_) offer(c);
+    }
+
+    // 从最难到最容易
+    std::vector<Candidate> sorted() const {
+        std::vector<Candidate> result = heap_;
+        std::sort(result.begin(), result.end(), comparator());
+        return result;
+    }
+
+private:
+    bool ranks_before(const Candidate& a, const Candidate& b) const {
+        double sa = a.eval.score(metric_), sb = b.eval.score(metric_);
+        if (sa != sb) return sa > sb;
+        if (a.restart != b.restart) return a.restart < b.restart;
+        return a.facelets < b.facelets;
+    }
+    // 堆和排序使用的比较器：更难的状态排在前面
+    struct RanksBefore {
+        const TopStates* self;
+        bool operator()(const Candidate& a, const Candidate& b) const { return self->ranks_before(a, b); }
+    };
+    inline RanksBefore comparator() const { return {this}; }
+
+    size_t capacity_;
+    Metric metric_;
+    std::vector<Candidate> heap_;
+    std::unordered_set<std::string> seen_;
+};
+
+Evaluation evaluate(RubiksSolver::Solver& solver, const RubiksSolver::Cube& cube) {
+    Evaluation eval;
+    auto start = Clock::now();
+    try {
+        eval.length = static_cast<int>(solver.solve(cube).size());
+    } catch (const std::exception&) {
+        eval.failed = true;
+    }
+    eval.ns = elapsed_ns(start, Clock::now());
+    const auto& stats = solver.last_stats();
+    eval.nodes = stats.phases[0].nodes() + stats.phases[1].nodes();
+    return eval;
+}
+
+// 每次重启使用独立的种子，节点数度量下结果与线程数无关
+// 评估过的每个状态都交给 top；返回本次重启中最难的状态
+Candidate climb(RubiksSolver::Solver& solver, const Options& options, size_t restart, TopStates& top) {
+    std::mt19937_64 rng(options.seed * 0x9E3779B97F4A7C15ULL + restart);
+    RubiksSolver::RandomStateGenerator generator(rng());
+
+    Candidate current{generator.next(), {}, restart, {}};
+    current.eval = evaluate(solver, current.cube);
+    current.facelets = current.cube.to_facelets();
+    top.offer(current);
+    Candidate best = current;
+
+    for (size_t step = 0; step < options.steps; ++step) {
+        RubiksSolver::Cube mutated = current.cube;
+        int count = 1 + static_cast<int>(rng() % 2);
+        for (int i = 0; i < count; ++i) {
+            mutated.apply_move(static_cast<RubiksSolver::Move>(rng() % 18));
+        }
+        Candidate candidate{mutated, evaluate(solver, mutated), restart, mutated.to_facelets()};
+        top.offer(candidate);
+        // 允许平移 (相等时也接受)，以便越过平台
+        if (candidate.eval.score(options.metric) >= current.eval.score(options.metric)) {
+            current = std::move(candidate);
+            if (current.eval.score(options.metric) > best.eval.score(options.metric)) {
+                best = current;
+            }
+        }
+    }
+    return best;
+}
+
+Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--restarts") options.restarts = std::max<size_t>(1, std::stoull(next()));
+        else if (arg == "--steps") options.steps = std::stoull(next());
+        else if (arg == "--top") options.top = std::max<size_t>(1, std::stoull(next()));
+        else if (arg == "--threads") options.threads = std::max(1, std::stoi(next()));
+        else if (arg == "--seed") options.seed = std::stoull(next());
+        else if (arg == "--output") options.output_path = next();
+        else if (arg == "--metric") {
+            std::string metric = next();
+            if (metric == "nodes") options.metric = Metric::Nodes;
+            else if (metric == "time") options.metric = Metric::Time;
+            else throw std::invalid_argument("Unknown metric: " + metric);
+        }
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: worst_case_miner [--restarts n] [--steps n] [--top n] [--threads n] [--seed s]\n"
+                      << "                        [--metric nodes|time] [--output file]\n";
+            std::exit(0);
+        }
+        else throw std::invalid_argument("Unknown option: " + arg);
+    }
+    return options;
+}
+
+void write_corpus(const Options& options, const std::vector<Candidate>& corpus) {
+    std::ofstream out(options.output_path);
+    if (!out) throw std::runtime_error("Cannot write " + options.output_path);
+    out << "# worst-case corpus: metric=" << (options.metric == Metric::Nodes ? "nodes" : "time")
+        << " seed=" << options.seed << " restarts=" << options.restarts << " steps=" << options.steps << "\n";
+    for (const auto& c : corpus) {
+        out << c.facelets << "  # nodes=" << c.eval.nodes
+            << " time_ms=" << std::fixed << std::setprecision(3) << RubiksSolver::Bench::ns_to_ms(c.eval.ns);
+        if (c.eval.failed) out << " failed";
+        else out << " length=" << c.eval.length;
+        out << " restart=" << c.restart << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parse_options(argc, argv);
+
+        std::cout << "Initializing tables..." << std::endl;
+        const auto& tables = RubiksSolver::TableManager::get_instance();
+        tables.wait_until_all_ready();
+        std::cout << "Tables initialized successfully." << std::endl;
+
+        TopStates top(options.top, options.metric);
+        std::atomic<size_t> next_restart{0};
+        std::atomic<size_t> finished{0};
+        std::mutex mutex; // 保护输出和 top 的合并
+        auto worker = [&]() {
+            RubiksSolver::Solver solver(tables, false);
+            TopStates local(options.top, options.metric);
+            for (size_t r = next_restart++; r < options.restarts; r = next_restart++) {
+                Candidate best = climb(solver, options, r, local);
+                std::lock_guard lock(mutex);
+                std::cout << "Restart " << ++finished << "/" << options.restarts << ": nodes=" << best.eval.nodes
+                          << " time=" << std::fixed << std::setprecision(3)
+                          << RubiksSolver::Bench::ns_to_ms(best.eval.ns) << " ms"
+                          << (best.eval.failed ? " (FAILED)" : "") << std::endl;
+            }
+            std::lock_guard lock(mutex);
+            top.merge(local);
+        };
+
+        auto start = Clock::now();
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < options.threads; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double seconds = elapsed_ns(start, Clock::now()) / 1e9;
+
+        std::vector<Candidate> corpus = top.sorted();
+        write_corpus(options, corpus);
+
+        size_t solves = options.restarts * (options.steps + 1);
+        std::cout << "\n--- WORST-CASE MINING ---" << std::endl;
+        std::cout << "Solves: " << solves << " in " << std::fixed << std::setprecision(1) << seconds << " s" << std::endl;
+        std::cout << "Hardest: nodes=" << corpus.front().eval.nodes << " time="
+                  << std::setprecision(3) << RubiksSolver::Bench::ns_to_ms(corpus.front().eval.ns) << " ms" << std::endl;
+        std::cout << corpus.size() << " states written to " << options.output_path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}